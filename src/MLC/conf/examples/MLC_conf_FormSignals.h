@@ -95,10 +95,17 @@ const uint8_t PCA9685_OE_PIN = D0;
 // Sensors:
 // - Connecting sensors to the MCP23017 is simple.
 // - Just connect one of of the cable pair to GND, the other one to one of the ports of the MCP23017.
+// Interrupts:
+// - Optionally, connect the INTA ports of all MCP23017s to a free pin of the ESP8266 and set MCP23017_INT_PIN_INSTALLED to true.
+// - The MCP23017s are then only read if a sensor has changed, and short contacts (e.g. of fast trains) are not missed.
 
 // MCP23017 port expander used?
 #define USE_MCP23017 false
 
+// MCP23017 interrupt pin installed?
+#define MCP23017_INT_PIN_INSTALLED false
+const uint8_t MCP23017_INT_PIN = D5;
+
 // Number of chained MCP23017 port extenders
 #define NUM_MCP23017s 1
 
@@ -111,37 +118,49 @@ const uint8_t PCA9685_OE_PIN = D0;
 // Number of servos
 #define NUM_SERVOS 6
 
-TServoConfiguration servoConfiguration[NUM_SERVOS] =
+constexpr TServoConfiguration servoConfiguration[NUM_SERVOS] =
     {
     {
         .pin = D0,
          .pinType = 0,
-        .detachAfterUsage = true
+        .detachAfterUsage = true,
+        .speed = 45,
+        .easing = ServoEasing::EASE_IN_OUT
     },
     {
         .pin = D1,
          .pinType = 0,
-        .detachAfterUsage = true
+        .detachAfterUsage = true,
+        .speed = 45,
+        .easing = ServoEasing::EASE_IN_OUT
     },
     {
         .pin = D2,
          .pinType = 0,
-        .detachAfterUsage = true
+        .detachAfterUsage = true,
+        .speed = 45,
+        .easing = ServoEasing::EASE_IN_OUT
     },
     {
         .pin = D3,
         .pinType = 0,
-        .detachAfterUsage = true
+        .detachAfterUsage = true,
+        .speed = 45,
+        .easing = ServoEasing::EASE_IN_OUT
     },
     {
         .pin = D6,
         .pinType = 0,
-        .detachAfterUsage = true
+        .detachAfterUsage = true,
+        .speed = 45,
+        .easing = ServoEasing::EASE_IN_OUT
     },
     {
         .pin = D7,
         .pinType = 0,
-        .detachAfterUsage = true
+        .detachAfterUsage = true,
+        .speed = 45,
+        .easing = ServoEasing::EASE_IN_OUT
     },
 };
 
@@ -155,7 +174,7 @@ TServoConfiguration servoConfiguration[NUM_SERVOS] =
 // Number of LEDs
 #define NUM_LEDS 2
 
-TLEDConfiguration ledConfiguration[NUM_LEDS] =
+constexpr TLEDConfiguration ledConfiguration[NUM_LEDS] =
     {
     {
         .pin = D4,
@@ -184,7 +203,7 @@ TLEDConfiguration ledConfiguration[NUM_LEDS] =
 // If you do not control a level crossing in Autonomous Mode with this controller, set to false!
 #define REMOTE_SENSORS_ENABLED false
 
-TSensorConfiguration sensorConfiguration[NUM_SENSORS] = {};
+constexpr TSensorConfiguration sensorConfiguration[NUM_SENSORS] = {};
 
 
 
@@ -212,7 +231,7 @@ const int STATUS_LED_POWER = 300;
 // Number of switches
 #define NUM_SWITCHES 0
 
-TSwitchConfiguration switchConfiguration[NUM_SWITCHES] = {};
+constexpr TSwitchConfiguration switchConfiguration[NUM_SWITCHES] = {};
 
 
 
@@ -228,7 +247,7 @@ TSwitchConfiguration switchConfiguration[NUM_SWITCHES] = {};
 // If no form signals are used, just set to 0
 #define NUM_SIGNAL_SERVOS 1
 
-TSignalConfiguration signalConfiguration[NUM_SIGNALS] =
+constexpr TSignalConfiguration signalConfiguration[NUM_SIGNALS] =
 {
     // signal 0 (N5): a simple form signal with 2 aspects, controlled via Rocrail ports 1 and 2, using servo index 0 (pin D0)
     {
@@ -337,7 +356,7 @@ TSignalConfiguration signalConfiguration[NUM_SIGNALS] =
 // Number of tracks leading over the level crossing
 #define LC_NUM_TRACKS 2
 
-TLevelCrossingConfiguration levelCrossingConfiguration = {};
+constexpr TLevelCrossingConfiguration levelCrossingConfiguration = {};
 
 
 
@@ -349,7 +368,7 @@ TLevelCrossingConfiguration levelCrossingConfiguration = {};
 // Number of bridge Leafs (equals number of bridge servos)
 #define NUM_BASCULE_BRIDGE_LEAFS 0
 
-TBridgeConfiguration bridgeConfiguration = {};
+constexpr TBridgeConfiguration bridgeConfiguration = {};
 
 
 
@@ -358,7 +377,7 @@ TBridgeConfiguration bridgeConfiguration = {};
 // General switch for speedometer (false = no speedometer connected; true = speedometer connected)
 #define SPEEDOMETER_CONNECTED false
 
-TSpeedometerConfiguration speedometerConfiguration = {};
+constexpr TSpeedometerConfiguration speedometerConfiguration = {};
 
 
 
@@ -91,10 +91,17 @@ const uint8_t PCA9685_OE_PIN = D0;
 // Sensors:
 // - Connecting sensors to the MCP23017 is simple.
 // - Just connect one of of the cable pair to GND, the other one to one of the ports of the MCP23017.
+// Interrupts:
+// - Optionally, connect the INTA ports of all MCP23017s to a free pin of the ESP8266 and set MCP23017_INT_PIN_INSTALLED to true.
+// - The MCP23017s are then only read if a sensor has changed, and short contacts (e.g. of fast trains) are not missed.
 
 // MCP23017 port expander used?
 #define USE_MCP23017 false
 
+// MCP23017 interrupt pin installed?
+#define MCP23017_INT_PIN_INSTALLED false
+const uint8_t MCP23017_INT_PIN = D5;
+
 // Number of chained MCP23017 port extenders
 #define NUM_MCP23017s 1
 
@@ -107,7 +114,7 @@ const uint8_t PCA9685_OE_PIN = D0;
 // Number of servos
 #define NUM_SERVOS 0
 
-TServoConfiguration servoConfiguration[NUM_SERVOS] = {};
+constexpr TServoConfiguration servoConfiguration[NUM_SERVOS] = {};
 
 
 
@@ -119,7 +126,7 @@ TServoConfiguration servoConfiguration[NUM_SERVOS] = {};
 // Number of LEDs
 #define NUM_LEDS 0
 
-TLEDConfiguration ledConfiguration[NUM_LEDS] = {};
+constexpr TLEDConfiguration ledConfiguration[NUM_LEDS] = {};
 
 
 
@@ -138,7 +145,7 @@ TLEDConfiguration ledConfiguration[NUM_LEDS] = {};
 // If you do not control a level crossing in Autonomous Mode with this controller, set to false!
 #define REMOTE_SENSORS_ENABLED false
 
-TSensorConfiguration sensorConfiguration[NUM_SENSORS] = {};
+constexpr TSensorConfiguration sensorConfiguration[NUM_SENSORS] = {};
 
 
 
@@ -166,7 +173,7 @@ const int STATUS_LED_POWER = 300;
 // Number of switches
 #define NUM_SWITCHES 0
 
-TSwitchConfiguration switchConfiguration[NUM_SWITCHES] = {};
+constexpr TSwitchConfiguration switchConfiguration[NUM_SWITCHES] = {};
 
 
 
@@ -182,7 +189,7 @@ TSwitchConfiguration switchConfiguration[NUM_SWITCHES] = {};
 // If no form signals are used, just set to 0
 #define NUM_SIGNAL_SERVOS 0
 
-TSignalConfiguration signalConfiguration[NUM_SIGNALS] = {};
+constexpr TSignalConfiguration signalConfiguration[NUM_SIGNALS] = {};
 
 
 
@@ -203,7 +210,7 @@ TSignalConfiguration signalConfiguration[NUM_SIGNALS] = {};
 // Number of tracks leading over the level crossing
 #define LC_NUM_TRACKS 2
 
-TLevelCrossingConfiguration levelCrossingConfiguration = {};
+constexpr TLevelCrossingConfiguration levelCrossingConfiguration = {};
 
 
 
@@ -215,7 +222,7 @@ TLevelCrossingConfiguration levelCrossingConfiguration = {};
 // Number of bridge Leafs (equals number of bridge servos)
 #define NUM_BASCULE_BRIDGE_LEAFS 0
 
-TBridgeConfiguration bridgeConfiguration = {};
+constexpr TBridgeConfiguration bridgeConfiguration = {};
 
 
 
@@ -224,7 +231,7 @@ TBridgeConfiguration bridgeConfiguration = {};
 // General switch for speedometer (false = no speedometer connected; true = speedometer connected)
 #define SPEEDOMETER_CONNECTED false
 
-TSpeedometerConfiguration speedometerConfiguration = {};
+constexpr TSpeedometerConfiguration speedometerConfiguration = {};
 
 
 
@@ -92,10 +92,17 @@ uint8_t PCA9685_OE_PIN = D7;
 // Sensors:
 // - Connecting sensors to the MCP23017 is simple.
 // - Just connect one of of the cable pair to GND, the other one to one of the ports of the MCP23017.
+// Interrupts:
+// - Optionally, connect the INTA ports of all MCP23017s to a free pin of the ESP8266 and set MCP23017_INT_PIN_INSTALLED to true.
+// - The MCP23017s are then only read if a sensor has changed, and short contacts (e.g. of fast trains) are not missed.
 
 // MCP23017 port expander used?
 #define USE_MCP23017 true
 
+// MCP23017 interrupt pin installed?
+#define MCP23017_INT_PIN_INSTALLED false
+const uint8_t MCP23017_INT_PIN = D5;
+
 // Number of chained MCP23017 port extenders
 #define NUM_MCP23017s 2
 
@@ -108,7 +115,7 @@ uint8_t PCA9685_OE_PIN = D7;
 // Number of servos
 #define NUM_SERVOS 16
 
-TServoConfiguration servoConfiguration[NUM_SERVOS] =
+constexpr TServoConfiguration servoConfiguration[NUM_SERVOS] =
 {
     {
         .pin = 0,
@@ -201,7 +208,7 @@ TServoConfiguration servoConfiguration[NUM_SERVOS] =
 // Number of LEDs
 #define NUM_LEDS 16
 
-TLEDConfiguration ledConfiguration[NUM_LEDS] =
+constexpr TLEDConfiguration ledConfiguration[NUM_LEDS] =
 {
     {
         .pin = 0,
@@ -286,7 +293,7 @@ TLEDConfiguration ledConfiguration[NUM_LEDS] =
 // If you do not control a level crossing in Autonomous Mode with this controller, set to false!
 #define REMOTE_SENSORS_ENABLED false
 
-TSensorConfiguration sensorConfiguration[NUM_SENSORS] =
+constexpr TSensorConfiguration sensorConfiguration[NUM_SENSORS] =
 {
     {
         .pin = 0,
@@ -395,7 +402,7 @@ const int STATUS_LED_POWER = 300;
 // Number of switches
 #define NUM_SWITCHES 24
 
-TSwitchConfiguration switchConfiguration[NUM_SWITCHES] =
+constexpr TSwitchConfiguration switchConfiguration[NUM_SWITCHES] =
 {
     // Standard switches / Triple switches
     {
@@ -608,7 +615,7 @@ TSwitchConfiguration switchConfiguration[NUM_SWITCHES] =
 // If no form signals are used, just set to 0
 #define NUM_SIGNAL_SERVOS 0
 
-TSignalConfiguration signalConfiguration[NUM_SIGNALS] =
+constexpr TSignalConfiguration signalConfiguration[NUM_SIGNALS] =
 {
     {
         .signalRocrailPort = 0,
@@ -742,7 +749,7 @@ TSignalConfiguration signalConfiguration[NUM_SIGNALS] =
 // Number of tracks leading over the level crossing
 #define LC_NUM_TRACKS 2
 
-TLevelCrossingConfiguration levelCrossingConfiguration = {};
+constexpr TLevelCrossingConfiguration levelCrossingConfiguration = {};
 
 
 
@@ -754,7 +761,7 @@ TLevelCrossingConfiguration levelCrossingConfiguration = {};
 // Number of bridge Leafs (equals number of bridge servos)
 #define NUM_BASCULE_BRIDGE_LEAFS 0
 
-TBridgeConfiguration bridgeConfiguration = {};
+constexpr TBridgeConfiguration bridgeConfiguration = {};
 
 
 
@@ -763,7 +770,7 @@ TBridgeConfiguration bridgeConfiguration = {};
 // General switch for speedometer (false = no speedometer connected; true = speedometer connected)
 #define SPEEDOMETER_CONNECTED false
 
-TSpeedometerConfiguration speedometerConfiguration = {};
+constexpr TSpeedometerConfiguration speedometerConfiguration = {};
 
 
 
@@ -18,19 +18,42 @@
 // Maximum time that the detach procedure procedure will wait until the PWM signal is low and therefore ready to be detached (for directly connected servos only)
 #define MAX_WAIT_FOR_LOW_MS 100
 
+// States of detaching a directly connected servo (the PWM signal is sampled once per loop pass)
+enum struct ServoDetachState {
+    NONE,          // no detach pending
+    WAIT_FOR_HIGH, // waiting for a pulse of the PWM signal
+    WAIT_FOR_LOW   // pulse seen, detach as soon as the PWM signal is low again
+};
+// Speed of switch and form signal movements in degrees per second, if not configured for the servo
+#define SERVO_DEFAULT_SPEED 90
+
 struct MattzoServo {
     Servo servo; // Servo object to control servos
     boolean isAttached = false;
     unsigned long lastSwitchingAction_ms = 0;
+    ServoDetachState detachState = ServoDetachState::NONE;
+    unsigned long detachStart_ms = 0;
+    int angle = -1; // angle last set (-1: unknown, e.g. after startup)
+
+    // movement started by moveServo()
+    boolean isMoving = false;
+    int startAngle = 0;
+    int targetAngle = 0;
+    unsigned long moveStart_ms = 0;
+    unsigned long moveDuration_ms = 0;
 };
 
-// SWITCH CONSTANTS
+// SWITCH CONSTANTS AND STRUCTS
 // Default values for TrixBrix switches (in case servo angles are not transmitted)
 #define SWITCHSERVO_MIN_ALLOWED 10  // minimum accepted servo angle from Rocrail. Anything below this value is treated as misconfiguration and is neglected and reset to SWITCHSERVO_MIN.
 #define SWITCHSERVO_MIN 75          // a good first guess for the minimum angle of TrixBrix servos is 70
 #define SWITCHSERVO_MAX 85          // a good first guess for the maximum angle of TrixBrix servos is 90
 #define SWITCHSERVO_MAX_ALLOWED 150 // maximum accepted servo angle from Rocrail. Anything above this value is treated as misconfiguration and is neglected and reset to SWITCHSERVO_MAX.
 
+struct MattzoSwitch {
+    int pendingCommand = -1; // command whose feedback sensor is triggered when the servos have finished moving (-1: none)
+};
+
 // SIGNAL CONSTANTS AND STRUCTS
 # define SIGNAL_OVERSHOOT_SENSOR_SLEEP_MS 10000 // defines the sleep time in ms after a signal is set to red after which the overshoot sensor becomes active
 
@@ -42,6 +65,27 @@ struct MattzoSignal {
 // SENSOR CONSTANTS
 // Time in milliseconds until release event is reported after sensor has lost contact
 #define SENSOR_RELEASE_TICKS_MS 100
+// Number of edges of local sensors that can be buffered between two loop passes (must be a power of two)
+#define SENSOR_EDGE_BUFFER_SIZE 32
+
+// Edge of a local sensor, recorded by the pin interrupt
+struct SensorEdge {
+    uint8_t sensorIndex;
+    uint8_t level; // pin level after the edge
+    unsigned long time_us; // time of the edge (micros())
+};
+
+// LOOP STATISTICS
+// Interval in which loop statistics are logged (at debug level)
+#define LOOP_STATISTICS_INTERVAL_MS 10000
+
+struct LoopStatistics {
+    unsigned long intervalStart_ms = 0;
+    unsigned long passes = 0; // loop passes in the current interval
+    unsigned long maxPassTime_us = 0; // longest loop pass in the current interval
+    unsigned long sensorScanTime_us = 0; // time spent scanning sensors in the current interval
+    unsigned long i2cTransactions = 0; // calls to port expanders (MCP23017, PCA9685) in the current interval
+};
 
 // LEVEL CROSSING STRUCTS
 enum struct LevelCrossingStatus {
@@ -131,6 +175,7 @@ struct Speedometer {
     unsigned long lastMeasurementEvent = -99999;
     unsigned long measurementDone = -99999;
     unsigned long animationDelay = -99999;
+    unsigned long measurementStart_us = 0; // time of the first start sensor contact, startTime and endTime are relative to it
 
     float actualTrainSpeed = 0;
     float actualTrainLength = 0;
@@ -146,16 +191,26 @@ void writeLevelCrossingStatusInfo();
 void handleLevelCrossingSensorEvent(int triggeredSensor);
 bool lcIsOccupied();
 void setServoAngle(int servoIndex, int servoAngle);
+void writeServoAngle(int servoIndex, int servoAngle);
+void moveServo(int servoIndex, int servoAngle);
+bool isServoMoving(int servoIndex);
+void servoLoop();
+void switchLoop();
 void setSignalLED(int signalIndex, bool ledState);
 void setLEDBySensorStates();
 void handleRemoteSensorEvent(int mcId, int sensorAddress, bool sensorState);
 bool isPhysicalSensor(int sensorIndex);
+void IRAM_ATTR handleSensorEdge(void *sensorIndex);
+void processSensorEdges();
+void handleSensorContact(int sensorIndex, unsigned long contact_us);
+void updateLoopStatistics();
 
 #if USE_PCA9685
 void setupPCA9685();
 #endif
 #if USE_MCP23017
 void setupMCP23017();
+void readMCP23017Sensors();
 #endif
 
 #if USE_U8G2
@@ -163,6 +218,7 @@ void setupU8g2();
 #endif
 
 void setServoSleepMode(bool onOff);
+void checkDetachServo(int servoIndex);
 int mapAngle2PulseLength(int angle);
 
 void setBridgeLights();
@@ -173,7 +229,7 @@ void processBridgeLeaf(int leafIndex);
 bool checkForBridgeLeafErrors();
 bool checkAllBridgeLeafsClosed();
 
-void handleSpeedometerSensorEvent(int triggeredSensor);
+void handleSpeedometerSensorEvent(int triggeredSensor, unsigned long contact_us);
 
 void handleSignalMessageControlTypeDefault(int rr_port);
 void handleSignalMessageControlTypeAspectNumbers(int rr_port1, int a);
@@ -184,6 +240,13 @@ void handleSignalOvershootSensorEvent(int overshootSensorIndex);
 
 void setLED(int ledIndex, bool ledState);
 void fadeLED(int ledIndex, int brightness);
+#if USE_PCA9685
+void setPCA9685LED(int p, int channel, uint16_t duty);
+#endif
+#if USE_MCP23017
+void setMCP23017Output(int m, int pin, bool level);
+#endif
+void flushLEDs();
 
 void sendSwitchSensorEvent(int switchIndex, int switchCommand, bool sensorState);
 
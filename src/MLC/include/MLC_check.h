@@ -36,3 +36,107 @@
 #if LC_NUM_BASCULE_BRIDGE_LEAFS > MAX_NUM_BASCULE_BRIDGE_LEAFS
 #error "LC_NUM_BASCULE_BRIDGE_LEAFS may not be larger than: MAX_NUM_BASCULE_BRIDGE_LEAFS"
 #endif
+
+
+// Consistency checks of the configuration arrays
+// The checks are evaluated by the compiler, so the switch, signal and sensor configuration arrays must be declared constexpr.
+
+// Returns true if the index is a valid index of an array of the given size (or -1 = not used, if allowed)
+constexpr bool isValidIndex(int index, int size, bool unusedAllowed)
+{
+    return (index >= 0 && index < size) || (unusedAllowed && index == -1);
+}
+
+// Returns true if the sensor index refers to a virtual sensor
+constexpr bool isVirtualSensorIndex(int sensorIndex)
+{
+    return isValidIndex(sensorIndex, NUM_SENSORS, false) && sensorConfiguration[sensorIndex].pinType == VIRTUAL_SENSOR_PIN_TYPE;
+}
+
+// Returns true if no two switches use the same Rocrail port
+constexpr bool checkSwitchPortsUnique()
+{
+    for (int s = 0; s < NUM_SWITCHES; s++) {
+        for (int t = s + 1; t < NUM_SWITCHES; t++) {
+            if (switchConfiguration[s].rocRailPort == switchConfiguration[t].rocRailPort) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Returns true if no switch uses the Rocrail port of the level crossing or the bascule bridge (which would hide the switch)
+constexpr bool checkSwitchPortsFree()
+{
+    for (int s = 0; s < NUM_SWITCHES; s++) {
+        if (LEVEL_CROSSING_CONNECTED && switchConfiguration[s].rocRailPort == levelCrossingConfiguration.rocRailPort) {
+            return false;
+        }
+        if (BASCULE_BRIDGE_CONNECTED && switchConfiguration[s].rocRailPort == bridgeConfiguration.rocRailPort) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns true if all switches refer to configured servos and (if used) to virtual sensors
+constexpr bool checkSwitchReferences()
+{
+    for (int s = 0; s < NUM_SWITCHES; s++) {
+        if (!isValidIndex(switchConfiguration[s].servoIndex, NUM_SERVOS, false) || !isValidIndex(switchConfiguration[s].servo2Index, NUM_SERVOS, true)) {
+            return false;
+        }
+        if (switchConfiguration[s].triggerSensors && (!isVirtualSensorIndex(switchConfiguration[s].sensorIndex[0]) || !isVirtualSensorIndex(switchConfiguration[s].sensorIndex[1]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns true if all signals refer to configured LEDs, servos and sensors
+constexpr bool checkSignalReferences()
+{
+    for (int s = 0; s < NUM_SIGNALS; s++) {
+        for (int l = 0; l < NUM_SIGNAL_LEDS; l++) {
+            if (!isValidIndex(signalConfiguration[s].aspectLEDPort[l], NUM_LEDS, true)) {
+                return false;
+            }
+        }
+        for (int v = 0; v < NUM_SIGNAL_SERVOS; v++) {
+            if (!isValidIndex(signalConfiguration[s].servoIndex[v], NUM_SERVOS, true)) {
+                return false;
+            }
+        }
+        if (!isValidIndex(signalConfiguration[s].overshootSensorIndex, NUM_SENSORS, true)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns true if all remote sensors have a valid address (0..127) and no two remote sensors have the same controller id and address
+constexpr bool checkRemoteSensorsUnique()
+{
+    for (int s = 0; s < NUM_SENSORS; s++) {
+        if (sensorConfiguration[s].pinType != REMOTE_SENSOR_PIN_TYPE) {
+            continue;
+        }
+        if (sensorConfiguration[s].pin < 0 || sensorConfiguration[s].remoteMattzoControllerId < 0) {
+            return false;
+        }
+        for (int t = s + 1; t < NUM_SENSORS; t++) {
+            if (sensorConfiguration[t].pinType == REMOTE_SENSOR_PIN_TYPE && sensorConfiguration[t].pin == sensorConfiguration[s].pin && sensorConfiguration[t].remoteMattzoControllerId == sensorConfiguration[s].remoteMattzoControllerId) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static_assert(!LEVEL_CROSSING_CONNECTED || (levelCrossingConfiguration.bbClosingPeriod_ms > 0 && levelCrossingConfiguration.bbOpeningPeriod_ms > 0 && levelCrossingConfiguration.ledFlashingPeriod_ms > 0), "The closing, opening and LED flashing periods in levelCrossingConfiguration must be greater than 0");
+static_assert(checkSwitchPortsUnique(), "Two switches in switchConfiguration must not have the same rocRailPort");
+static_assert(checkSwitchPortsFree(), "A switch in switchConfiguration must not have the rocRailPort of the level crossing or the bascule bridge");
+static_assert(checkSwitchReferences(), "A switch in switchConfiguration refers to a servo that does not exist, or to a sensor that is not a virtual sensor");
+static_assert(checkSignalReferences(), "A signal in signalConfiguration refers to a LED, servo or overshoot sensor that does not exist");
+static_assert(checkRemoteSensorsUnique(), "Remote sensors in sensorConfiguration must have an address (pin) of 0..127 and must not have the same address and remoteMattzoControllerId");
@@ -0,0 +1,130 @@
+// This file must be included after MLC_check.h
+
+// Reverse indexes from the Rocrail ports of incoming messages to the configured switches, signals and remote sensors.
+// The indexes are hash tables that the compiler builds from the (constexpr) configuration arrays,
+// so finding the target of a message usually takes a single probe and costs nothing at startup.
+
+// Entry of a reverse index
+struct TIndexEntry {
+    // Rocrail port (or remote sensor key)
+    int32_t key = 0;
+    // Index in the configuration array (switch, signal or sensor index)
+    // -1: empty slot
+    int8_t index = -1;
+    // Aspect of the signal (aspect index only, otherwise -1)
+    int8_t aspect = -1;
+};
+
+// Reverse index with N slots (N must be a power of two)
+template <int N>
+struct TIndex {
+    TIndexEntry slot[N];
+};
+
+// Returns the number of slots for an index of the given number of entries
+// At most half of the slots are used, so there is always an empty slot that ends a probe sequence.
+constexpr int indexSize(int numEntries)
+{
+    int size = 2;
+    while (size < 2 * numEntries) {
+        size *= 2;
+    }
+    return size;
+}
+
+// Returns the first slot to probe for the given key
+// Multiplying by an odd constant spreads both consecutive and evenly spaced ports (like 11, 21, 31) over the slots.
+constexpr unsigned int indexSlot(int32_t key, int size)
+{
+    return ((uint32_t)key * 2654435761u) & (size - 1);
+}
+
+// Adds an entry to the index (linear probing)
+template <int N>
+constexpr void addIndexEntry(TIndex<N> &index, int32_t key, int i, int aspect)
+{
+    unsigned int s = indexSlot(key, N);
+    while (index.slot[s].index >= 0) {
+        s = (s + 1) & (N - 1);
+    }
+    index.slot[s].key = key;
+    index.slot[s].index = i;
+    index.slot[s].aspect = aspect;
+}
+
+// Calls the callback for every entry with the given key
+// Several signals may listen to the same Rocrail port, so a key can have more than one entry.
+template <int N, typename F>
+void forEachIndexEntry(const TIndex<N> &index, int32_t key, F callback)
+{
+    for (unsigned int s = indexSlot(key, N); index.slot[s].index >= 0; s = (s + 1) & (N - 1)) {
+        if (index.slot[s].key == key) {
+            callback(index.slot[s]);
+        }
+    }
+}
+
+// Returns the key of a remote sensor (the MattzoControllerId of the remote controller and the address of the sensor)
+// Addresses outside of the range of the sensor pin field (0..127) get key -1, which no sensor has.
+constexpr int32_t remoteSensorKey(int mcId, int sensorAddress)
+{
+    return (sensorAddress < 0 || sensorAddress > 127 || mcId < 0) ? -1 : (int32_t)mcId * 128 + sensorAddress;
+}
+
+// Indices are stored as int8_t
+static_assert(NUM_SWITCHES <= 127, "NUM_SWITCHES must not be greater than 127");
+static_assert(NUM_SIGNALS <= 127, "NUM_SIGNALS must not be greater than 127");
+static_assert(NUM_SENSORS <= 127, "NUM_SENSORS must not be greater than 127");
+
+// Rocrail port -> switch index
+constexpr TIndex<indexSize(NUM_SWITCHES)> buildSwitchIndex()
+{
+    TIndex<indexSize(NUM_SWITCHES)> index = {};
+    for (int s = 0; s < NUM_SWITCHES; s++) {
+        addIndexEntry(index, switchConfiguration[s].rocRailPort, s, -1);
+    }
+    return index;
+}
+
+// Rocrail port -> signal index and aspect (signals with control type "default")
+constexpr TIndex<indexSize(NUM_SIGNALS * NUM_SIGNAL_ASPECTS)> buildSignalAspectIndex()
+{
+    TIndex<indexSize(NUM_SIGNALS * NUM_SIGNAL_ASPECTS)> index = {};
+    for (int s = 0; s < NUM_SIGNALS; s++) {
+        for (int a = 0; a < NUM_SIGNAL_ASPECTS; a++) {
+            if (signalConfiguration[s].aspectRocrailPort[a] >= 1) {
+                addIndexEntry(index, signalConfiguration[s].aspectRocrailPort[a], s, a);
+            }
+        }
+    }
+    return index;
+}
+
+// Rocrail port -> signal index (signals with control type "aspect numbers")
+constexpr TIndex<indexSize(NUM_SIGNALS)> buildSignalIndex()
+{
+    TIndex<indexSize(NUM_SIGNALS)> index = {};
+    for (int s = 0; s < NUM_SIGNALS; s++) {
+        if (signalConfiguration[s].signalRocrailPort >= 1) {
+            addIndexEntry(index, signalConfiguration[s].signalRocrailPort, s, -1);
+        }
+    }
+    return index;
+}
+
+// Remote sensor key -> sensor index
+constexpr TIndex<indexSize(NUM_SENSORS)> buildRemoteSensorIndex()
+{
+    TIndex<indexSize(NUM_SENSORS)> index = {};
+    for (int s = 0; s < NUM_SENSORS; s++) {
+        if (sensorConfiguration[s].pinType == REMOTE_SENSOR_PIN_TYPE) {
+            addIndexEntry(index, remoteSensorKey(sensorConfiguration[s].remoteMattzoControllerId, sensorConfiguration[s].pin), s, -1);
+        }
+    }
+    return index;
+}
+
+constexpr auto switchPortIndex = buildSwitchIndex();
+constexpr auto signalAspectPortIndex = buildSignalAspectIndex();
+constexpr auto signalPortIndex = buildSignalIndex();
+constexpr auto remoteSensorIndex = buildRemoteSensorIndex();
\ No newline at end of file
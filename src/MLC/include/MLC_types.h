@@ -2,6 +2,12 @@
 #include "Arduino.h"
 
 
+// Easing profiles for servo movements
+enum struct ServoEasing {
+    LINEAR = 0,  // constant speed
+    EASE_IN_OUT  // accelerate at the start and decelerate at the end of the movement (same duration as LINEAR)
+};
+
 typedef struct {
     // Digital output pins for switch servos (pins like D0, D1 etc. for ESP-8266 I/O pins, numbers like 0, 1 etc. for pins of the PCA9685)
     uint8_t pin;
@@ -17,6 +23,13 @@ typedef struct {
     // this feature is helpful to prevent blocking servo from burning down, it saves power and reduced servo flattering
     // for bascule bridges, the feature must be switched off!
     bool detachAfterUsage;
+
+    // speed of switch and form signal movements in degrees per second (optional, 0 or not set: SERVO_DEFAULT_SPEED)
+    // servos of level crossings and bascule bridges are driven by their own logic and are not affected
+    uint16_t speed;
+
+    // easing profile of switch and form signal movements (optional, default: LINEAR)
+    ServoEasing easing;
 } TServoConfiguration;
 
 
@@ -9,14 +9,16 @@
 #include "MLC_types.h"
 #include "MTC.h"
 #include <Servo.h>
+#include <atomic>
 
 #include "../conf/my/controller_config.h"
 #include "../conf/my/network_config.h"
 
 #include "MLC_check.h"
+#include "MLC_index.h"
 #include "MattzoController_Library.h" // MattzoController library file
 
-#if USE_PCA9685
+#if USE_PCA9685 || USE_MCP23017
 #include <Wire.h> // Built-in library for I2C
 #endif
 
@@ -50,6 +52,9 @@ unsigned long pca9685SleepModeFrom_ms = 0;
 // SERVO ARRAY
 struct MattzoServo mattzoServo[NUM_SERVOS];
 
+// SWITCH ARRAY
+struct MattzoSwitch mattzoSwitch[NUM_SWITCHES];
+
 // SIGNAL ARRAY
 struct MattzoSignal mattzoSignal[NUM_SIGNALS];
 
@@ -58,6 +63,45 @@ bool sensorState[NUM_SENSORS];
 int sensorTriggerState[NUM_SENSORS];
 unsigned long lastSensorContact_ms[NUM_SENSORS];
 
+// Edges of local sensors, written by handleSensorEdge (interrupt) and read by processSensorEdges (loop)
+// The interrupt only advances sensorEdgeHead and the loop only advances sensorEdgeTail, so no locking is required.
+// Compiler barriers keep the accesses to an edge on the right side of publishing (interrupt) and freeing (loop) its slot.
+SensorEdge sensorEdges[SENSOR_EDGE_BUFFER_SIZE];
+volatile uint8_t sensorEdgeHead = 0;
+volatile uint8_t sensorEdgeTail = 0;
+volatile unsigned int sensorEdgesDropped = 0;
+// Pin level of each local sensor after the last processed edge
+uint8_t sensorEdgeLevel[NUM_SENSORS];
+
+#if USE_MCP23017
+// Pins of each MCP23017 with sensors attached (bit n: pin n)
+uint16_t mcp23017SensorPins[NUM_MCP23017s];
+// Inputs of each MCP23017 for the current loop pass (bit n: pin n)
+uint16_t mcp23017Inputs[NUM_MCP23017s];
+#if MCP23017_INT_PIN_INSTALLED
+// Inputs of each MCP23017 as of the last read, which are still valid if the MCP23017s have not signalled a change since
+uint16_t mcp23017LastInputs[NUM_MCP23017s];
+#endif
+#endif
+
+// LED VARIABLES
+// The LEDs connected to port expanders are set in these shadow registers and written by flushLEDs() once per loop pass, if they have changed.
+#if USE_PCA9685
+// Duty cycle of the LEDs on each PCA9685 channel (0: off, 4096: fully on, see setPCA9685LED)
+uint16_t pca9685LEDDuty[NUM_PCA9685s][16];
+// Channels of each PCA9685 whose LED has changed since the last flush (bit n: channel n)
+uint16_t pca9685DirtyLEDs[NUM_PCA9685s];
+#endif
+#if USE_MCP23017
+// Output latch of each MCP23017 (bit n: pin n)
+uint16_t mcp23017Outputs[NUM_MCP23017s];
+// Output latch of the MCP23017 has changed since the last flush
+bool mcp23017OutputsDirty[NUM_MCP23017s];
+#endif
+
+// Loop pass and I2C counters, logged every LOOP_STATISTICS_INTERVAL_MS
+LoopStatistics loopStatistics;
+
 // SPECIAL USE OBJECTS
 LevelCrossing levelCrossing;
 struct Bridge bridge;
@@ -96,13 +140,18 @@ void setup()
             pinMode(ledConfiguration[i].pin, OUTPUT);
         } else if (ledConfiguration[i].pinType >= 0x40) {
             // LED connected to PCA9685
-            // no action required
+#if USE_PCA9685
+            // the PWM registers survive a restart of the ESP8266 (reset() only restarts the oscillator), so write the shadow duty cycle with the first flush
+            pca9685DirtyLEDs[ledConfiguration[i].pinType - 0x40] |= 1 << ledConfiguration[i].pin;
+#endif
         }
 #if USE_MCP23017
         else if (ledConfiguration[i].pinType >= MCP23017_SENSOR_PIN_TYPE && ledConfiguration[i].pinType < 0x40) {
             // LED connected to MCP23017
             m = ledConfiguration[i].pinType - MCP23017_SENSOR_PIN_TYPE; // index of the MCP23017
             mcp23017[m].pinMode(ledConfiguration[i].pin, OUTPUT);
+            // the output latch survives a restart of the ESP8266, so write the shadow register with the first flush
+            mcp23017OutputsDirty[m] = true;
         }
 #endif
     }
@@ -113,6 +162,11 @@ void setup()
             // sensor connected directly to the controller
             pinMode(sensorConfiguration[i].pin, INPUT_PULLUP);
             sensorTriggerState[i] = (sensorConfiguration[i].pin == D8) ? HIGH : LOW;
+            sensorEdgeLevel[i] = digitalRead(sensorConfiguration[i].pin);
+            // record the edges with their exact time (not possible on D0, which is polled only)
+            if (digitalPinToInterrupt(sensorConfiguration[i].pin) != NOT_AN_INTERRUPT) {
+                attachInterruptArg(digitalPinToInterrupt(sensorConfiguration[i].pin), handleSensorEdge, (void *)(intptr_t)i, CHANGE);
+            }
         }
 #if USE_MCP23017
         else if (sensorConfiguration[i].pinType >= MCP23017_SENSOR_PIN_TYPE && sensorConfiguration[i].pinType < 0x40) {
@@ -120,12 +174,23 @@ void setup()
             m = sensorConfiguration[i].pinType - MCP23017_SENSOR_PIN_TYPE; // index of the MCP23017
             mcp23017[m].pinMode(sensorConfiguration[i].pin, INPUT);
             mcp23017[m].pullUp(sensorConfiguration[i].pin, HIGH); // turn on a 100K pull-up resistor internally
+            mcp23017SensorPins[m] |= 1 << sensorConfiguration[i].pin;
+#if MCP23017_INT_PIN_INSTALLED
+            mcp23017[m].setupInterruptPin(sensorConfiguration[i].pin, CHANGE);
+#endif
             sensorTriggerState[i] = LOW;
         }
 #endif
         sensorState[i] = false;
     }
 
+#if USE_MCP23017 && MCP23017_INT_PIN_INSTALLED
+    // read the initial inputs, which also clears pending interrupts
+    for (m = 0; m < NUM_MCP23017s; m++) {
+        mcp23017LastInputs[m] = mcp23017[m].readGPIOAB();
+    }
+#endif
+
     // load config from EEPROM, initialize Wifi, MQTT etc.
     setupMattzoController(true);
 
@@ -155,7 +220,61 @@ void setupMCP23017()
     for (int m = 0; m < NUM_MCP23017s; m++) {
         mcp23017[m] = Adafruit_MCP23017();
         mcp23017[m].begin(m);
+#if MCP23017_INT_PIN_INSTALLED
+        // INTA and INTB mirrored, open drain (so the INTA pins of all MCP23017s can be connected to MCP23017_INT_PIN), active low
+        mcp23017[m].setupInterrupts(true, true, LOW);
+#endif
+    }
+
+#if MCP23017_INT_PIN_INSTALLED
+    pinMode(MCP23017_INT_PIN, INPUT_PULLUP);
+#endif
+}
+
+// Reads the inputs of all MCP23017s with sensors into mcp23017Inputs
+void readMCP23017Sensors()
+{
+#if MCP23017_INT_PIN_INSTALLED
+    // The MCP23017s pull MCP23017_INT_PIN low as soon as one of the sensor inputs changes, and capture all inputs at that moment.
+    // The capture is kept until it is read, so it is sufficient to check the pin once per loop pass.
+    if (digitalRead(MCP23017_INT_PIN) == HIGH) {
+        // nothing has changed
+        memcpy(mcp23017Inputs, mcp23017LastInputs, sizeof(mcp23017Inputs));
+        return;
+    }
+
+    for (int m = 0; m < NUM_MCP23017s; m++) {
+        if (mcp23017SensorPins[m]) {
+            // Read INTF (pins that caused the interrupt), INTCAP (inputs at the moment of the interrupt) and GPIO (current inputs) of both ports at once.
+            // Reading INTCAP and GPIO clears the interrupt.
+            uint8_t address = MCP23017_ADDRESS | m;
+            uint8_t registers[6] = {0};
+            Wire.beginTransmission(address);
+            Wire.write(MCP23017_INTFA);
+            Wire.endTransmission();
+            Wire.requestFrom(address, (uint8_t)sizeof(registers));
+            for (uint8_t r = 0; r < sizeof(registers) && Wire.available(); r++) {
+                registers[r] = Wire.read();
+            }
+            loopStatistics.i2cTransactions++;
+
+            uint16_t interruptFlags = registers[0] | registers[1] << 8;
+            uint16_t capturedInputs = registers[2] | registers[3] << 8;
+            mcp23017LastInputs[m] = registers[4] | registers[5] << 8;
+
+            // Use the captured inputs in this pass, so a contact that is already gone again is reported (and released in one of the next passes).
+            mcp23017Inputs[m] = (capturedInputs & interruptFlags) | (mcp23017LastInputs[m] & ~interruptFlags);
+        }
     }
+#else
+    // Read all pins of each MCP23017 with sensors at once (one I2C transaction per chip instead of one per sensor)
+    for (int m = 0; m < NUM_MCP23017s; m++) {
+        if (mcp23017SensorPins[m]) {
+            mcp23017Inputs[m] = mcp23017[m].readGPIOAB();
+            loopStatistics.i2cTransactions++;
+        }
+    }
+#endif
 }
 #endif
 
@@ -181,7 +300,7 @@ void sendAllSensorStates() {
         }
     }
     if (sensorStatesSent) {
-        mcLog2("States of all physical sensors sent to MQTT.", LOG_INFO);
+        mcLogf(LOG_INFO, "States of all physical sensors sent to MQTT.");
     }
 }
 
@@ -197,12 +316,12 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
     msg[length] = '\0';
 
     if (DEBUG_MQTT_MESSAGES) {
-        mcLog2("Received MQTT message [" + String(topic) + "]: " + String(msg), LOG_DEBUG);
+        mcLogf(LOG_DEBUG, "Received MQTT message [%s]: %s", topic, msg);
     }
 
     XMLDocument xmlDocument;
     if (xmlDocument.Parse(msg) != XML_SUCCESS) {
-        mcLog2("Error parsing XML of MQTT message: " + String(msg), LOG_ERR);
+        mcLogf(LOG_ERR, "Error parsing XML of MQTT message: %s", msg);
         return;
     }
 
@@ -213,22 +332,22 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
     element = xmlDocument.FirstChildElement("sw");
     if (element != NULL) {
         if (DEBUG_MQTT_MESSAGES) {
-            mcLog2("<sw> node found.", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "<sw> node found.");
         }
 
         // query addr1 attribute. This is the MattzoController id.
         // If this does not equal the mattzoControllerId of this controller, the message is disregarded.
         int rr_addr1 = 0;
         if (element->QueryIntAttribute("addr1", &rr_addr1) != XML_SUCCESS) {
-            mcLog2("Error in <sw> message: addr1 attribute not found or wrong type. Message disregarded.", LOG_ERR);
+            mcLogf(LOG_ERR, "Error in <sw> message: addr1 attribute not found or wrong type. Message disregarded.");
             return;
         }
         if (DEBUG_MQTT_MESSAGES) {
-            mcLog2("addr1: " + String(rr_addr1), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "addr1: %d", rr_addr1);
         }
         if (rr_addr1 != mattzoControllerId) {
             if (DEBUG_MQTT_MESSAGES) {
-                mcLog2("Message disgarded, as it is not for me (" + String(mattzoControllerId) + ")", LOG_DEBUG);
+                mcLogf(LOG_DEBUG, "Message disgarded, as it is not for me (%d)", mattzoControllerId);
             }
             return;
         }
@@ -236,11 +355,11 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
         // query port1 attribute. This is port id of the port to which the switch is connected.
         int rr_port1 = 0;
         if (element->QueryIntAttribute("port1", &rr_port1) != XML_SUCCESS) {
-            mcLog2("Error in <sw> message: port1 attribute not found or wrong type. Message disregarded.", LOG_ERR);
+            mcLogf(LOG_ERR, "Error in <sw> message: port1 attribute not found or wrong type. Message disregarded.");
             return;
         }
         if (DEBUG_MQTT_MESSAGES) {
-            mcLog2("port1: " + String(rr_port1), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "port1: %d", rr_port1);
         }
 
         // query cmd attribute.
@@ -250,11 +369,11 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
         // bascule bridge: bridge up or down
         const char *rr_cmd = "-unknown-";
         if (element->QueryStringAttribute("cmd", &rr_cmd) != XML_SUCCESS) {
-            mcLog2("Error in <sw> message: cmd attribute not found or wrong type.", LOG_ERR);
+            mcLogf(LOG_ERR, "Error in <sw> message: cmd attribute not found or wrong type.");
             return;
         }
         if (DEBUG_MQTT_MESSAGES) {
-            mcLog2("cmd: " + String(rr_cmd), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "cmd: %s", rr_cmd);
         }
 
         // parse command string
@@ -264,14 +383,14 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
         } else if (strcmp(rr_cmd, "turnout") == 0) {
             switchCommand = 0;
         } else {
-            mcLog2("Error in <sw> message: switch command unknown - message disregarded.", LOG_ERR);
+            mcLogf(LOG_ERR, "Error in <sw> message: switch command unknown - message disregarded.");
             return;
         }
 
         // Check if port is used to control a level crossing
         if (LEVEL_CROSSING_CONNECTED && (rr_port1 == levelCrossingConfiguration.rocRailPort)) {
             if (DEBUG_MQTT_MESSAGES) {
-                mcLog2("This is a level crossing command.", LOG_DEBUG);
+                mcLogf(LOG_DEBUG, "This is a level crossing command.");
             }
             levelCrossingCommand(switchCommand);
             return;
@@ -280,7 +399,7 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
         // Check if port is used to control a bascule bridge
         if (BASCULE_BRIDGE_CONNECTED && (rr_port1 == bridgeConfiguration.rocRailPort)) {
             if (DEBUG_MQTT_MESSAGES) {
-                mcLog2("This is a bascule bridge command.", LOG_DEBUG);
+                mcLogf(LOG_DEBUG, "This is a bascule bridge command.");
             }
             basculeBridgeCommand(switchCommand);
             return;
@@ -288,16 +407,13 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
 
         // Not a level crossing or a bascule bridge, so at this point we assume we received a switch command
 
-        // find switch in servoConfiguration array
+        // find switch in switchConfiguration array
         int switchIndex = -1;
-        for (int s = 0; s < NUM_SWITCHES; s++) {
-            if (switchConfiguration[s].rocRailPort == rr_port1) {
-                switchIndex = s;
-                break;
-            }
-        }
+        forEachIndexEntry(switchPortIndex, rr_port1, [&switchIndex](const TIndexEntry &entry) {
+            switchIndex = entry.index;
+        });
         if (switchIndex == -1) {
-            mcLog2("No switch for rocrail port " + String(rr_port1) + " configured - message disregarded.", LOG_ERR);
+            mcLogf(LOG_ERR, "No switch for rocrail port %d configured - message disregarded.", rr_port1);
             return;
         }
 
@@ -305,34 +421,34 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
         // defaults to SWITCHSERVO_MIN
         int rr_param1 = SWITCHSERVO_MIN;
         if (element->QueryIntAttribute("param1", &rr_param1) != XML_SUCCESS) {
-            mcLog2("Error in <sw> message: param1 attribute not found or wrong type. Using default value.", LOG_ERR);
+            mcLogf(LOG_ERR, "Error in <sw> message: param1 attribute not found or wrong type. Using default value.");
         }
         if (rr_param1 < SWITCHSERVO_MIN_ALLOWED || rr_param1 > SWITCHSERVO_MAX_ALLOWED) {
             // Reset angle back to standard if angle is out of bounds
             // User has obviously forgotten to configure servo angle in Rocrail properly
             // To protect the servo, the default value is used
-            mcLog2("Error in <sw> message: param1 attribute out of bounds. Using default value.", LOG_ERR);
+            mcLogf(LOG_ERR, "Error in <sw> message: param1 attribute out of bounds. Using default value.");
             rr_param1 = SWITCHSERVO_MIN;
         }
         if (DEBUG_MQTT_MESSAGES) {
-            mcLog2("param1: " + String(rr_param1), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "param1: %d", rr_param1);
         }
 
         // query value1 attribute. This is the "turnout" position of the switch servo motor.
         // defaults to SWITCHSERVO_MAX
         int rr_value1 = SWITCHSERVO_MAX;
         if (element->QueryIntAttribute("value1", &rr_value1) != XML_SUCCESS) {
-            mcLog2("Error in <sw> message: value1 attribute not found or wrong type. Using default value.", LOG_ERR);
+            mcLogf(LOG_ERR, "Error in <sw> message: value1 attribute not found or wrong type. Using default value.");
         }
         if (rr_value1 < SWITCHSERVO_MIN_ALLOWED || rr_value1 > SWITCHSERVO_MAX_ALLOWED) {
             // Reset angle back to standard if angle is out of bounds
             // User has obviously forgotten to configure servo angle in Rocrail properly
             // To protect the servo, the default value is used
-            mcLog2("Error in <sw> message: value1 attribute out of bounds. Using default value.", LOG_ERR);
+            mcLogf(LOG_ERR, "Error in <sw> message: value1 attribute out of bounds. Using default value.");
             rr_value1 = SWITCHSERVO_MAX;
         }
         if (DEBUG_MQTT_MESSAGES) {
-            mcLog2("value1: " + String(rr_value1), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "value1: %d", rr_value1);
         }
 
         // at this stage, all parameters are parsed and checks are completed. Time to flip a switch!
@@ -342,17 +458,17 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
 
         // flip switch
         int servoAngle = (switchCommand == 1) ? rr_param1 : rr_value1;
-        mcLog2("Flipping switch index " + String(switchIndex) + " to angle " + String(servoAngle), LOG_INFO);
-        setServoAngle(switchConfiguration[switchIndex].servoIndex, servoAngle);
+        mcLogf(LOG_INFO, "Flipping switch index %d to angle %d", switchIndex, servoAngle);
+        moveServo(switchConfiguration[switchIndex].servoIndex, servoAngle);
         // if double slip switch, a second servo might need to be switched
         if (switchConfiguration[switchIndex].servo2Index >= 0) {
             servoAngle = ((switchCommand == 1) ^ (switchConfiguration[switchIndex].servo2Reverse)) ? rr_param1 : rr_value1;
-            mcLog2("Turning 2nd servo of switch index " + String(switchIndex) + " to angle " + String(servoAngle), LOG_DEBUG);
-            setServoAngle(switchConfiguration[switchIndex].servo2Index, servoAngle);
+            mcLogf(LOG_DEBUG, "Turning 2nd servo of switch index %d to angle %d", switchIndex, servoAngle);
+            moveServo(switchConfiguration[switchIndex].servo2Index, servoAngle);
         }
 
-        // trigger virtual switch sensor on new switching side
-        sendSwitchSensorEvent(switchIndex, switchCommand, true);
+        // trigger virtual switch sensor on new switching side as soon as the switch has finished moving (see switchLoop)
+        mattzoSwitch[switchIndex].pendingCommand = switchCommand;
 
         return;
         // end of switch command handling
@@ -364,17 +480,17 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
     element = xmlDocument.FirstChildElement("co");
     if (element != NULL) {
         if (DEBUG_MQTT_MESSAGES) {
-            mcLog2("<co> node found.", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "<co> node found.");
         }
 
         // query cmd attribute. This is the transmitted signal command for the port and can either be "on" or "off".
         const char *rr_cmd = "-unknown-";
         if (element->QueryStringAttribute("cmd", &rr_cmd) != XML_SUCCESS) {
-            mcLog2("cmd attribute not found or wrong type.", LOG_ERR);
+            mcLogf(LOG_ERR, "cmd attribute not found or wrong type.");
             return;
         }
         if (DEBUG_MQTT_MESSAGES) {
-            mcLog2("cmd: " + String(rr_cmd), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "cmd: %s", rr_cmd);
         }
 
         // parse signal command
@@ -383,16 +499,16 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
             // command for signal with Rocrail control option "Default" identified (-> signal configuration, Interface tab, Control section)
             // only signal message with command 'on' will be processed
             if (DEBUG_MQTT_MESSAGES) {
-                mcLog2("Signal command received (control type 'default')", LOG_DEBUG);
+                mcLogf(LOG_DEBUG, "Signal command received (control type 'default')");
             }
         } else if (strcmp(rr_cmd, "off") == 0) {
             // disregard signal messages with command 'off'
             if (DEBUG_MQTT_MESSAGES) {
-                mcLog2("Signal command 'off' received - message disregarded.", LOG_DEBUG);
+                mcLogf(LOG_DEBUG, "Signal command 'off' received - message disregarded.");
             }
             return;
         } else {
-            mcLog2("Signal command " + String(rr_cmd) + " unknown - message disregarded.", LOG_ERR);
+            mcLogf(LOG_ERR, "Signal command %s unknown - message disregarded.", rr_cmd);
             return;
         }
 
@@ -400,15 +516,15 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
         // If this does not equal the ControllerNo of this controller, the message is disregarded.
         int rr_addr = 0;
         if (element->QueryIntAttribute("addr", &rr_addr) != XML_SUCCESS) {
-            mcLog2("addr attribute not found or wrong type. Message disregarded.", LOG_ERR);
+            mcLogf(LOG_ERR, "addr attribute not found or wrong type. Message disregarded.");
             return;
         }
         if (DEBUG_MQTT_MESSAGES) {
-            mcLog2("addr: " + String(rr_addr), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "addr: %d", rr_addr);
         }
         if (rr_addr != mattzoControllerId) {
             if (DEBUG_MQTT_MESSAGES) {
-                mcLog2("Message disgarded, as it is not for me (" + String(mattzoControllerId) + ")", LOG_ERR);
+                mcLogf(LOG_ERR, "Message disgarded, as it is not for me (%d)", mattzoControllerId);
             }
             return;
         }
@@ -417,14 +533,14 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
         // This value corresponds with the aspect of the signal for which the command is received
         int rr_port = 0;
         if (element->QueryIntAttribute("port", &rr_port) != XML_SUCCESS) {
-            mcLog2("port attribute not found or wrong type. Message disregarded.", LOG_ERR);
+            mcLogf(LOG_ERR, "port attribute not found or wrong type. Message disregarded.");
             return;
         }
         if (DEBUG_MQTT_MESSAGES) {
-            mcLog2("port: " + String(rr_port), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "port: %d", rr_port);
         }
         if (rr_port < 1) {
-            mcLog2("Message disgarded, as the transmitted signal port is below 1.", LOG_ERR);
+            mcLogf(LOG_ERR, "Message disgarded, as the transmitted signal port is below 1.");
             return;
         }
 
@@ -441,22 +557,22 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
     element = xmlDocument.FirstChildElement("sg");
     if (element != NULL) {
         if (DEBUG_MQTT_MESSAGES) {
-            mcLog2("<sg> node found.", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "<sg> node found.");
         }
 
         // query cmd attribute. This is the desired signal setting and can either be "on" or "off".
         const char *rr_cmd = "-unknown-";
         if (element->QueryStringAttribute("cmd", &rr_cmd) != XML_SUCCESS) {
-            mcLog2("cmd attribute not found or wrong type.", LOG_ERR);
+            mcLogf(LOG_ERR, "cmd attribute not found or wrong type.");
             return;
         }
         if (DEBUG_MQTT_MESSAGES) {
-            mcLog2("cmd: " + String(rr_cmd), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "cmd: %s", rr_cmd);
         }
 
         // parse signal command
         if (strcmp(rr_cmd, "aspect") != 0) {
-            mcLog2("Signal command " + String(rr_cmd) + " unknown - message disregarded.", LOG_ERR);
+            mcLogf(LOG_ERR, "Signal command %s unknown - message disregarded.", rr_cmd);
             return;
         }
 
@@ -464,15 +580,15 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
         // If this does not equal the ControllerNo of this controller, the message is disregarded.
         int rr_addr1 = 0;
         if (element->QueryIntAttribute("addr1", &rr_addr1) != XML_SUCCESS) {
-            mcLog2("addr1 attribute not found or wrong type. Message disregarded.", LOG_ERR);
+            mcLogf(LOG_ERR, "addr1 attribute not found or wrong type. Message disregarded.");
             return;
         }
         if (DEBUG_MQTT_MESSAGES) {
-            mcLog2("addr1: " + String(rr_addr1), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "addr1: %d", rr_addr1);
         }
         if (rr_addr1 != mattzoControllerId) {
             if (DEBUG_MQTT_MESSAGES) {
-                mcLog2("Message disgarded, as it is not for me (" + String(mattzoControllerId) + ")", LOG_ERR);
+                mcLogf(LOG_ERR, "Message disgarded, as it is not for me (%d)", mattzoControllerId);
             }
             return;
         }
@@ -481,25 +597,25 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
         // If the controller does not have a signal with this port, the message is disregarded.
         int rr_port1 = 0;
         if (element->QueryIntAttribute("port1", &rr_port1) != XML_SUCCESS) {
-            mcLog2("port1 attribute not found or wrong type. Message disregarded.", LOG_ERR);
+            mcLogf(LOG_ERR, "port1 attribute not found or wrong type. Message disregarded.");
             return;
         }
         if (DEBUG_MQTT_MESSAGES) {
-            mcLog2("port1: " + String(rr_port1), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "port1: %d", rr_port1);
         }
         if (rr_port1 < 1) {
-            mcLog2("Message disgarded, as the transmitted signal port is below 1.", LOG_ERR);
+            mcLogf(LOG_ERR, "Message disgarded, as the transmitted signal port is below 1.");
             return;
         }
 
         // query aspect attribute. This is requested aspect for the signal.
         int rr_aspect = 0;
         if (element->QueryIntAttribute("aspect", &rr_aspect) != XML_SUCCESS) {
-            mcLog2("Aspect attribute expected, but not found or wrong type. Message disregarded.", LOG_ERR);
+            mcLogf(LOG_ERR, "Aspect attribute expected, but not found or wrong type. Message disregarded.");
             return;
         }
         if (DEBUG_MQTT_MESSAGES) {
-            mcLog2("aspect: " + String(rr_aspect), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "aspect: %d", rr_aspect);
         }
 
         // Find the signal and switch it to the requested aspect
@@ -516,23 +632,23 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
         element = xmlDocument.FirstChildElement("fb");
         if (element != NULL) {
             if (DEBUG_MQTT_MESSAGES) {
-                mcLog2("<fb> node found.", LOG_DEBUG);
+                mcLogf(LOG_DEBUG, "<fb> node found.");
             }
 
             // query bus attribute. This MattzoControllerId to which the sensor is connected
             // If the bus attribute is not found, the message is discarded.
             int rr_bus = 0;
             if (element->QueryIntAttribute("bus", &rr_bus) != XML_SUCCESS) {
-                mcLog2("bus attribute not found or wrong type. Message disregarded.", LOG_ERR);
+                mcLogf(LOG_ERR, "bus attribute not found or wrong type. Message disregarded.");
                 return;
             }
             if (DEBUG_MQTT_MESSAGES) {
-                mcLog2("bus: " + String(rr_bus), LOG_DEBUG);
+                mcLogf(LOG_DEBUG, "bus: %d", rr_bus);
             }
             // If the received MattzoControllerId equals the Id of this controller, the message is discarded as it was originated by this controller in the first place.
             if (rr_bus == mattzoControllerId) {
                 if (DEBUG_MQTT_MESSAGES) {
-                    mcLog2("Message disregarded as it was originated by this controller.", LOG_DEBUG);
+                    mcLogf(LOG_DEBUG, "Message disregarded as it was originated by this controller.");
                 }
                 return;
             }
@@ -541,21 +657,21 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
             // If this does not equal the ControllerNo of this controller, the message is disregarded.
             int rr_addr = 0;
             if (element->QueryIntAttribute("addr", &rr_addr) != XML_SUCCESS) {
-                mcLog2("addr attribute not found or wrong type. Message disregarded.", LOG_ERR);
+                mcLogf(LOG_ERR, "addr attribute not found or wrong type. Message disregarded.");
                 return;
             }
             if (DEBUG_MQTT_MESSAGES) {
-                mcLog2("addr: " + String(rr_addr), LOG_DEBUG);
+                mcLogf(LOG_DEBUG, "addr: %d", rr_addr);
             }
 
             // query state attribute. This is the sensor state and can either be "true" (triggered) or "false" (not triggered).
             const char *rr_state = "xXxXx";
             if (element->QueryStringAttribute("state", &rr_state) != XML_SUCCESS) {
-                mcLog2("state attribute not found or wrong type.", LOG_ERR);
+                mcLogf(LOG_ERR, "state attribute not found or wrong type.");
                 return;
             }
             if (DEBUG_MQTT_MESSAGES) {
-                mcLog2("state: " + String(rr_state), LOG_DEBUG);
+                mcLogf(LOG_DEBUG, "state: %s", rr_state);
             }
             bool sensorState = strcmp(rr_state, "true") == 0;
 
@@ -568,7 +684,7 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
     }
 
     if (DEBUG_MQTT_MESSAGES) {
-        mcLog2("Unhandled message type. Message disregarded.", LOG_DEBUG);
+        mcLogf(LOG_DEBUG, "Unhandled message type. Message disregarded.");
     }
 }
 
@@ -579,17 +695,13 @@ void handleSignalMessageControlTypeDefault(int rr_port)
     if (rr_port < 1)
         return;
 
-    for (int s = 0; s < NUM_SIGNALS; s++) {
-        for (int a = 0; a < NUM_SIGNAL_ASPECTS; a++) {
-            if (signalConfiguration[s].aspectRocrailPort[a] == rr_port) {
-                // found the aspect that corresponds with rr_port
-                // -> set aspect a for signal s
+    forEachIndexEntry(signalAspectPortIndex, rr_port, [rr_port](const TIndexEntry &entry) {
+        // found the aspect that corresponds with rr_port
+        // -> set aspect for signal
 
-                mcLog2("Aspect " + String(a) + " of signal index " + String(s) + " maps with rr port " + String(rr_port), LOG_DEBUG);
-                setSignalAspect(s, a);
-            }
-        }
-    }
+        mcLogf(LOG_DEBUG, "Aspect %d of signal index %d maps with rr port %d", entry.aspect, entry.index, rr_port);
+        setSignalAspect(entry.index, entry.aspect);
+    });
 }
 
 // handles a signal mesage that was received from Rocrail
@@ -598,15 +710,13 @@ void handleSignalMessageControlTypeAspectNumbers(int rr_port1, int a) {
     if (rr_port1 < 1)
         return;
 
-    for (int s = 0; s < NUM_SIGNALS; s++) {
-        if (signalConfiguration[s].signalRocrailPort == rr_port1) {
-            // signal s has rr_port1
-            // -> set aspect a for signal s
+    forEachIndexEntry(signalPortIndex, rr_port1, [rr_port1, a](const TIndexEntry &entry) {
+        // signal has rr_port1
+        // -> set aspect a for signal
 
-            mcLog2("Signal index " + String(s) + " maps with rr port " + String(rr_port1), LOG_DEBUG);
-            setSignalAspect(s, a);
-        }
-    }
+        mcLogf(LOG_DEBUG, "Signal index %d maps with rr port %d", entry.index, rr_port1);
+        setSignalAspect(entry.index, a);
+    });
 
 }
 
@@ -619,7 +729,7 @@ void initializeAllSignals() {
 
 // set signal index s to aspect index a
 void setSignalAspect(int s, int a) {
-    mcLog2("Setting signal index " + String(s) + " to aspect " + String(a), LOG_INFO);
+    mcLogf(LOG_INFO, "Setting signal index %d to aspect %d", s, a);
 
     if (mattzoSignal[s].currentAspect != a) {
         mattzoSignal[s].aspectActiveSince_ms = millis();
@@ -630,7 +740,7 @@ void setSignalAspect(int s, int a) {
     for (int l = 0; l < NUM_SIGNAL_LEDS; l++) {
         if (signalConfiguration[s].aspectLEDPort[a] >= 0) {
             int8_t ledLightAction = signalConfiguration[s].aspectLEDMapping[a][l];
-            mcLog2("Setting signal LED index " + String(l) + " of signal " + String(s) + " to light action " + String(ledLightAction), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "Setting signal LED index %d of signal %d to light action %d", l, s, ledLightAction);
         }
     }
 
@@ -639,8 +749,8 @@ void setSignalAspect(int s, int a) {
         // skip servo if servo pin < 0 (this means "not used")
         if (signalConfiguration[s].servoIndex[servoIndex] >= 0) {
             int servoAngle = signalConfiguration[s].aspectServoAngle[servoIndex][a];
-            mcLog2("Turning servo index " + String(servoIndex) + " of signal " + String(s) + " to " + String(servoAngle), LOG_DEBUG);
-            setServoAngle(signalConfiguration[s].servoIndex[servoIndex], servoAngle);
+            mcLogf(LOG_DEBUG, "Turning servo index %d of signal %d to %d", servoIndex, s, servoAngle);
+            moveServo(signalConfiguration[s].servoIndex[servoIndex], servoAngle);
         }
     }
 }
@@ -680,7 +790,7 @@ void signalLoop() {
                         ledState = !flashActive;
                         break;
                 }
-                // mcLog2("> Setting signal " + String(s) + ", led index " + String(l) + " to state " + String(ledState), LOG_DEBUG);
+                // mcLogf(LOG_DEBUG, "> Setting signal %d, led index %d to state %d", s, l, ledState);
                 setLED(ledPort, ledState);
             }
         }
@@ -691,21 +801,21 @@ void handleSignalOvershootSensorEvent(int overshootSensorIndex) {
     for (int s = 0; s < NUM_SIGNALS; s++)
     {
         if (signalConfiguration[s].overshootSensorIndex == overshootSensorIndex) {
-            mcLog2("Sensor " + String(overshootSensorIndex) + " is an overshoot sensor for signal " + String(s) + "!", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "Sensor %d is an overshoot sensor for signal %d!", overshootSensorIndex, s);
 
             // Check if the signal is red
             if (mattzoSignal[s].currentAspect == 0) {
                 // Check if overshoot sensor is still sleeping
                 if (millis() > mattzoSignal[s].aspectActiveSince_ms + SIGNAL_OVERSHOOT_SENSOR_SLEEP_MS) {
                     // Pull emergency break
-                    mcLog2(": Overshoot sensor engaged!", LOG_CRIT);
+                    mcLogf(LOG_CRIT, ": Overshoot sensor engaged!");
                     sendEmergencyBrake2MQTT("Overshoot sensor of signal " + String(s) + " triggered");
                     return;
                 } else {
-                    mcLog2(": Overshoot sensor not engaged (signal is red, but within allowed time period).", LOG_DEBUG);
+                    mcLogf(LOG_DEBUG, ": Overshoot sensor not engaged (signal is red, but within allowed time period).");
                 }
             } else {
-                mcLog2(": Overshoot sensor not engaged (signal is not red).", LOG_DEBUG);
+                mcLogf(LOG_DEBUG, ": Overshoot sensor not engaged (signal is not red).");
             }
         }
     }
@@ -716,7 +826,7 @@ void sendSensorEvent2MQTT(int sensorIndex, bool sensorState)
     int sensorPort = sensorIndex + 1;
 
     if (sensorPort < 0) {
-        mcLog2("Sensor message skipped (sensorPort = " + String(sensorPort) + ")", LOG_DEBUG);
+        mcLogf(LOG_DEBUG, "Sensor message skipped (sensorPort = %d)", sensorPort);
         return;
     }
 
@@ -729,7 +839,7 @@ void sendSensorEvent2MQTT(int sensorIndex, bool sensorState)
     //   address: port number (internal port number plus 1)
     // both id or bus/address can be used in Rocrail. If id is used, it superseeds the combination of bus and address
     String mqttMessage = "<fb id=\"" + sensorRocId + "\" bus=\"" + String(mattzoControllerId) + "\" addr=\"" + String(sensorPort) + "\" state=\"" + stateString + "\"/>";
-    mcLog2("Sending MQTT message: " + mqttMessage, LOG_DEBUG);
+    mcLogf(LOG_DEBUG, "Sending MQTT message: %s", mqttMessage.c_str());
     char mqttMessage_char[255]; // message is usually 61 chars, so 255 chars should be enough
     mqttMessage.toCharArray(mqttMessage_char, mqttMessage.length() + 1);
     mqttClient.publish("rocrail/service/client", mqttMessage_char);
@@ -738,7 +848,7 @@ void sendSensorEvent2MQTT(int sensorIndex, bool sensorState)
 void sendEmergencyBrake2MQTT(String emergencyBrakeReason)
 {
     String mqttMessage = "<sys cmd=\"ebreak\" reason=\"" + emergencyBrakeReason + "\"/>";
-    mcLog2("Sending emergency brake message via MQTT: " + mqttMessage, LOG_ERR);
+    mcLogf(LOG_ERR, "Sending emergency brake message via MQTT: %s", mqttMessage.c_str());
     char mqttMessage_char[255]; // message with reason "bridge open" is 44 chars, so 255 chars should be enough
     mqttMessage.toCharArray(mqttMessage_char, mqttMessage.length() + 1);
     mqttClient.publish("rocrail/service/client", mqttMessage_char);
@@ -761,8 +871,94 @@ bool isPhysicalSensor(int sensorIndex) {
     return sensorConfiguration[sensorIndex].pinType == LOCAL_SENSOR_PIN_TYPE || sensorConfiguration[sensorIndex].pinType >= MCP23017_SENSOR_PIN_TYPE;
 }
 
+// Records an edge of a local sensor (interrupt handler)
+void IRAM_ATTR handleSensorEdge(void *sensorIndex)
+{
+    uint8_t head = sensorEdgeHead;
+    if ((uint8_t)(head - sensorEdgeTail) >= SENSOR_EDGE_BUFFER_SIZE) {
+        // buffer full, the loop will still see the current pin level
+        sensorEdgesDropped++;
+        return;
+    }
+
+    SensorEdge &edge = sensorEdges[head & (SENSOR_EDGE_BUFFER_SIZE - 1)];
+    edge.sensorIndex = (intptr_t)sensorIndex;
+    edge.level = digitalRead(sensorConfiguration[edge.sensorIndex].pin);
+    edge.time_us = micros();
+
+    // publish the edge only after it has been written
+    std::atomic_signal_fence(std::memory_order_release);
+    sensorEdgeHead = head + 1;
+}
+
+// Handles the edges of local sensors recorded since the last loop pass
+// Contacts are reported with the time of the edge, so contacts shorter than a loop pass are not missed.
+void processSensorEdges()
+{
+    // edges recorded while processing these are handled in the next loop pass
+    uint8_t head = sensorEdgeHead;
+    std::atomic_signal_fence(std::memory_order_acquire);
+
+    while (sensorEdgeTail != head) {
+        SensorEdge edge = sensorEdges[sensorEdgeTail & (SENSOR_EDGE_BUFFER_SIZE - 1)];
+
+        // free the slot only after the edge has been copied
+        std::atomic_signal_fence(std::memory_order_release);
+        sensorEdgeTail = sensorEdgeTail + 1;
+
+        if (edge.level == sensorTriggerState[edge.sensorIndex]) {
+            handleSensorContact(edge.sensorIndex, edge.time_us);
+        } else if (edge.level == sensorEdgeLevel[edge.sensorIndex]) {
+            // two edges, but the level did not change: the contact was already over when the interrupt handler read the pin
+            handleSensorContact(edge.sensorIndex, edge.time_us);
+        } else {
+            // the contact lasted until this edge, so the release timeout starts here (bouncing contacts are filtered by SENSOR_RELEASE_TICKS_MS)
+            lastSensorContact_ms[edge.sensorIndex] = millis() - (micros() - edge.time_us) / 1000;
+        }
+        sensorEdgeLevel[edge.sensorIndex] = edge.level;
+    }
+
+    if (sensorEdgesDropped > 0) {
+        // the interrupt handler may count another edge while we reset the counter
+        noInterrupts();
+        unsigned int dropped = sensorEdgesDropped;
+        sensorEdgesDropped = 0;
+        interrupts();
+        mcLogf(LOG_WARNING, "Sensor edge buffer full, %u edges dropped.", dropped);
+
+        // resynchronize with the pins, so the missing edges are not mistaken for short contacts
+        for (int i = 0; i < NUM_SENSORS; i++) {
+            if (sensorConfiguration[i].pinType == LOCAL_SENSOR_PIN_TYPE) {
+                sensorEdgeLevel[i] = digitalRead(sensorConfiguration[i].pin);
+            }
+        }
+    }
+}
+
+// Handles a contact of a physical sensor at the given time (micros())
+void handleSensorContact(int sensorIndex, unsigned long contact_us)
+{
+    if (!sensorState[sensorIndex]) {
+        mcLogf(LOG_INFO, "Sensor %d triggered.", sensorIndex);
+        sensorState[sensorIndex] = true;
+        sendSensorEvent2MQTT(sensorIndex, true);
+        handleSpeedometerSensorEvent(sensorIndex, contact_us);
+        handleSignalOvershootSensorEvent(sensorIndex);
+        handleLevelCrossingSensorEvent(sensorIndex);
+    }
+    lastSensorContact_ms[sensorIndex] = millis() - (micros() - contact_us) / 1000;
+}
+
 void monitorSensors()
 {
+    unsigned long scanStart_us = micros();
+
+    processSensorEdges();
+
+#if USE_MCP23017
+    readMCP23017Sensors();
+#endif
+
     for (int i = 0; i < NUM_SENSORS; i++) {
         // monitor local sensors
         if (isPhysicalSensor(i)) {
@@ -775,25 +971,17 @@ void monitorSensors()
             else if (sensorConfiguration[i].pinType >= MCP23017_SENSOR_PIN_TYPE && sensorConfiguration[i].pinType < 0x40) {
                 // sensor connected to MCP23017
                 int m = sensorConfiguration[i].pinType - MCP23017_SENSOR_PIN_TYPE; // index of the MCP23017
-                sensorValue = mcp23017[m].digitalRead(sensorConfiguration[i].pin);
+                sensorValue = (mcp23017Inputs[m] >> sensorConfiguration[i].pin) & 1;
             }
 #endif
 
             if (sensorValue == sensorTriggerState[i]) {
                 // Contact -> report contact immediately
-                if (!sensorState[i]) {
-                    mcLog2("Sensor " + String(i) + " triggered.", LOG_INFO);
-                    sensorState[i] = true;
-                    sendSensorEvent2MQTT(i, true);
-                    handleSpeedometerSensorEvent(i);
-                    handleSignalOvershootSensorEvent(i);
-                    handleLevelCrossingSensorEvent(i);
-                }
-                lastSensorContact_ms[i] = millis();
+                handleSensorContact(i, micros());
             } else {
                 // No contact for SENSOR_RELEASE_TICKS_MS milliseconds -> report sensor has lost contact
                 if (sensorState[i] && (millis() > lastSensorContact_ms[i] + SENSOR_RELEASE_TICKS_MS)) {
-                    mcLog2("Sensor " + String(i) + " released.", LOG_INFO);
+                    mcLogf(LOG_INFO, "Sensor %d released.", i);
                     sensorState[i] = false;
                     sendSensorEvent2MQTT(i, false);
                 }
@@ -802,63 +990,149 @@ void monitorSensors()
     }
 
     setLEDBySensorStates();
+
+    loopStatistics.sensorScanTime_us += micros() - scanStart_us;
 }
 
 // handle a remote sensor event.
 // remote sensor events are used for level crossings in Autonomous Mode
 void handleRemoteSensorEvent(int mcId, int sensorAddress, bool sensorState)
 {
-    mcLog2("Checking for remote sensor " + String(mcId) + "-" + String(sensorAddress), LOG_DEBUG);
+    mcLogf(LOG_DEBUG, "Checking for remote sensor %d-%d", mcId, sensorAddress);
 
     // find sensor in sensor array
     // if found, handle level crossing sensor event
-    for (int s = 0; s < NUM_SENSORS; s++) {
-        if (sensorConfiguration[s].pinType == REMOTE_SENSOR_PIN_TYPE) {
-            if (sensorConfiguration[s].remoteMattzoControllerId == mcId) {
-                if (sensorConfiguration[s].pin == sensorAddress) {
-                    if (sensorState) {
-                        mcLog2("Remote sensor " + String(mcId) + "-" + String(sensorAddress) + " triggered.", LOG_INFO);
-                        handleSignalOvershootSensorEvent(s);
-                        handleLevelCrossingSensorEvent(s);
-                    }
-                    return;
-                }
-            }
-        }
+    int32_t key = remoteSensorKey(mcId, sensorAddress);
+    if (key < 0) {
+        return;
     }
+
+    forEachIndexEntry(remoteSensorIndex, key, [mcId, sensorAddress, sensorState](const TIndexEntry &entry) {
+        if (sensorState) {
+            mcLogf(LOG_INFO, "Remote sensor %d-%d triggered.", mcId, sensorAddress);
+            handleSignalOvershootSensorEvent(entry.index);
+            handleLevelCrossingSensorEvent(entry.index);
+        }
+    });
 }
 
-// sets the servo arm to a desired angle
+// sets the servo arm to a desired angle immediately
+// A movement started by moveServo() is stopped.
 void setServoAngle(int servoIndex, int servoAngle)
 {
-    mcLog2("Turning servo index " + String(servoIndex) + " to angle " + String(servoAngle), LOG_DEBUG);
     if (servoIndex >= 0 && servoIndex < NUM_SERVOS) {
-        if (servoConfiguration[servoIndex].pinType == 0) {
-            if (!mattzoServo[servoIndex].isAttached) {
-                mcLog2("Attaching servo index " + String(servoIndex), LOG_DEBUG);
-                mattzoServo[servoIndex].servo.attach(servoConfiguration[servoIndex].pin);
+        mattzoServo[servoIndex].isMoving = false;
+        writeServoAngle(servoIndex, servoAngle);
+    } else {
+        // this should not happen
+        mcLogf(LOG_ALERT, "WARNING: servo index %d out of range!", servoIndex);
+    }
+}
+
+// starts moving the servo arm to a desired angle at the speed and with the easing profile configured for the servo
+// The movement is carried out by servoLoop(). If the present angle of the servo is unknown, the servo is set to the angle immediately.
+void moveServo(int servoIndex, int servoAngle)
+{
+    if (servoIndex < 0 || servoIndex >= NUM_SERVOS) {
+        // this should not happen
+        mcLogf(LOG_ALERT, "WARNING: servo index %d out of range!", servoIndex);
+        return;
+    }
+
+    MattzoServo &s = mattzoServo[servoIndex];
+    if (s.angle < 0) {
+        setServoAngle(servoIndex, servoAngle);
+        return;
+    }
+
+    // start from the present angle (which may be in the middle of another movement)
+    int speed = servoConfiguration[servoIndex].speed > 0 ? servoConfiguration[servoIndex].speed : SERVO_DEFAULT_SPEED;
+    s.startAngle = s.angle;
+    s.targetAngle = servoAngle;
+    s.moveStart_ms = millis();
+    s.moveDuration_ms = (unsigned long)abs(servoAngle - s.angle) * 1000 / speed;
+    s.isMoving = true;
+    mcLogf(LOG_DEBUG, "Moving servo index %d from angle %d to %d in %lu ms", servoIndex, s.startAngle, s.targetAngle, s.moveDuration_ms);
+}
+
+// returns true if a movement started by moveServo() is still in progress
+bool isServoMoving(int servoIndex)
+{
+    return servoIndex >= 0 && servoIndex < NUM_SERVOS && mattzoServo[servoIndex].isMoving;
+}
+
+// carries out the movements started by moveServo()
+// The angle follows from the time elapsed since the start of the movement, so the duration of a movement does not depend on the loop time.
+void servoLoop()
+{
+    for (int servoIndex = 0; servoIndex < NUM_SERVOS; servoIndex++) {
+        MattzoServo &s = mattzoServo[servoIndex];
+        if (!s.isMoving) {
+            continue;
+        }
+
+        unsigned long elapsed_ms = millis() - s.moveStart_ms;
+        int angle = s.targetAngle;
+        if (elapsed_ms < s.moveDuration_ms) {
+            float progress = (float)elapsed_ms / s.moveDuration_ms;
+            if (servoConfiguration[servoIndex].easing == ServoEasing::EASE_IN_OUT) {
+                progress = progress * progress * (3 - 2 * progress);
             }
-            mattzoServo[servoIndex].servo.write(servoAngle);
+            angle = s.startAngle + (int)lroundf((s.targetAngle - s.startAngle) * progress);
+        } else {
+            s.isMoving = false;
+            mcLogf(LOG_DEBUG, "Servo index %d reached angle %d", servoIndex, s.targetAngle);
         }
-#if USE_PCA9685
-        else if (servoConfiguration[servoIndex].pinType >= 0x40) {
-            setPCA9685SleepMode(false);
-            mcLog2("Attaching servo index " + String(servoIndex) + " to PCA9685 PWM signal.", LOG_DEBUG);
-            pca9685[servoConfiguration[servoIndex].pinType - 0x40].setPWM(servoConfiguration[servoIndex].pin, 0, mapAngle2PulseLength(servoAngle));
+
+        // the servo only needs to be written if its angle changes
+        if (angle != s.angle || !s.isAttached) {
+            writeServoAngle(servoIndex, angle);
         }
-#endif
-        else {
-            // this should not happen
-            mcLog2("WARNING: servo index " + String(servoIndex) + " unknown pinType " + String(servoConfiguration[servoIndex].pinType), LOG_ALERT);
+    }
+}
+
+// sends the feedback of switches whose servos have finished moving
+void switchLoop()
+{
+    for (int switchIndex = 0; switchIndex < NUM_SWITCHES; switchIndex++) {
+        if (mattzoSwitch[switchIndex].pendingCommand >= 0 && !isServoMoving(switchConfiguration[switchIndex].servoIndex) && !isServoMoving(switchConfiguration[switchIndex].servo2Index)) {
+            // trigger virtual switch sensor on new switching side
+            sendSwitchSensorEvent(switchIndex, mattzoSwitch[switchIndex].pendingCommand, true);
+            mattzoSwitch[switchIndex].pendingCommand = -1;
         }
+    }
+}
 
-        // Set values required for later servo detaching (power off)
-        mattzoServo[servoIndex].lastSwitchingAction_ms = millis();
-        mattzoServo[servoIndex].isAttached = true;
-    } else {
+// writes an angle to the servo
+void writeServoAngle(int servoIndex, int servoAngle)
+{
+    if (servoConfiguration[servoIndex].pinType == 0) {
+        if (!mattzoServo[servoIndex].isAttached) {
+            mcLogf(LOG_DEBUG, "Attaching servo index %d", servoIndex);
+            mattzoServo[servoIndex].servo.attach(servoConfiguration[servoIndex].pin);
+        }
+        mattzoServo[servoIndex].servo.write(servoAngle);
+    }
+#if USE_PCA9685
+    else if (servoConfiguration[servoIndex].pinType >= 0x40) {
+        setPCA9685SleepMode(false);
+        if (!mattzoServo[servoIndex].isAttached) {
+            mcLogf(LOG_DEBUG, "Attaching servo index %d to PCA9685 PWM signal.", servoIndex);
+        }
+        pca9685[servoConfiguration[servoIndex].pinType - 0x40].setPWM(servoConfiguration[servoIndex].pin, 0, mapAngle2PulseLength(servoAngle));
+        loopStatistics.i2cTransactions++;
+    }
+#endif
+    else {
         // this should not happen
-        mcLog2("WARNING: servo index " + String(servoIndex) + " out of range!", LOG_ALERT);
+        mcLogf(LOG_ALERT, "WARNING: servo index %d unknown pinType %d", servoIndex, servoConfiguration[servoIndex].pinType);
     }
+
+    // Set values required for later servo detaching (power off)
+    mattzoServo[servoIndex].lastSwitchingAction_ms = millis();
+    mattzoServo[servoIndex].isAttached = true;
+    mattzoServo[servoIndex].detachState = ServoDetachState::NONE;
+    mattzoServo[servoIndex].angle = servoAngle;
 }
 
 // converts a desired servo angle (0 .. 180 degrees) into a pwm pulse length (required for PCA9685)
@@ -877,14 +1151,14 @@ void setPCA9685SleepMode(bool onOff)
     if (PCA9685_OE_PIN_INSTALLED) {
         if (onOff && !pca9685SleepMode) {
             // power down PCA9685
-            mcLog2("PCA9685 OE pin power off.", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "PCA9685 OE pin power off.");
         } else if (!onOff) {
             if (pca9685SleepMode) {
                 // power up PCA9685
-                mcLog2("PCA9685 OE pin power on, sleep mode timer set to " + String(PCA9685_POWER_OFF_AFTER_MS) + " ms.", LOG_DEBUG);
+                mcLogf(LOG_DEBUG, "PCA9685 OE pin power on, sleep mode timer set to %d ms.", PCA9685_POWER_OFF_AFTER_MS);
             } else {
                 // PCA9685 is presently powered up, just reset sleep mode timer
-                // mcLog2("PCA9685 OE pin is still powered on, resetting sleep mode timer.", LOG_DEBUG);
+                // mcLogf(LOG_DEBUG, "PCA9685 OE pin is still powered on, resetting sleep mode timer.");
             }
             pca9685SleepModeFrom_ms = millis() + PCA9685_POWER_OFF_AFTER_MS;
         }
@@ -894,34 +1168,48 @@ void setPCA9685SleepMode(bool onOff)
     }
 }
 
+// Detaches a directly connected servo while its PWM signal is low, so the last pulse is not cut short
+// Instead of waiting for the signal, it is sampled once per call: first for a pulse (HIGH), then for the gap after it (LOW).
+// After MAX_WAIT_FOR_LOW_MS, any LOW sample will do.
+void checkDetachServo(int servoIndex)
+{
+    MattzoServo &s = mattzoServo[servoIndex];
+    int pwmSignal = digitalRead(servoConfiguration[servoIndex].pin);
+
+    if (s.detachState == ServoDetachState::NONE) {
+        s.detachState = ServoDetachState::WAIT_FOR_HIGH;
+        s.detachStart_ms = millis();
+    }
+
+    if (s.detachState == ServoDetachState::WAIT_FOR_HIGH && pwmSignal == HIGH) {
+        s.detachState = ServoDetachState::WAIT_FOR_LOW;
+    } else if (pwmSignal == LOW && (s.detachState == ServoDetachState::WAIT_FOR_LOW || millis() - s.detachStart_ms >= MAX_WAIT_FOR_LOW_MS)) {
+        // detach the servo NOW!
+        s.servo.detach();
+        s.isAttached = false;
+        s.detachState = ServoDetachState::NONE;
+        mcLogf(LOG_DEBUG, "Detached servo index %d, waited %lu ms for low PWM signal.", servoIndex, millis() - s.detachStart_ms);
+    }
+}
+
 void checkEnableServoSleepMode()
 {
     for (int servoIndex = 0; servoIndex < NUM_SERVOS; servoIndex++) {
         // Check if servo shall be detached after usage, if it is active and if it's time to detach it
-        if (servoConfiguration[servoIndex].detachAfterUsage && mattzoServo[servoIndex].isAttached && (millis() >= mattzoServo[servoIndex].lastSwitchingAction_ms + SERVO_DETACH_DELAY)) {
+        if (servoConfiguration[servoIndex].detachAfterUsage && mattzoServo[servoIndex].isAttached && !mattzoServo[servoIndex].isMoving && (millis() >= mattzoServo[servoIndex].lastSwitchingAction_ms + SERVO_DETACH_DELAY)) {
 
             // Detach directly connected servo
             if (servoConfiguration[servoIndex].pinType == 0) {
-                // wait for a LOW PWM signal
-                unsigned long startWaitForLow_ms = millis();
-                // begin by waiting for a HIGH PWM signal
-                while (digitalRead(servoConfiguration[servoIndex].pin) == LOW && millis() - startWaitForLow_ms < MAX_WAIT_FOR_LOW_MS) {
-                }
-                // now wait for a LOW PWM signal
-                while (digitalRead(servoConfiguration[servoIndex].pin) == HIGH && millis() - startWaitForLow_ms < MAX_WAIT_FOR_LOW_MS) {
-                }
-                // detach the servo NOW!
-                mattzoServo[servoIndex].servo.detach();
-                mattzoServo[servoIndex].isAttached = false;
-                mcLog2("Detached servo index " + String(servoIndex) + ", waited " + String(millis() - startWaitForLow_ms) + " ms for low PWM signal.", LOG_DEBUG);
+                checkDetachServo(servoIndex);
             }
 
 #if USE_PCA9685
             // Switch off PWM signal for servo connected via PCA9685
             else if (servoConfiguration[servoIndex].pinType >= 0x40) {
                 pca9685[servoConfiguration[servoIndex].pinType - 0x40].setPWM(servoConfiguration[servoIndex].pin, 0, 4096);
+                loopStatistics.i2cTransactions++;
                 mattzoServo[servoIndex].isAttached = false;
-                mcLog2("Detached servo index " + String(servoIndex) + " from PCA9685 PWM signal.", LOG_DEBUG);
+                mcLogf(LOG_DEBUG, "Detached servo index %d from PCA9685 PWM signal.", servoIndex);
             }
 #endif
         }
@@ -938,19 +1226,19 @@ void sendSwitchSensorEvent(int switchIndex, int switchCommand, bool sensorState)
 {
     if (switchIndex < 0 || switchIndex > NUM_SWITCHES) {
         // This should never happen
-        mcLog2("sendSwitchSensorEvent() received switchIndex out of bounds: " + String(switchIndex), LOG_CRIT);
+        mcLogf(LOG_CRIT, "sendSwitchSensorEvent() received switchIndex out of bounds: %d", switchIndex);
         return;
     }
 
     if (switchCommand < 0 || switchCommand > 1) {
         // This should never happen
-        mcLog2("sendSwitchSensorEvent() received switchCommand out of bounds: " + String(switchCommand), LOG_CRIT);
+        mcLogf(LOG_CRIT, "sendSwitchSensorEvent() received switchCommand out of bounds: %d", switchCommand);
         return;
     }
 
     if (switchConfiguration[switchIndex].triggerSensors) {
         int sensorIndex = switchConfiguration[switchIndex].sensorIndex[1 - switchCommand];
-        mcLog2("Sending switch sensor event for switch index=" + String(switchIndex) + ", rocrailPort=" + String(switchConfiguration[switchIndex].rocRailPort) + ", switchCommand=" + String(switchCommand) + ", sensorState=" + String(sensorState), LOG_DEBUG);
+        mcLogf(LOG_DEBUG, "Sending switch sensor event for switch index=%d, rocrailPort=%d, switchCommand=%d, sensorState=%d", switchIndex, switchConfiguration[switchIndex].rocRailPort, switchCommand, sensorState);
         sendSensorEvent2MQTT(sensorIndex, sensorState);
     }
 }
@@ -961,7 +1249,7 @@ void setLED(int ledIndex, bool ledState)
     if (ledIndex < 0)
         return;
 
-    // mcLog2("Setting led index " + String(ledIndex) + " to " + (ledState ? "on" : "off"), LOG_DEBUG);
+    // mcLogf(LOG_DEBUG, "Setting led index %d to %s", ledIndex, ledState ? "on" : "off");
 
     if (ledConfiguration[ledIndex].pinType == 0) {
         digitalWrite(ledConfiguration[ledIndex].pin, ledState ? LOW : HIGH);
@@ -971,14 +1259,14 @@ void setLED(int ledIndex, bool ledState)
         // LED connected to PCA9685
         if (ledState) {
             // full bright
-            pca9685[ledConfiguration[ledIndex].pinType - 0x40].setPWM(ledConfiguration[ledIndex].pin, 4096, 0);
+            setPCA9685LED(ledConfiguration[ledIndex].pinType - 0x40, ledConfiguration[ledIndex].pin, 4096);
             // half bright (strongly dimmed)
-            // pca9685[ledConfiguration[ledIndex].pinType - 0x40].setPWM(ledConfiguration[ledIndex].pin, 0, 2048);
+            // setPCA9685LED(ledConfiguration[ledIndex].pinType - 0x40, ledConfiguration[ledIndex].pin, 2048);
             // 3/4 bright (slightly dimmed)
-            // pca9685[ledConfiguration[ledIndex].pinType - 0x40].setPWM(ledConfiguration[ledIndex].pin, 0, 3072);
+            // setPCA9685LED(ledConfiguration[ledIndex].pinType - 0x40, ledConfiguration[ledIndex].pin, 3072);
         } else {
             // off
-            pca9685[ledConfiguration[ledIndex].pinType - 0x40].setPWM(ledConfiguration[ledIndex].pin, 0, 4096);
+            setPCA9685LED(ledConfiguration[ledIndex].pinType - 0x40, ledConfiguration[ledIndex].pin, 0);
         }
     }
 #endif
@@ -986,7 +1274,7 @@ void setLED(int ledIndex, bool ledState)
     else if (ledConfiguration[ledIndex].pinType >= MCP23017_SENSOR_PIN_TYPE && ledConfiguration[ledIndex].pinType < 0x40) {
         // LED connected to MCP23017
         int m = ledConfiguration[ledIndex].pinType - MCP23017_SENSOR_PIN_TYPE; // index of the MCP23017
-        mcp23017[m].digitalWrite(ledConfiguration[ledIndex].pin, ledState ? LOW : HIGH);
+        setMCP23017Output(m, ledConfiguration[ledIndex].pin, ledState ? LOW : HIGH);
     }
 #endif
 }
@@ -1006,13 +1294,13 @@ void fadeLED(int ledIndex, int brightness)
     else if (ledConfiguration[ledIndex].pinType >= 0x40) {
         if (brightness == 1023) {
             // full bright
-            pca9685[ledConfiguration[ledIndex].pinType - 0x40].setPWM(ledConfiguration[ledIndex].pin, 0, 4096);
+            setPCA9685LED(ledConfiguration[ledIndex].pinType - 0x40, ledConfiguration[ledIndex].pin, 0);
         } else if (brightness == 0) {
             // off
-            pca9685[ledConfiguration[ledIndex].pinType - 0x40].setPWM(ledConfiguration[ledIndex].pin, 4096, 0);
+            setPCA9685LED(ledConfiguration[ledIndex].pinType - 0x40, ledConfiguration[ledIndex].pin, 4096);
         } else {
             // some other brightness value
-            pca9685[ledConfiguration[ledIndex].pinType - 0x40].setPWM(ledConfiguration[ledIndex].pin, 0, 4096 - brightness * 4);
+            setPCA9685LED(ledConfiguration[ledIndex].pinType - 0x40, ledConfiguration[ledIndex].pin, 4096 - brightness * 4);
         }
     }
 #endif
@@ -1021,7 +1309,76 @@ void fadeLED(int ledIndex, int brightness)
         // LED connected to MCP23017
         // The MCP23017 does not support analog output. If brightness is above 512, switch LED on, else off.
         int m = ledConfiguration[ledIndex].pinType - MCP23017_SENSOR_PIN_TYPE; // index of the MCP23017
-        mcp23017[m].digitalWrite(ledConfiguration[ledIndex].pin, brightness > 512 ? LOW : HIGH);
+        setMCP23017Output(m, ledConfiguration[ledIndex].pin, brightness > 512 ? LOW : HIGH);
+    }
+#endif
+}
+
+#if USE_PCA9685
+// Sets the duty cycle of a PCA9685 channel (0: off, 4096: fully on, otherwise on for duty / 4096 of the PWM period)
+// The channel is written by the next flushLEDs().
+void setPCA9685LED(int p, int channel, uint16_t duty)
+{
+    if (pca9685LEDDuty[p][channel] != duty) {
+        pca9685LEDDuty[p][channel] = duty;
+        pca9685DirtyLEDs[p] |= 1 << channel;
+    }
+}
+#endif
+
+#if USE_MCP23017
+// Sets an output pin of a MCP23017
+// The pin is written by the next flushLEDs().
+void setMCP23017Output(int m, int pin, bool level)
+{
+    uint16_t outputs = level ? mcp23017Outputs[m] | 1 << pin : mcp23017Outputs[m] & ~(1 << pin);
+    if (outputs != mcp23017Outputs[m]) {
+        mcp23017Outputs[m] = outputs;
+        mcp23017OutputsDirty[m] = true;
+    }
+}
+#endif
+
+// Writes the LEDs that have changed since the last call to the port expanders
+// Consecutive channels of a PCA9685 are written in a single I2C transaction (the PCA9685 auto-increments the register address), all pins of a MCP23017 are written at once.
+void flushLEDs()
+{
+#if USE_PCA9685
+    for (int p = 0; p < NUM_PCA9685s; p++) {
+        uint16_t dirty = pca9685DirtyLEDs[p];
+        while (dirty) {
+            // find the next run of changed channels
+            int first = __builtin_ctz(dirty);
+            int last = first;
+            while (last < 15 && (dirty & 1 << (last + 1))) {
+                last++;
+            }
+
+            Wire.beginTransmission(0x40 + p);
+            Wire.write(PCA9685_LED0_ON_L + 4 * first);
+            for (int channel = first; channel <= last; channel++) {
+                uint16_t duty = pca9685LEDDuty[p][channel];
+                uint16_t on = duty == 4096 ? 4096 : 0;
+                uint16_t off = duty == 4096 ? 0 : duty == 0 ? 4096 : duty;
+                Wire.write(on & 0xFF);
+                Wire.write(on >> 8);
+                Wire.write(off & 0xFF);
+                Wire.write(off >> 8);
+                dirty &= ~(1 << channel);
+            }
+            Wire.endTransmission();
+            loopStatistics.i2cTransactions++;
+        }
+        pca9685DirtyLEDs[p] = 0;
+    }
+#endif
+#if USE_MCP23017
+    for (int m = 0; m < NUM_MCP23017s; m++) {
+        if (mcp23017OutputsDirty[m]) {
+            mcp23017[m].writeGPIOAB(mcp23017Outputs[m]);
+            loopStatistics.i2cTransactions++;
+            mcp23017OutputsDirty[m] = false;
+        }
     }
 #endif
 }
@@ -1029,34 +1386,37 @@ void fadeLED(int ledIndex, int brightness)
 // copy level crossing command to level crossing object
 void levelCrossingCommand(int levelCrossingCommand)
 {
-    if (levelCrossingCommand == 0) { // open
-        if (levelCrossing.levelCrossingStatus != LevelCrossingStatus::OPEN) {
-            // If level crossing operates in autonomous mode, check if a track is occupied
-            if (!levelCrossingConfiguration.autonomousModeEnabled || !lcIsOccupied()) {
-                levelCrossing.levelCrossingStatus = LevelCrossingStatus::OPEN;
-                levelCrossing.servoTargetAnglePrimaryBooms = levelCrossingConfiguration.bbAnglePrimaryUp;
-                levelCrossing.servoTargetAngleSecondaryBooms = levelCrossingConfiguration.bbAngleSecondaryUp;
-                levelCrossing.servoAngleIncrementPerSec = abs((int)(levelCrossingConfiguration.bbAnglePrimaryUp - levelCrossingConfiguration.bbAnglePrimaryDown)) * 1000 / levelCrossingConfiguration.bbOpeningPeriod_ms;
-                mcLog2("Level crossing command OPEN, servo increment " + String(levelCrossing.servoAngleIncrementPerSec) + " deg/s.", LOG_INFO);
+    // Only compiled with a level crossing connected, as the periods of an empty level crossing config are 0.
+    if constexpr (LEVEL_CROSSING_CONNECTED) {
+        if (levelCrossingCommand == 0) { // open
+            if (levelCrossing.levelCrossingStatus != LevelCrossingStatus::OPEN) {
+                // If level crossing operates in autonomous mode, check if a track is occupied
+                if (!levelCrossingConfiguration.autonomousModeEnabled || !lcIsOccupied()) {
+                    levelCrossing.levelCrossingStatus = LevelCrossingStatus::OPEN;
+                    levelCrossing.servoTargetAnglePrimaryBooms = levelCrossingConfiguration.bbAnglePrimaryUp;
+                    levelCrossing.servoTargetAngleSecondaryBooms = levelCrossingConfiguration.bbAngleSecondaryUp;
+                    levelCrossing.servoAngleIncrementPerSec = abs((int)(levelCrossingConfiguration.bbAnglePrimaryUp - levelCrossingConfiguration.bbAnglePrimaryDown)) * 1000 / levelCrossingConfiguration.bbOpeningPeriod_ms;
+                    mcLogf(LOG_INFO, "Level crossing command OPEN, servo increment %.2f deg/s.", levelCrossing.servoAngleIncrementPerSec);
+                    levelCrossing.lastStatusChangeTime_ms = millis();
+                    levelCrossing.boomBarrierActionInProgress = true;
+                    sendSensorEvent2MQTT(levelCrossingConfiguration.sensorIndexBoomsClosed, false);
+                }
+            }
+        } else if (levelCrossingCommand == 1) { // closed
+            if (levelCrossing.levelCrossingStatus != LevelCrossingStatus::CLOSED) {
+                levelCrossing.levelCrossingStatus = LevelCrossingStatus::CLOSED;
+                levelCrossing.servoTargetAnglePrimaryBooms = levelCrossingConfiguration.bbAnglePrimaryDown;
+                levelCrossing.servoTargetAngleSecondaryBooms = levelCrossingConfiguration.bbAngleSecondaryDown;
+                levelCrossing.servoAngleIncrementPerSec = abs((int)(levelCrossingConfiguration.bbAnglePrimaryUp - levelCrossingConfiguration.bbAnglePrimaryDown)) * 1000 / levelCrossingConfiguration.bbClosingPeriod_ms;
+                mcLogf(LOG_INFO, "Level crossing command CLOSED, servo increment %.2f deg/s.", levelCrossing.servoAngleIncrementPerSec);
                 levelCrossing.lastStatusChangeTime_ms = millis();
+                levelCrossing.closeBoomsImmediately = levelCrossing.boomBarrierActionInProgress; // close booms immediately if booms were not fully open yet.
                 levelCrossing.boomBarrierActionInProgress = true;
-                sendSensorEvent2MQTT(levelCrossingConfiguration.sensorIndexBoomsClosed, false);
+                sendSensorEvent2MQTT(levelCrossingConfiguration.sensorIndexBoomsOpened, false);
             }
+        } else {
+            mcLogf(LOG_CRIT, "Unkown levelCrossing command.");
         }
-    } else if (levelCrossingCommand == 1) { // closed
-        if (levelCrossing.levelCrossingStatus != LevelCrossingStatus::CLOSED) {
-            levelCrossing.levelCrossingStatus = LevelCrossingStatus::CLOSED;
-            levelCrossing.servoTargetAnglePrimaryBooms = levelCrossingConfiguration.bbAnglePrimaryDown;
-            levelCrossing.servoTargetAngleSecondaryBooms = levelCrossingConfiguration.bbAngleSecondaryDown;
-            levelCrossing.servoAngleIncrementPerSec = abs((int)(levelCrossingConfiguration.bbAnglePrimaryUp - levelCrossingConfiguration.bbAnglePrimaryDown)) * 1000 / levelCrossingConfiguration.bbClosingPeriod_ms;
-            mcLog2("Level crossing command CLOSED, servo increment " + String(levelCrossing.servoAngleIncrementPerSec) + " deg/s.", LOG_INFO);
-            levelCrossing.lastStatusChangeTime_ms = millis();
-            levelCrossing.closeBoomsImmediately = levelCrossing.boomBarrierActionInProgress; // close booms immediately if booms were not fully open yet.
-            levelCrossing.boomBarrierActionInProgress = true;
-            sendSensorEvent2MQTT(levelCrossingConfiguration.sensorIndexBoomsOpened, false);
-        }
-    } else {
-        mcLog2("Unkown levelCrossing command.", LOG_CRIT);
     }
 }
 
@@ -1097,7 +1457,7 @@ void boomBarrierLoop()
             newServoAnglePrimaryBooms = max(levelCrossing.servoAnglePrimaryBooms - servoAngleIncrement, levelCrossing.servoTargetAnglePrimaryBooms);
         }
         if (DEBUG_SERVO_ANGLES) {
-            mcLog2("Primary booms angle: " + String(newServoAnglePrimaryBooms), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "Primary booms angle: %.2f", newServoAnglePrimaryBooms);
         }
 
         levelCrossing.servoAnglePrimaryBooms = newServoAnglePrimaryBooms;
@@ -1121,7 +1481,7 @@ void boomBarrierLoop()
             newServoAngleSecondaryBooms = max(levelCrossing.servoAngleSecondaryBooms - servoAngleIncrement, levelCrossing.servoTargetAngleSecondaryBooms);
         }
         if (DEBUG_SERVO_ANGLES) {
-            mcLog2("Secondary booms angle: " + String(newServoAngleSecondaryBooms), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "Secondary booms angle: %.2f", newServoAngleSecondaryBooms);
         }
 
         levelCrossing.servoAngleSecondaryBooms = newServoAngleSecondaryBooms;
@@ -1144,23 +1504,26 @@ void boomBarrierLoop()
 
 void levelCrossingLightLoop()
 {
-    // alternate all signal LEDs every levelCrossingConfiguration.ledFlashingPeriod_ms / 2 milliseconds
-    unsigned long now_ms = millis();
-    bool lightsActive = (levelCrossing.levelCrossingStatus == LevelCrossingStatus::CLOSED) || levelCrossing.boomBarrierActionInProgress;
-    bool alternatePeriod = (now_ms % levelCrossingConfiguration.ledFlashingPeriod_ms) > (levelCrossingConfiguration.ledFlashingPeriod_ms / 2);
-
-    for (int s = 0; s < LC_NUM_LEDS; s++) {
-        if (levelCrossingConfiguration.ledsFading) {
-            // fading lights
-            int brightness = 0;
-            if (lightsActive) {
-                long intermediateBrightness = abs((long)(levelCrossingConfiguration.ledFlashingPeriod_ms / 2 - ((now_ms + levelCrossingConfiguration.ledFlashingPeriod_ms * s / 2) % levelCrossingConfiguration.ledFlashingPeriod_ms)));
-                brightness = map(intermediateBrightness, 0, levelCrossingConfiguration.ledFlashingPeriod_ms / 2, -768, 1280);
+    // Only compiled with a level crossing connected, as the flashing period of an empty level crossing config is 0.
+    if constexpr (LEVEL_CROSSING_CONNECTED) {
+        // alternate all signal LEDs every levelCrossingConfiguration.ledFlashingPeriod_ms / 2 milliseconds
+        unsigned long now_ms = millis();
+        bool lightsActive = (levelCrossing.levelCrossingStatus == LevelCrossingStatus::CLOSED) || levelCrossing.boomBarrierActionInProgress;
+        bool alternatePeriod = (now_ms % levelCrossingConfiguration.ledFlashingPeriod_ms) > (levelCrossingConfiguration.ledFlashingPeriod_ms / 2);
+
+        for (int s = 0; s < LC_NUM_LEDS; s++) {
+            if (levelCrossingConfiguration.ledsFading) {
+                // fading lights
+                int brightness = 0;
+                if (lightsActive) {
+                    long intermediateBrightness = abs((long)(levelCrossingConfiguration.ledFlashingPeriod_ms / 2 - ((now_ms + levelCrossingConfiguration.ledFlashingPeriod_ms * s / 2) % levelCrossingConfiguration.ledFlashingPeriod_ms)));
+                    brightness = map(intermediateBrightness, 0, levelCrossingConfiguration.ledFlashingPeriod_ms / 2, -768, 1280);
+                }
+                fadeLED(levelCrossingConfiguration.ledIndex[s], brightness);
+            } else {
+                // flashing lights
+                setLED(levelCrossingConfiguration.ledIndex[s], lightsActive && (((s % 2) == 0) ^ alternatePeriod));
             }
-            fadeLED(levelCrossingConfiguration.ledIndex[s], brightness);
-        } else {
-            // flashing lights
-            setLED(levelCrossingConfiguration.ledIndex[s], lightsActive && (((s % 2) == 0) ^ alternatePeriod));
         }
     }
 }
@@ -1171,7 +1534,7 @@ void handleLevelCrossingSensorEvent(int triggeredSensor)
     if (!LEVEL_CROSSING_CONNECTED || !levelCrossingConfiguration.autonomousModeEnabled)
         return;
 
-    mcLog2("Checking if sensor " + String(triggeredSensor) + " is a level crossing sensor...", LOG_DEBUG);
+    mcLogf(LOG_DEBUG, "Checking if sensor %d is a level crossing sensor...", triggeredSensor);
 
     // Iterate level crossing sensors
     for (int lcs = 0; lcs < LC_NUM_SENSORS; lcs++) {
@@ -1181,7 +1544,7 @@ void handleLevelCrossingSensorEvent(int triggeredSensor)
             int purposeConfig = levelCrossingConfiguration.sensorConfiguration[lcs].purpose;
             int orientation = levelCrossingConfiguration.sensorConfiguration[lcs].orientation;
 
-            mcLog2("> Sensor " + String(triggeredSensor) + " is a level crossing sensor, track " + String(track) + ", purpose " + String(purposeConfig) + ", orientation " + (String(orientation) ? "-" : "+"), LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "> Sensor %d is a level crossing sensor, track %d, purpose %d, orientation %s", triggeredSensor, track, purposeConfig, orientation ? "-" : "+");
 
             int purposeFrom = purposeConfig;
             int purposeTo = purposeConfig;
@@ -1225,7 +1588,7 @@ void handleLevelCrossingSensorEvent(int triggeredSensor)
         }
     }
 
-    mcLog2("Sensor " + String(triggeredSensor) + " is not a level crossing sensor.", LOG_DEBUG);
+    mcLogf(LOG_DEBUG, "Sensor %d is not a level crossing sensor.", triggeredSensor);
 }
 
 // Returns if level crossing is occupied. Only relevant for autonomous mode
@@ -1245,7 +1608,7 @@ void checkLevelCrossingTrackTimeouts()
     for (int track = 0; track < LC_NUM_TRACKS; track++) {
         if (levelCrossing.trackOccupiedTimeout_ms[track] > 0) {
             if (millis() > levelCrossing.trackOccupiedTimeout_ms[track]) {
-                mcLog2("Counters for track " + String(track) + " timed out.", LOG_INFO);
+                mcLogf(LOG_INFO, "Counters for track %d timed out.", track);
 
                 // disable timeout for this track
                 levelCrossing.trackOccupiedTimeout_ms[track] = 0;
@@ -1298,15 +1661,15 @@ void levelCrossingLoop()
 void basculeBridgeCommand(int bridgeCommand)
 {
     if (bridgeCommand == 0) { // up
-        mcLog2("Bascule bridge command UP.", LOG_INFO);
+        mcLogf(LOG_INFO, "Bascule bridge command UP.");
         resetBridgeLeafErrors();
         bridge.bridgeCommand = BridgeCommand::UP;
     } else if (bridgeCommand == 1) { // down
-        mcLog2("Bascule bridge command DOWN.", LOG_INFO);
+        mcLogf(LOG_INFO, "Bascule bridge command DOWN.");
         resetBridgeLeafErrors();
         bridge.bridgeCommand = BridgeCommand::DOWN;
     } else {
-        mcLog2("Unkown bascule bridge command.", LOG_CRIT);
+        mcLogf(LOG_CRIT, "Unkown bascule bridge command.");
     }
 }
 
@@ -1319,7 +1682,7 @@ void setBridgeMotorPower(int leafIndex, int motorPower)
     } else if (motorPower < -100) {
         motorPower = -100;
     }
-    mcLog2("[" + String(leafIndex) + "] Setting bridge motor power to " + String(motorPower), LOG_INFO);
+    mcLogf(LOG_INFO, "[%d] Setting bridge motor power to %d", leafIndex, motorPower);
 
     // PWM values for orange continuous servos: 0=full backward, 100=stop, 199=full forward
     setServoAngle(bridgeConfiguration.leafConfiguration[leafIndex].servoIndex, motorPower + 100);
@@ -1445,27 +1808,27 @@ void basculeBridgeLoop()
 
         switch (nextBridgeStatus) {
         case BridgeStatus::CLOSED:
-            mcLog2("New bridge status: Bridge fully closed.", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "New bridge status: Bridge fully closed.");
             sendSensorEvent2MQTT(bridgeConfiguration.sensorFullyDown, true);
             break;
 
         case BridgeStatus::OPENING:
-            mcLog2("New bridge status: Opening bridge...", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "New bridge status: Opening bridge...");
             sendSensorEvent2MQTT(bridgeConfiguration.sensorFullyDown, false);
             break;
 
         case BridgeStatus::OPENED:
-            mcLog2("New bridge status: Bridge fully opened.", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "New bridge status: Bridge fully opened.");
             sendSensorEvent2MQTT(bridgeConfiguration.sensorFullyUp, true);
             break;
 
         case BridgeStatus::CLOSING:
-            mcLog2("New bridge status: Closing bridge...", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "New bridge status: Closing bridge...");
             sendSensorEvent2MQTT(bridgeConfiguration.sensorFullyUp, false);
             break;
 
         case BridgeStatus::ERRoR:
-            mcLog2("New bridge status: Bridge error.", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "New bridge status: Bridge error.");
             sendSensorEvent2MQTT(bridgeConfiguration.sensorFullyUp, false);
             sendSensorEvent2MQTT(bridgeConfiguration.sensorFullyDown, false);
             break;
@@ -1547,21 +1910,21 @@ void processBridgeLeaf(int leafIndex)
     if (bridge.bridgeLeaf[leafIndex].leafStatus != BridgeLeafStatus::ERRoR) {
         if (bridge.bridgeStatus == BridgeStatus::ERRoR) {
             nextBridgeLeafStatus = BridgeLeafStatus::ERRoR;
-            mcLog2("ALERT: Bridge leaf " + String(leafIndex) + " set to error state, because bridge is in error state!", LOG_ALERT);
+            mcLogf(LOG_ALERT, "ALERT: Bridge leaf %d set to error state, because bridge is in error state!", leafIndex);
         } else if (bridge.bridgeLeaf[leafIndex].leafStatus == BridgeLeafStatus::CLOSED) {
             if (!sensorDown) {
                 nextBridgeLeafStatus = BridgeLeafStatus::ERRoR;
-                mcLog2("ALERT: Bridge leaf " + String(leafIndex) + " is in status CLOSED, but the closing sensor was released!", LOG_ALERT);
+                mcLogf(LOG_ALERT, "ALERT: Bridge leaf %d is in status CLOSED, but the closing sensor was released!", leafIndex);
                 sendEmergencyBrake2MQTT("bridge unsafe - closing sensor unexpectetly released");
             }
         } else if (bridge.bridgeLeaf[leafIndex].leafStatus == BridgeLeafStatus::OPENED) {
             if (!sensorUp) {
                 nextBridgeLeafStatus = BridgeLeafStatus::ERRoR;
-                mcLog2("ALERT: Bridge leaf " + String(leafIndex) + " is in status OPENED, but the opening sensor was released!", LOG_ALERT);
+                mcLogf(LOG_ALERT, "ALERT: Bridge leaf %d is in status OPENED, but the opening sensor was released!", leafIndex);
             }
         } else if (sensorDown && sensorUp) {
             nextBridgeLeafStatus = BridgeLeafStatus::ERRoR;
-            mcLog2("ALERT: Both sensors of bridge leaf " + String(leafIndex) + " triggered concurrently!", LOG_ALERT);
+            mcLogf(LOG_ALERT, "ALERT: Both sensors of bridge leaf %d triggered concurrently!", leafIndex);
             sendEmergencyBrake2MQTT("bridge unsafe - leaf sensors triggered concurrently");
         }
     }
@@ -1601,7 +1964,7 @@ void processBridgeLeaf(int leafIndex)
                 if (sensorDown) {
                     if (millis() - bridge.bridgeLeaf[leafIndex].leafTimer >= bridgeConfiguration.leafConfiguration[leafIndex].maxOpeningTime_ms) {
                         nextBridgeLeafStatus = BridgeLeafStatus::ERRoR;
-                        mcLog2("[" + String(leafIndex) + "] Timeout error in Opening1 state.", LOG_DEBUG);
+                        mcLogf(LOG_DEBUG, "[%d] Timeout error in Opening1 state.", leafIndex);
                         break;
                     }
                     break;
@@ -1613,7 +1976,7 @@ void processBridgeLeaf(int leafIndex)
                 if (!sensorUp) {
                     if (millis() - bridge.bridgeLeaf[leafIndex].leafTimer >= bridgeConfiguration.leafConfiguration[leafIndex].maxOpeningTime_ms) {
                         nextBridgeLeafStatus = BridgeLeafStatus::ERRoR;
-                        mcLog2("[" + String(leafIndex) + "] Timeout error in Opening2 state.", LOG_DEBUG);
+                        mcLogf(LOG_DEBUG, "[%d] Timeout error in Opening2 state.", leafIndex);
                         break;
                     }
                     break;
@@ -1663,7 +2026,7 @@ void processBridgeLeaf(int leafIndex)
                 if (sensorUp) {
                     if (millis() - bridge.bridgeLeaf[leafIndex].leafTimer >= bridgeConfiguration.leafConfiguration[leafIndex].maxClosingTime_ms) {
                         nextBridgeLeafStatus = BridgeLeafStatus::ERRoR;
-                        mcLog2("[" + String(leafIndex) + "] Timeout error in Closing1 state.", LOG_DEBUG);
+                        mcLogf(LOG_DEBUG, "[%d] Timeout error in Closing1 state.", leafIndex);
                         break;
                     }
                     break;
@@ -1675,7 +2038,7 @@ void processBridgeLeaf(int leafIndex)
                 if (!sensorDown) {
                     if (millis() - bridge.bridgeLeaf[leafIndex].leafTimer >= bridgeConfiguration.leafConfiguration[leafIndex].maxClosingTime_ms) {
                         nextBridgeLeafStatus = BridgeLeafStatus::ERRoR;
-                        mcLog2("[" + String(leafIndex) + "] Timeout error in Closing2 state.", LOG_DEBUG);
+                        mcLogf(LOG_DEBUG, "[%d] Timeout error in Closing2 state.", leafIndex);
                         break;
                     }
                     break;
@@ -1712,73 +2075,73 @@ void processBridgeLeaf(int leafIndex)
 
         switch (nextBridgeLeafStatus) {
         case BridgeLeafStatus::CLOSED:
-            mcLog2("[" + String(leafIndex) + "] Bridge leaf fully closed.", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "[%d] Bridge leaf fully closed.", leafIndex);
             setBridgeMotorPower(leafIndex, 0);
             break;
 
         case BridgeLeafStatus::OPENING0:
-            mcLog2("[" + String(leafIndex) + "] Bridge leaf standing by to be opened.", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "[%d] Bridge leaf standing by to be opened.", leafIndex);
             setBridgeMotorPower(leafIndex, 0);
             break;
         case BridgeLeafStatus::OPENING1:
-            mcLog2("[" + String(leafIndex) + "] Opening bridge leaf (initial stage)...", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "[%d] Opening bridge leaf (initial stage)...", leafIndex);
             setBridgeMotorPower(leafIndex, bridgeConfiguration.leafConfiguration[leafIndex].powerUp);
             break;
         case BridgeLeafStatus::OPENING2:
-            mcLog2("[" + String(leafIndex) + "] Opening bridge leaf (intermediate stage)...", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "[%d] Opening bridge leaf (intermediate stage)...", leafIndex);
             setBridgeMotorPower(leafIndex, bridgeConfiguration.leafConfiguration[leafIndex].powerUp);
             break;
         case BridgeLeafStatus::OPENING3:
-            mcLog2("[" + String(leafIndex) + "] Opening bridge leaf (final stage)...", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "[%d] Opening bridge leaf (final stage)...", leafIndex);
             setBridgeMotorPower(leafIndex, bridgeConfiguration.leafConfiguration[leafIndex].powerUp2);
             break;
 
         case BridgeLeafStatus::OPENED:
-            mcLog2("[" + String(leafIndex) + "] Bridge leaf fully opened.", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "[%d] Bridge leaf fully opened.", leafIndex);
             setBridgeMotorPower(leafIndex, 0);
             break;
 
         case BridgeLeafStatus::CLOSING0:
-            mcLog2("[" + String(leafIndex) + "] Bridge leaf standing by to be closed.", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "[%d] Bridge leaf standing by to be closed.", leafIndex);
             setBridgeMotorPower(leafIndex, 0);
             break;
         case BridgeLeafStatus::CLOSING1:
-            mcLog2("[" + String(leafIndex) + "] Closing bridge leaf (initial stage)...", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "[%d] Closing bridge leaf (initial stage)...", leafIndex);
             setBridgeMotorPower(leafIndex, bridgeConfiguration.leafConfiguration[leafIndex].powerDown);
             break;
         case BridgeLeafStatus::CLOSING2:
-            mcLog2("[" + String(leafIndex) + "] Closing bridge leaf (intermediate stage)...", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "[%d] Closing bridge leaf (intermediate stage)...", leafIndex);
             setBridgeMotorPower(leafIndex, bridgeConfiguration.leafConfiguration[leafIndex].powerDown);
             break;
         case BridgeLeafStatus::CLOSING3:
-            mcLog2("[" + String(leafIndex) + "] Closing bridge leaf (final stage)...", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "[%d] Closing bridge leaf (final stage)...", leafIndex);
             setBridgeMotorPower(leafIndex, bridgeConfiguration.leafConfiguration[leafIndex].powerDown2);
             break;
 
         case BridgeLeafStatus::UNDEFINED:
-            mcLog2("[" + String(leafIndex) + "] Bridge leaf status undefined.", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "[%d] Bridge leaf status undefined.", leafIndex);
             setBridgeMotorPower(leafIndex, 0);
             break;
 
         case BridgeLeafStatus::ERRoR:
-            mcLog2("[" + String(leafIndex) + "] Bridge leaf error.", LOG_CRIT);
+            mcLogf(LOG_CRIT, "[%d] Bridge leaf error.", leafIndex);
             setBridgeMotorPower(leafIndex, 0);
             break;
 
         default:
             // This should not happen
-            mcLog2("[" + String(leafIndex) + "] Unknown status change...?!? Bridge leaf status undefined.", LOG_CRIT);
+            mcLogf(LOG_CRIT, "[%d] Unknown status change...?!? Bridge leaf status undefined.", leafIndex);
         }
     }
 }
 
 void SpeedometerDebug()
 {
-    mcLog2("Speedometer Debug ----------------------------------------------------", LOG_DEBUG);
+    mcLogf(LOG_DEBUG, "Speedometer Debug ----------------------------------------------------");
     for (int i = 0; i <= speedometer.wheelcounter[speedometer.startSensor]; i++) {
-        mcLog2("Magnet [" + String(i) + "] Start: " + String(speedometer.startTime[i]) + " End: " + String(speedometer.endTime[i]) + " Speed: " + String(speedometer.trainSpeed[i]) + " Length: " + String(speedometer.trainLength[i]), LOG_DEBUG);
+        mcLogf(LOG_DEBUG, "Magnet [%d] Start: %.2f End: %.2f Speed: %.2f Length: %.2f", i, speedometer.startTime[i], speedometer.endTime[i], speedometer.trainSpeed[i], speedometer.trainLength[i]);
     }
-    mcLog2("----------------------------------------------------------------------", LOG_DEBUG);
+    mcLogf(LOG_DEBUG, "----------------------------------------------------------------------");
 }
 
 void updateDisplay()
@@ -1861,12 +2224,13 @@ void updateDisplay()
 #endif
 }
 
-void handleSpeedometerSensorEvent(int triggeredSensor)
+// Handles a contact of a speedometer sensor at the given time (micros())
+void handleSpeedometerSensorEvent(int triggeredSensor, unsigned long contact_us)
 {
     if (!SPEEDOMETER_CONNECTED)
         return;
 
-    mcLog2("Checking if sensor " + String(triggeredSensor) + " is a speedometer sensor...", LOG_DEBUG);
+    mcLogf(LOG_DEBUG, "Checking if sensor %d is a speedometer sensor...", triggeredSensor);
 
     // Check if triggered sensors is a speedometer sensor
     if (speedometerConfiguration.sensorIndex[0] != triggeredSensor && speedometerConfiguration.sensorIndex[1] != triggeredSensor) {
@@ -1883,7 +2247,7 @@ void handleSpeedometerSensorEvent(int triggeredSensor)
             speedometer.lastMeasurementEvent = millis();
             int wcStart = ++speedometer.wheelcounter[speedometer.startSensor];
 
-            speedometer.startTime[wcStart] = speedometer.lastMeasurementEvent;
+            speedometer.startTime[wcStart] = (contact_us - speedometer.measurementStart_us) / 1000.0;
             speedometer.endTime[wcStart] = 0;
             speedometer.trainSpeed[wcStart] = 0;
             speedometer.trainLength[wcStart] = 0;
@@ -1902,7 +2266,7 @@ void handleSpeedometerSensorEvent(int triggeredSensor)
                 speedometer.wheelcounter[speedometer.endSensor] = speedometer.wheelcounter[speedometer.startSensor];
             }
 
-            speedometer.endTime[wcEnd] = speedometer.lastMeasurementEvent;
+            speedometer.endTime[wcEnd] = (contact_us - speedometer.measurementStart_us) / 1000.0;
 
             float timeDiffSpeed = (speedometer.endTime[wcEnd] - speedometer.startTime[wcEnd]) / 1000;
             speedometer.trainSpeed[wcEnd] = speedometerConfiguration.distance / timeDiffSpeed;
@@ -1925,8 +2289,8 @@ void handleSpeedometerSensorEvent(int triggeredSensor)
                 }
                 speedometer.actualTrainSpeed = speedometer.actualTrainSpeed / (wcEnd + 1);
 
-                mcLog2("actualTrainSpeed:  " + String(speedometer.actualTrainSpeed), LOG_DEBUG);
-                mcLog2("actualTrainLength: " + String(speedometer.actualTrainLength), LOG_DEBUG);
+                mcLogf(LOG_DEBUG, "actualTrainSpeed:  %.2f", speedometer.actualTrainSpeed);
+                mcLogf(LOG_DEBUG, "actualTrainLength: %.2f", speedometer.actualTrainLength);
             }
 
             SpeedometerDebug();
@@ -1934,7 +2298,7 @@ void handleSpeedometerSensorEvent(int triggeredSensor)
 
         // no length measurement or wheelcounter similar or timeout
         if (millis() >= speedometer.lastMeasurementEvent + speedometerConfiguration.timeOut) {
-            mcLog2("Speedometer reset (2)!", LOG_INFO);
+            mcLogf(LOG_INFO, "Speedometer reset (2)!");
             speedometer.occupied = false;
             speedometer.wheelcounter[speedometer.startSensor] = -1;
             speedometer.wheelcounter[speedometer.endSensor] = -1;
@@ -1948,6 +2312,7 @@ void handleSpeedometerSensorEvent(int triggeredSensor)
     //-------------------------------------------------
     if (!speedometer.occupied && millis() - speedometer.measurementDone >= speedometerConfiguration.timeBetweenMeasurements) {
         speedometer.lastMeasurementEvent = millis();
+        speedometer.measurementStart_us = contact_us;
 
         speedometer.startSensor = triggeredSensor;
         speedometer.endSensor = 1 - triggeredSensor;
@@ -1955,7 +2320,7 @@ void handleSpeedometerSensorEvent(int triggeredSensor)
         speedometer.wheelcounter[speedometer.startSensor] = 0;
         speedometer.wheelcounter[speedometer.endSensor] = -1;
 
-        speedometer.startTime[speedometer.wheelcounter[speedometer.startSensor]] = speedometer.lastMeasurementEvent;
+        speedometer.startTime[speedometer.wheelcounter[speedometer.startSensor]] = 0;
         speedometer.endTime[speedometer.wheelcounter[speedometer.startSensor]] = 0;
         speedometer.trainSpeed[speedometer.wheelcounter[speedometer.startSensor]] = 0;
         speedometer.trainLength[speedometer.wheelcounter[speedometer.startSensor]] = 0;
@@ -1970,7 +2335,7 @@ void speedometerLoop()
     if (speedometer.occupied) {
         // no length measurement or wheelcounter smilar or timeout
         if (millis() >= speedometer.lastMeasurementEvent + speedometerConfiguration.timeOut) {
-            mcLog2("Speedometer reset (1)!", LOG_INFO);
+            mcLogf(LOG_INFO, "Speedometer reset (1)!");
             speedometer.occupied = false;
             speedometer.wheelcounter[speedometer.startSensor] = -1;
             speedometer.wheelcounter[speedometer.endSensor] = -1;
@@ -1989,7 +2354,7 @@ void speedometerLoop()
     if (!speedometer.occupied && actMillis - speedometer.measurementDone < speedometerConfiguration.timeBetweenMeasurements && actMillis - speedometer.lastMeasurementEvent > 1000) {
         int remaningDuration = (speedometerConfiguration.timeBetweenMeasurements - (millis() - speedometer.measurementDone)) / 1000;
         if ((remaningDuration < 5 || remaningDuration % 5 == 0) && remaningDuration > 0) {
-            mcLog2("Minimum time between measurements: " + String((int)(speedometerConfiguration.timeBetweenMeasurements - (millis() - speedometer.measurementDone)) / 1000) + " seconds remaining", LOG_DEBUG);
+            mcLogf(LOG_DEBUG, "Minimum time between measurements: %d seconds remaining", (int)(speedometerConfiguration.timeBetweenMeasurements - (millis() - speedometer.measurementDone)) / 1000);
             speedometer.lastMeasurementEvent = actMillis;
         }
     }
@@ -2029,10 +2394,34 @@ void speedometerLoop()
 void loop()
 {
     loopMattzoController();
+    servoLoop();
+    switchLoop();
     checkEnableServoSleepMode();
     signalLoop();
     monitorSensors();
     levelCrossingLoop();
     basculeBridgeLoop();
     speedometerLoop();
+    flushLEDs();
+    updateLoopStatistics();
+}
+
+// Count loop passes and log the loop statistics every LOOP_STATISTICS_INTERVAL_MS
+void updateLoopStatistics()
+{
+    // the pass time is measured between two calls, so it includes the work done by the ESP8266 core between two calls of loop()
+    static unsigned long lastPass_us = micros();
+    unsigned long now_us = micros();
+    loopStatistics.maxPassTime_us = max(loopStatistics.maxPassTime_us, now_us - lastPass_us);
+    lastPass_us = now_us;
+
+    loopStatistics.passes++;
+
+    unsigned long interval_ms = millis() - loopStatistics.intervalStart_ms;
+    if (interval_ms >= LOOP_STATISTICS_INTERVAL_MS) {
+        mcLogf(LOG_DEBUG, "Loop: %lu passes/s, max. pass time %lu us, sensor scan %lu us/pass, %lu I2C transactions/s", loopStatistics.passes * 1000 / interval_ms, loopStatistics.maxPassTime_us, loopStatistics.sensorScanTime_us / loopStatistics.passes, loopStatistics.i2cTransactions * 1000 / interval_ms);
+
+        loopStatistics = LoopStatistics();
+        loopStatistics.intervalStart_ms = millis();
+    }
 }
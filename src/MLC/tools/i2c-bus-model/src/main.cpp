@@ -0,0 +1,164 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// Default I2C bus speed (Wire's default on the ESP8266).
+#define DEFAULT_BUS_SPEED_IN_HZ 100000
+
+// Default time for the rest of a loop pass (MQTT, switches, signals, LEDs) in microseconds.
+#define DEFAULT_REST_OF_PASS_IN_US 900
+
+// Number of pins of a MCP23017.
+#define MCP23017_PIN_COUNT 16
+
+// I2C bus that adds up the time its transfers take, with the transaction API of the Arduino Wire library.
+// Every byte takes 9 bit times (8 data bits and the ACK), every transaction 2 more for its start and stop condition.
+class SimulatedI2CBus
+{
+  public:
+    SimulatedI2CBus(uint32_t speedInHz)
+    {
+        _bitTimeInUs = 1000000.0 / speedInHz;
+        _timeInUs = 0;
+        _transactionCount = 0;
+    }
+
+    void beginTransmission(uint8_t address)
+    {
+        startTransaction();
+    }
+
+    void write(uint8_t value)
+    {
+        transfer(1);
+    }
+
+    void endTransmission()
+    {
+        _timeInUs += _bitTimeInUs;
+    }
+
+    void requestFrom(uint8_t address, uint8_t size)
+    {
+        startTransaction();
+        transfer(size);
+        _timeInUs += _bitTimeInUs;
+    }
+
+    double GetTimeInUs()
+    {
+        return _timeInUs;
+    }
+
+    uint32_t GetTransactionCount()
+    {
+        return _transactionCount;
+    }
+
+  private:
+    void startTransaction()
+    {
+        // Start condition and address byte.
+        _timeInUs += _bitTimeInUs;
+        transfer(1);
+        _transactionCount++;
+    }
+
+    void transfer(uint8_t size)
+    {
+        _timeInUs += size * 9 * _bitTimeInUs;
+    }
+
+    double _bitTimeInUs;
+    double _timeInUs;
+    uint32_t _transactionCount;
+};
+
+// MCP23017 on the simulated bus, with the transactions of the Adafruit MCP23017 library (version 1.3.0, as used by the MLC).
+class SimulatedMCP23017
+{
+  public:
+    SimulatedMCP23017(SimulatedI2CBus &bus, uint8_t address) : _bus{bus}, _address{address} {}
+
+    // Reads the GPIO register of the pin's port (select the register, then read it).
+    uint8_t digitalRead(uint8_t pin)
+    {
+        _bus.beginTransmission(_address);
+        _bus.write(pin < 8 ? 0x12 : 0x13);
+        _bus.endTransmission();
+        _bus.requestFrom(_address, 1);
+        return 0;
+    }
+
+    // Reads both GPIO registers (select GPIOA, then read GPIOA and GPIOB).
+    uint16_t readGPIOAB()
+    {
+        _bus.beginTransmission(_address);
+        _bus.write(0x12);
+        _bus.endTransmission();
+        _bus.requestFrom(_address, 2);
+        return 0;
+    }
+
+  private:
+    SimulatedI2CBus &_bus;
+    uint8_t _address;
+};
+
+// Time a single sensor scan takes on the bus.
+struct ScanResult {
+    double TimeInUs;
+    uint32_t TransactionCount;
+};
+
+// Scans the given number of sensors on the given number of MCP23017s (spread evenly), one digitalRead per sensor or one readGPIOAB per MCP23017.
+ScanResult scan(uint32_t busSpeedInHz, int sensorCount, int chipCount, bool readPerChip)
+{
+    SimulatedI2CBus bus(busSpeedInHz);
+
+    for (int m = 0; m < chipCount; m++) {
+        SimulatedMCP23017 chip(bus, 0x20 + m);
+        int chipSensorCount = sensorCount / chipCount + (m < sensorCount % chipCount ? 1 : 0);
+
+        if (readPerChip) {
+            if (chipSensorCount > 0) {
+                chip.readGPIOAB();
+            }
+        } else {
+            for (int pin = 0; pin < chipSensorCount; pin++) {
+                chip.digitalRead(pin);
+            }
+        }
+    }
+
+    return {bus.GetTimeInUs(), bus.GetTransactionCount()};
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 3) {
+        fprintf(stderr, "Usage: %s [bus speed in Hz] [time for the rest of a loop pass in us]\n", argv[0]);
+        return 2;
+    }
+
+    uint32_t busSpeedInHz = argc > 1 ? strtoul(argv[1], nullptr, 10) : DEFAULT_BUS_SPEED_IN_HZ;
+    double restOfPassInUs = argc > 2 ? strtod(argv[2], nullptr) : DEFAULT_REST_OF_PASS_IN_US;
+    if (busSpeedInHz == 0) {
+        fprintf(stderr, "error: Invalid bus speed.\n");
+        return 2;
+    }
+
+    printf("I2C bus at %u Hz, %.0f us per pass for the rest of the loop.\n\n", busSpeedInHz, restOfPassInUs);
+    printf("sensors/chips  scan per pin  scan per chip  I2C transactions/pass  passes/s per pin -> per chip\n");
+
+    const int setups[][2] = {{16, 1}, {32, 2}, {64, 4}, {128, 8}};
+    for (const int *setup : setups) {
+        ScanResult perPin = scan(busSpeedInHz, setup[0], setup[1], false);
+        ScanResult perChip = scan(busSpeedInHz, setup[0], setup[1], true);
+
+        printf("%4d / %-2d %14.0f us %12.0f us %10u -> %-3u %16.0f -> %.0f\n", setup[0], setup[1], perPin.TimeInUs, perChip.TimeInUs,
+               perPin.TransactionCount, perChip.TransactionCount, 1000000 / (perPin.TimeInUs + restOfPassInUs), 1000000 / (perChip.TimeInUs + restOfPassInUs));
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -1,15 +1,15 @@
 #pragma once
 
-#include "BLEHub.h"
+#include "BLEHubRegistry.h"
 #include "NimBLEDevice.h"
 
 class BLEDeviceCallbacks : public NimBLEAdvertisedDeviceCallbacks
 {
   public:
-    BLEDeviceCallbacks(std::vector<BLEHub *> hubs);
+    BLEDeviceCallbacks(BLEHubRegistry *registry);
 
   private:
     void onResult(NimBLEAdvertisedDevice *advertisedDevice);
 
-    std::vector<BLEHub *> _hubs;
-};
\ No newline at end of file
+    BLEHubRegistry *_registry;
+};
@@ -24,6 +24,15 @@
 // The number of seconds to wait for a Hub to connect.
 #define ConnectDelayInSeconds 5
 
+// The number of seconds to wait for a Hub to connect when reconnecting directly to its known address.
+#define ReconnectDelayInSeconds 1
+
+// The number of directed reconnect attempts after a dropout, before falling back to scanning.
+#define MaxReconnectAttempts 5
+
+// The number of milliseconds to wait before the second directed reconnect attempt (doubled after every failed attempt).
+#define ReconnectBackoffInMs 100
+
 enum struct MessageType {
     HUB_PROPERTIES = 0x01,
     HUB_ACTIONS = 0x02,
@@ -56,6 +65,10 @@ class BLEHub
   public:
     BLEHub(BLEHubConfiguration *config);
 
+    // Deletes the channel controllers and the BLE client of the hub.
+    // Only to be used once the hub is retired and idle, as the drive task and the client callbacks use the hub until then.
+    virtual ~BLEHub();
+
     // Returns a boolean value indicating whether we have discovered the BLE hub.
     bool IsDiscovered();
 
@@ -97,27 +110,72 @@ class BLEHub
     // Method used to connect to the BLE hub.
     bool Connect(const uint8_t watchdogTimeOutInTensOfSeconds);
 
+    // Returns a boolean value indicating whether we are reconnecting directly to the BLE hub after it dropped its connection.
+    bool IsReconnecting();
+
+    // Returns a boolean value indicating whether the next directed reconnect attempt is due.
+    bool IsReconnectDue();
+
+    // Method used to reconnect directly to the known address of the BLE hub (without scanning) after it dropped its connection.
+    bool Reconnect(const uint8_t watchdogTimeOutInTensOfSeconds);
+
+    // Returns the number of times the BLE hub dropped an established connection.
+    uint32_t GetDropoutCount();
+
+    // Returns the number of milliseconds it took to recover from the last dropout.
+    ulong GetLastRecoveryTimeInMs();
+
+    // Returns the number of times directed reconnects failed and we fell back to scanning for the BLE hub.
+    uint32_t GetFallbackScanCount();
+
+    // Returns the max. CPU time (in µs) a single drive loop iteration took.
+    ulong GetMaxDriveLoopTimeInUs();
+
+    // Returns the average CPU time (in µs) of the drive loop iterations.
+    ulong GetAvgDriveLoopTimeInUs();
+
+    // Applies the given (reloaded) configuration without reconnecting, if it only changes how the channels are driven (ramping, speed curve or polarity).
+    // Returns false if the hub type, address, channels or speed control changed, in which case the hub has to be replaced.
+    bool Reconfigure(BLEHubConfiguration *config);
+
+    // Stops using the hub (when it was removed from the config): brakes all channels and disconnects without reconnecting.
+    void Retire();
+
+    // Returns a boolean value indicating whether the hub was removed from the config.
+    bool IsRetired();
+
+    // Returns a boolean value indicating whether a retired hub has disconnected and is done handling its disconnect (so it can be deleted).
+    bool IsIdle();
+
+    // Returns the controllers of the hub's channels.
+    std::vector<BLEHubChannelController *> GetChannelControllers();
+
     // Abstract method used to set the watchdog timeout.
     virtual bool SetWatchdogTimeout(const uint8_t watchdogTimeOutInTensOfSeconds) = 0;
 
     // Abstract method used to periodically send drive commands to the BLE hub.
     virtual void DriveTaskLoop() = 0;
 
-    // Abstract method used to map a speed percentile (-100% - 100%) to a raw speed value.
-    virtual int16_t MapPwrPercToRaw(int pwrPerc) = 0;
+    // Abstract method used to map a fixed-point pwr (-100% - 100%, in 1/256 %) to a raw speed value.
+    virtual int16_t MapPwrToRaw(int32_t pwr) = 0;
 
     // Abstract callback method used to handle hub notifications.
     virtual void NotifyCallback(NimBLERemoteCharacteristic *pBLERemoteCharacteristic, uint8_t *pData, size_t length, bool isNotify) = 0;
 
   private:
     void initChannelControllers();
+    void compileRawPwrTables();
+    void recordDriveLoopTime(ulong startedAt);
     void setTargetPwrPercByAttachedDevice(DeviceType device, int16_t minPwrPerc, int16_t pwrPerc);
     HubLedColor getRawLedColorForController(BLEHubChannelController *controller);
     uint8_t getRawChannelPwrForController(BLEHubChannelController *controller);
     BLEHubChannelController *findControllerByChannel(BLEHubChannel channel);
 
     bool attachCharacteristic(NimBLEUUID serviceUUID, NimBLEUUID characteristicUUID);
+    bool completeConnect(const uint8_t watchdogTimeOutInTensOfSeconds);
+    void startReconnect();
     bool startDriveTask();
+    void disconnect();
     static void driveTaskImpl(void *);
     void connected();
     void disconnected();
@@ -128,6 +186,10 @@ class BLEHub
     std::vector<BLEHubChannelController *> _channelControllers;
 
     TaskHandle_t _driveTaskHandle;
+
+    // Held by the drive task while it drives the channels, so their configs can't change halfway a pass and the task isn't deleted while writing to the hub.
+    SemaphoreHandle_t _driveLock;
+
     NimBLEAdvertisedDevice *_advertisedDevice;
     NimBLEAdvertisedDeviceCallbacks *_advertisedDeviceCallback;
     NimBLEClient *_hub;
@@ -138,6 +200,18 @@ class BLEHub
     ulong _blinkUntil;
     bool _isDiscovered;
     bool _isConnected;
+    bool _isReconnecting;
+    bool _isRetired;
+    bool _isDisconnecting;
+    uint8_t _reconnectAttempts;
+    ulong _nextReconnectAttemptAt;
+    ulong _droppedAt;
+    uint32_t _dropoutCount;
+    ulong _lastRecoveryTimeInMs;
+    uint32_t _fallbackScanCount;
+    ulong _maxDriveLoopTimeInUs;
+    uint64_t _totalDriveLoopTimeInUs;
+    uint32_t _driveLoopCount;
     uint16_t _watchdogTimeOutInTensOfSeconds;
     NimBLERemoteService *_remoteControlService;
     NimBLERemoteCharacteristic *_remoteControlCharacteristic;
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <map>
+#include "enums.h"
 
 enum BLEHubChannel {
     A = 0,
@@ -10,21 +10,23 @@ enum BLEHubChannel {
     OnboardLED = 99
 };
 
-// String switch paridgam
-struct bleHubChannelMap : public std::map<std::string, BLEHubChannel> {
-    bleHubChannelMap()
-    {
-        this->operator[]("A") = BLEHubChannel::A;
-        this->operator[]("a") = BLEHubChannel::A;
-        this->operator[]("B") = BLEHubChannel::B;
-        this->operator[]("b") = BLEHubChannel::B;
-        this->operator[]("C") = BLEHubChannel::C;
-        this->operator[]("c") = BLEHubChannel::C;
-        this->operator[]("D") = BLEHubChannel::D;
-        this->operator[]("d") = BLEHubChannel::D;
-        this->operator[]("LED") = BLEHubChannel::OnboardLED;
-        this->operator[]("Led") = BLEHubChannel::OnboardLED;
-        this->operator[]("led") = BLEHubChannel::OnboardLED;
-    };
-    ~bleHubChannelMap() {}
-};
\ No newline at end of file
+// Config names of the BLEHubChannel values.
+constexpr MCEnumName<BLEHubChannel> bleHubChannelNames[] = {
+    {"A", BLEHubChannel::A},
+    {"a", BLEHubChannel::A},
+    {"B", BLEHubChannel::B},
+    {"b", BLEHubChannel::B},
+    {"C", BLEHubChannel::C},
+    {"c", BLEHubChannel::C},
+    {"D", BLEHubChannel::D},
+    {"d", BLEHubChannel::D},
+    {"LED", BLEHubChannel::OnboardLED},
+    {"Led", BLEHubChannel::OnboardLED},
+    {"led", BLEHubChannel::OnboardLED},
+};
+
+// Returns the BLEHubChannel with the given config name (A if unknown).
+inline BLEHubChannel parseBleHubChannel(const std::string &name)
+{
+    return lookupEnumName(bleHubChannelNames, name, BLEHubChannel::A);
+}
\ No newline at end of file
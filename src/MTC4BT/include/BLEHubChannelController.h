@@ -1,16 +1,76 @@
 #pragma once
 
 #include <Arduino.h>
+#include <functional>
 
 #include "BLEHubChannel.h"
 #include "MCChannelConfig.h"
 #include "MCChannelController.h"
+#include "MCSpeedController.h"
 
 class BLEHubChannelController : public MCChannelController
 {
   public:
     BLEHubChannelController(MCChannelConfig *config);
 
+    // Deletes the speed controller of the channel.
+    ~BLEHubChannelController();
+
     // Returns the controlled hub channel.
     BLEHubChannel GetHubChannel();
+
+    // Compiles the channel's speed curve into lookup tables of raw hub pwr values, using the given function to map a fixed-point pwr (in 1/256 %, negative when driving in reverse) to a raw hub pwr value.
+    void CompileRawPwrTables(std::function<int16_t(int32_t)> mapPwrToRaw);
+
+    // Returns the raw hub pwr value for the current pwr percentage (or for the pwr percentage determined by the speed controller, when speed controlled).
+    uint8_t GetRawCurrentPwr();
+
+    // Enables closed-loop speed control with the given tuning, once an encoder is attached to the channel.
+    void EnableSpeedControl(MCSpeedControlConfig config);
+
+    // Returns a boolean value indicating whether closed-loop speed control is enabled for the channel.
+    bool IsSpeedControlEnabled();
+
+    // Returns a boolean value indicating whether the channel is currently speed controlled (speed control enabled and encoder attached).
+    bool IsSpeedControlled();
+
+    // Sets whether a motor with an encoder is attached to the channel.
+    void SetEncoderAttached(bool attached);
+
+    // Returns a boolean value indicating whether we still need to subscribe to the speed reported by the attached encoder.
+    bool NeedsEncoderSubscription();
+
+    // Marks the subscription to the speed reported by the attached encoder as done.
+    void SetEncoderSubscribed();
+
+    // Sets the speed percentage measured by the attached encoder.
+    void SetMeasuredSpeedPerc(int8_t measuredSpeedPerc);
+
+    // Returns the speed percentage last measured by the attached encoder.
+    int8_t GetMeasuredSpeedPerc();
+
+    // Updates the speed controller with the current pwr percentage as target speed (to be used in the drive loop after updating the current pwr).
+    void UpdateSpeedControl();
+
+    // Returns the speed controller (nullptr when speed control isn't enabled).
+    MCSpeedController *GetSpeedController();
+
+  private:
+    // Raw hub pwr values for every absolute pwr percentage when driving forward.
+    uint8_t _rawPwrForward[SPEED_CURVE_TABLE_SIZE];
+
+    // Raw hub pwr values for every absolute pwr percentage when driving in reverse.
+    uint8_t _rawPwrReverse[SPEED_CURVE_TABLE_SIZE];
+
+    // Closed-loop speed controller (nullptr = open-loop).
+    MCSpeedController *_speedController;
+
+    // Encoder state, updated from the BLE notification callback.
+    volatile bool _encoderAttached;
+    volatile bool _encoderSubscribed;
+    volatile int8_t _measuredSpeedPerc;
+
+    // Pwr percentage determined by the speed controller.
+    int16_t _controlledPwrPerc;
+    unsigned long _lastSpeedControlUpdate;
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <Arduino.h>
 
 #include "MCChannelConfig.h"
+#include "MCSpeedController.h"
 #include "NimBLEAddress.h"
 #include <vector>
 
@@ -14,20 +15,25 @@ enum BLEHubType {
     SBrick
 };
 
-// String switch paridgam
-struct bleHubTypeMap : public std::map<std::string, BLEHubType> {
-    bleHubTypeMap()
-    {
-        this->operator[]("PU") = BLEHubType::PU;
-        this->operator[]("SBrick") = BLEHubType::SBrick;
-    };
-    ~bleHubTypeMap() {}
+// Config names of the BLEHubType values.
+constexpr MCEnumName<BLEHubType> bleHubTypeNames[] = {
+    {"PU", BLEHubType::PU},
+    {"SBrick", BLEHubType::SBrick},
 };
 
+// Returns the BLEHubType with the given config name (PU if unknown).
+inline BLEHubType parseBleHubType(const std::string &name)
+{
+    return lookupEnumName(bleHubTypeNames, name, BLEHubType::PU);
+}
+
 class BLEHubConfiguration
 {
   public:
-    BLEHubConfiguration(BLEHubType hubType, std::string deviceAddress, std::vector<MCChannelConfig *> channels);
+    BLEHubConfiguration(BLEHubType hubType, std::string deviceAddress, std::vector<MCChannelConfig *> channels, MCSpeedControlConfig *speedControl);
+
+    // Deletes the address and channels. The speed control tuning may be shared by the hubs of a loco, so it's deleted by the loco.
+    ~BLEHubConfiguration();
 
     // Type of Hub.
     BLEHubType HubType;
@@ -37,4 +43,7 @@ class BLEHubConfiguration
 
     // Hub channels.
     std::vector<MCChannelConfig *> Channels;
+
+    // Tuning of the closed-loop speed control of motors with encoders (nullptr = open-loop).
+    MCSpeedControlConfig *SpeedControl;
 };
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "BLEHub.h"
+#include "NimBLEAddress.h"
+
+// Registry of all configured BLE hubs, keyed by their MAC address packed into 48 bits.
+// Hubs can be added and removed (when the config is reloaded) while a scan looks them up on the NimBLE host task.
+class BLEHubRegistry
+{
+  public:
+    BLEHubRegistry();
+
+    // Adds the given hub to the registry.
+    void Add(BLEHub *hub);
+
+    // Removes the given hub from the registry.
+    void Remove(BLEHub *hub);
+
+    // Returns the hub with the given address, or nullptr if the address doesn't belong to a configured hub.
+    BLEHub *Find(const NimBLEAddress &address);
+
+    // Returns the number of hubs in the registry.
+    uint Size();
+
+    // Returns the number of unknown devices seen during discovery.
+    uint32_t GetUnknownDeviceCount();
+
+    // Counts an unknown device seen during discovery.
+    void CountUnknownDevice();
+
+    // Returns the given MAC address packed into the lower 48 bits of an integer.
+    static uint64_t PackAddress(const NimBLEAddress &address);
+
+  private:
+    // Hubs by packed MAC address.
+    std::unordered_map<uint64_t, BLEHub *> _hubs;
+
+    // Mutex guarding the hubs map.
+    SemaphoreHandle_t _lock;
+
+    // Number of unknown devices seen during discovery.
+    uint32_t _unknownDeviceCount;
+};
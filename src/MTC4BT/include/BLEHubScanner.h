@@ -1,13 +1,14 @@
 #pragma once
 
 #include "BLEHub.h"
+#include "BLEHubRegistry.h"
 #include "NimBLEDevice.h"
 #include <Arduino.h>
 
 class BLEHubScanner
 {
   public:
-    BLEHubScanner();
+    BLEHubScanner(BLEHubRegistry *registry);
 
     // Public members
 
@@ -20,6 +21,9 @@ class BLEHubScanner
     // Reference to the BLE scanner used by this controller.
     NimBLEScan *_scanner;
 
+    // Reference to the registry of all configured hubs.
+    BLEHubRegistry *_registry;
+
     // Reference to the device callback.
     NimBLEAdvertisedDeviceCallbacks *_advertisedDeviceCallback;
 
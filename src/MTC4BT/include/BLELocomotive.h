@@ -5,6 +5,7 @@
 #include "BLEHub.h"
 #include "BLELocomotiveConfiguration.h"
 #include "MCLedBase.h"
+#include "MCTriggerIndex.h"
 #include "MController.h"
 
 class BLELocomotive
@@ -12,6 +13,12 @@ class BLELocomotive
   public:
     BLELocomotive(BLELocomotiveConfiguration *config, MController *controller);
 
+    // Creates a loco from a reloaded config, taking over the given hubs of the loco it replaces wherever their config allows it (so they stay connected).
+    BLELocomotive(BLELocomotiveConfiguration *config, MController *controller, std::vector<BLEHub *> reusableHubs);
+
+    // Deletes the loco's trigger index. The hubs and the config aren't deleted, as a reloaded loco may take over (some of) them.
+    ~BLELocomotive();
+
     // List of references to hubs inside this loco.
     std::vector<BLEHub *> Hubs;
 
@@ -22,7 +29,16 @@ class BLELocomotive
     void Drive(const int16_t minSpeed, const int16_t pwrPerc);
 
     // Triggers the given event for this loco.
-    void TriggerEvent(MCTriggerSource source, std::string eventType, std::string eventId, std::string value);
+    void TriggerEvent(MCTriggerSource source, const char *eventType, const char *eventId, const char *value);
+
+    // Returns the number of distinct triggers in the loco's trigger index.
+    uint GetTriggerCount();
+
+    // Returns the number of events dispatched to the loco.
+    uint32_t GetTriggerDispatchCount();
+
+    // Returns the max. time (in µs) it took to look up the actions of a dispatched event.
+    ulong GetMaxTriggerLookupTimeInUs();
 
     // Makes all channels on all hubs with lights attached blink for the given duration.
     void BlinkLights(int durationInMs);
@@ -50,8 +66,8 @@ class BLELocomotive
     // Initialized the leds inside this loco.
     // void initLights();
 
-    // Initialized the hubs inside this loco.
-    void initHubs();
+    // Initialized the hubs inside this loco, taking over the given hubs where possible.
+    void initHubs(std::vector<BLEHub *> reusableHubs);
 
     void handleConnectCallback(bool connected);
 
@@ -59,6 +75,12 @@ class BLELocomotive
     // If false, releases the manual brake, returning the loco to normal operations.
     void setManualBrake(const bool enabled);
 
+    // Executes the given action on the hub or controller it belongs to.
+    void executeAction(MCLocoAction *action);
+
+    // Timer wheel callback executing a delayed action.
+    static void executeDelayedAction(void *owner, void *payload);
+
     // Returns a reference to a hub by its address.
     BLEHub *getHubByAddress(std::string address);
 
@@ -73,4 +95,10 @@ class BLELocomotive
 
     // Reference to the controller controling this loco.
     MController *_controller;
+
+    // Index of the loco's event triggers, compiled from the config.
+    MCTriggerIndex *_triggerIndex;
+
+    uint32_t _triggerDispatchCount;
+    ulong _maxTriggerLookupTimeInUs;
 };
\ No newline at end of file
@@ -8,6 +8,9 @@ class BLELocomotiveConfiguration
   public:
     BLELocomotiveConfiguration(uint address, std::string name, std::vector<BLEHubConfiguration *> hubs, std::vector<MCLocoEvent *> events);
 
+    // Deletes the hubs (and their speed control tuning and speed curves) and events.
+    ~BLELocomotiveConfiguration();
+
     uint _address;
     std::string _name;
     std::vector<BLEHubConfiguration *> _hubs;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ArduinoJson.h>
+#include "MCJsonConfig.h"
 #include "log4MC.h"
 #include "MTC4BTConfiguration.h"
 
@@ -8,5 +9,6 @@ class BLELocomotiveDeserializer
 {
   public:
     // Reads a loco configuration JSON document of max. 4k.
-    static BLELocomotiveConfiguration *Deserialize(JsonObject locoConfig, std::vector<MCChannelConfig *> espPins, int16_t defaultPwrIncStep, int16_t defaultPwrDecStep);
+    // Invalid parts (duplicate hubs or channels, actions referring to unknown hubs, channels or pins) are logged as errors, counted in the given error count and skipped.
+    static BLELocomotiveConfiguration *Deserialize(JsonObject locoConfig, std::vector<MCChannelConfig *> espPins, int16_t defaultPwrIncRate, int16_t defaultPwrDecRate, int16_t defaultPwrJerk, uint &errorCount);
 };
\ No newline at end of file
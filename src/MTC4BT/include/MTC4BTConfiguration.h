@@ -5,6 +5,11 @@
 
 struct MTC4BTConfiguration : MCConfiguration {
   public:
+    // Default ramping rates (in %/s) and jerk (in %/s², 0 = linear ramping) of the controller, also used for locos reloaded over MQTT.
+    int16_t PwrIncRate;
+    int16_t PwrDecRate;
+    int16_t PwrJerk;
+
     // BLE locomotive configurations.
     std::vector<BLELocomotiveConfiguration *> Locomotives;
 };
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "MCBinaryReader.h"
+#include "MCBinaryWriter.h"
+#include "MTC4BTConfiguration.h"
+
+// Magic number identifying a controller config cache file ("MCBC").
+#define CONFIG_CACHE_MAGIC 0x4342434D
+
+// Version of the cache file format. Bump it whenever the format, or the way the JSON config is interpreted (e.g. its defaults), changes.
+#define CONFIG_CACHE_VERSION 2
+
+// Compiled binary form of the controller configuration, so we don't have to parse the JSON config files at every boot.
+// The cache records the size and checksum of every JSON config file it was compiled from, and is ignored once any of them changes.
+class MTC4BTConfigurationCache
+{
+  public:
+    // Returns the configuration read from the given cache file, or nullptr if there's no valid, up-to-date cache.
+    static MTC4BTConfiguration *Load(const char *cacheFilePath);
+
+    // Writes the given configuration, compiled from the given JSON config files, to the given cache file.
+    static bool Save(const char *cacheFilePath, MTC4BTConfiguration *config, const std::vector<std::string> &sourceFilePaths);
+
+  private:
+    static bool checksumFile(const char *filePath, uint32_t *size, uint32_t *checksum);
+    static uint32_t checksum(const uint8_t *data, size_t size, uint32_t crc = 0);
+
+    static void writeChannelConfig(MCBinaryWriter &writer, MCChannelConfig *channelConfig, std::vector<MCSpeedCurve *> &speedCurves);
+    static bool writeLocomotive(MCBinaryWriter &writer, BLELocomotiveConfiguration *loco, std::vector<MCChannelConfig *> &espPins, std::vector<MCSpeedCurve *> &speedCurves);
+    static MCChannelConfig *readChannelConfig(MCBinaryReader &reader, std::vector<MCSpeedCurve *> &speedCurves);
+    static BLELocomotiveConfiguration *readLocomotive(MCBinaryReader &reader, std::vector<MCChannelConfig *> &espPins, std::vector<MCSpeedCurve *> &speedCurves);
+
+    // Deletes a config read from the cache (when the cache turns out not to match its format), including its speed curves.
+    static void deleteConfiguration(MTC4BTConfiguration *config, std::vector<MCSpeedCurve *> &speedCurves);
+};
\ No newline at end of file
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <ArduinoJson.h>
+
+#include "BLEHubRegistry.h"
 #include "BLEHubScanner.h"
 #include "BLELocomotive.h"
 #include "MController.h"
@@ -12,8 +15,12 @@ class MTC4BTController : public MController
     MTC4BTController();
 
     // Locomotives under control of this controller.
+    // Only changed by the MQTT message handler task (when reloading a loco), other tasks should use GetLocomotives().
     std::vector<BLELocomotive *> Locomotives;
 
+    // Returns a snapshot of the locomotives under control of this controller (safe to use from any task).
+    std::vector<BLELocomotive *> GetLocomotives();
+
     // Controller setup.
     void Setup(MTC4BTConfiguration *config);
 
@@ -30,21 +37,54 @@ class MTC4BTController : public MController
     void HandleLc(int locoAddress, int speed, int minSpeed, int maxSpeed, char *mode, bool dirForward);
 
     // Handles the given trigger (if loco is under control of this controller).
-    void HandleTrigger(int locoAddress, MCTriggerSource source, std::string eventType, std::string eventId, std::string value);
+    void HandleTrigger(int locoAddress, MCTriggerSource source, const char *eventType, const char *eventId, const char *value);
+
+    // Adds, replaces or removes (if not enabled) the loco with the address in the given loco config, without touching the other locos.
+    // Hubs of a replaced loco stay connected, unless their type, channels or speed control changed.
+    void ReloadLocomotive(JsonObject locoConfig);
 
   private:
     // Discovers new BLE devices.
     static void discoveryLoop(void *parm);
 
+    // Handles a successful (re)connect to one of the hubs of the given loco.
+    static void handleHubConnected(BLELocomotive *loco);
+
+    // Returns a boolean value indicating whether any hub is reconnecting directly after it dropped its connection.
+    bool hasReconnectingHubs();
+
     // Initializes locomotives with the given configuration.
     void initLocomotives(std::vector<BLELocomotiveConfiguration *> locoConfigs);
 
     // Returns the locomotive with the given address.
     BLELocomotive *getLocomotive(uint address);
 
+    // Returns a boolean value indicating whether the hubs of the given loco config can be added to the hubs of the other locos.
+    bool checkHubs(BLELocomotiveConfiguration *locoConfig);
+
+    // Deletes the locos replaced or removed by a reload, once their removed hubs are idle and no other task uses them anymore.
+    void deleteRetiredLocomotives();
+
+    // A loco replaced or removed by a reload, together with its config and the hubs that were removed with it.
+    struct RetiredLocomotive {
+        BLELocomotive *Loco;
+        BLELocomotiveConfiguration *Config;
+        std::vector<BLEHub *> Hubs;
+        ulong RetiredAt;
+    };
+
+    // Locos replaced or removed by a reload, waiting to be deleted.
+    std::vector<RetiredLocomotive> _retiredLocomotives;
+
     // Reference to the configuration of this controller.
     MTC4BTConfiguration *_config;
 
+    // Reference to the registry of all hubs under control of this controller.
+    BLEHubRegistry *_hubRegistry;
+
     // Reference to the BLE Hub scanner used by this controller.
     BLEHubScanner *_hubScanner;
+
+    // Mutex guarding changes to the list of locomotives (and the list of retired locomotives).
+    SemaphoreHandle_t _locomotivesLock;
 };
\ No newline at end of file
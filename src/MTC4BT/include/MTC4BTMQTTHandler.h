@@ -16,4 +16,5 @@ class MTC4BTMQTTHandler
     static void handleSys(const char *message, MTC4BTController *controller);
     static void handleLc(const char *message, MTC4BTController *controller);
     static void handleFn(const char *message, MTC4BTController *controller);
+    static void handleConfig(const char *message, MTC4BTController *controller);
 };
\ No newline at end of file
@@ -12,13 +12,16 @@
 #define PU_MAX_SPEED_REVERSE 128
 #define PU_MIN_SPEED_REVERSE 255
 
+// Mode in which motors with encoders report their speed (in % of their max. speed).
+#define PU_MOTOR_MODE_SPEED 0x01
+
 class PUHub : public BLEHub
 {
   public:
     PUHub(BLEHubConfiguration *config);
     bool SetWatchdogTimeout(const uint8_t watchdogTimeOutInTensOfSeconds);
     void DriveTaskLoop();
-    int16_t MapPwrPercToRaw(int pwrPerc);
+    int16_t MapPwrToRaw(int32_t pwr);
 
     /**
      * @brief Callback function for notifications of a specific characteristic
@@ -33,6 +36,9 @@ class PUHub : public BLEHub
     byte _hubLedPort;
 
     void parsePortMessage(uint8_t *pData);
+    void parseSensorMessage(uint8_t *pData);
+    void subscribeToEncoder(BLEHubChannel channel);
+    bool isMotorWithEncoder(byte ioType);
     void setLedColor(HubLedColor color);
     void setLedHSVColor(int hue, double saturation, double value);
     void setLedRGBColor(char red, char green, char blue);
@@ -13,7 +13,7 @@ class SBrickHub : public BLEHub
     SBrickHub(BLEHubConfiguration *config);
     bool SetWatchdogTimeout(const uint8_t watchdogTimeOutInTensOfSeconds);
     void DriveTaskLoop();
-    int16_t MapPwrPercToRaw(int pwrPerc);
+    int16_t MapPwrToRaw(int32_t pwr);
 
     /**
      * @brief Callback function for notifications of a specific characteristic
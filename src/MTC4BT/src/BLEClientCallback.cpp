@@ -26,12 +26,24 @@ void BLEClientCallback::onDisconnect(NimBLEClient *client)
     if (client->getPeerAddress().equals(*_hub->_config->DeviceAddress)) {
         log4MC::vlogf(LOG_ERR, "BLE : Disconnected from hub '%s'.", _hub->_config->DeviceAddress->toString().c_str());
 
-        _hub->_isDiscovered = false;
-        _hub->disconnected();
-
-        if (_hub->_driveTaskHandle != NULL)
-        {
+        if (_hub->_driveTaskHandle != NULL) {
+            // Stop the drive task between two passes.
+            xSemaphoreTake(_hub->_driveLock, portMAX_DELAY);
             vTaskDelete(_hub->_driveTaskHandle);
+            _hub->_driveTaskHandle = NULL;
+            xSemaphoreGive(_hub->_driveLock);
+
+            if (!_hub->_isRetired) {
+                // The hub dropped an established connection. Reconnect to its known address directly, before falling back to scanning.
+                _hub->startReconnect();
+            }
+        } else if (!_hub->_isReconnecting) {
+            _hub->_isDiscovered = false;
         }
+
+        _hub->disconnected();
+
+        // A retired hub can be deleted from now on.
+        _hub->_isDisconnecting = false;
     }
 }
\ No newline at end of file
@@ -4,26 +4,32 @@
 #include "log4MC.h"
 #include <Arduino.h>
 
-BLEDeviceCallbacks::BLEDeviceCallbacks(std::vector<BLEHub *> hubs) : NimBLEAdvertisedDeviceCallbacks()
+BLEDeviceCallbacks::BLEDeviceCallbacks(BLEHubRegistry *registry) : NimBLEAdvertisedDeviceCallbacks()
 {
-    _hubs = hubs;
+    _registry = registry;
 }
 
 // Called for each advertising BLE server.
+// Runs on the NimBLE host task, so keep it short: one registry lookup and no string formatting for unknown devices.
 void BLEDeviceCallbacks::onResult(NimBLEAdvertisedDevice *advertisedDevice)
 {
     // We have found a device, let's see if it has an address we are looking for.
-    for (BLEHub *hub : _hubs) {
-        if (advertisedDevice->getAddress().equals(*hub->_config->DeviceAddress)) {
-            log4MC::vlogf(LOG_INFO, "BLE : Discovered hub: %s (%s).", advertisedDevice->getName().c_str(), advertisedDevice->getAddress().toString().c_str());
+    BLEHub *hub = _registry->Find(advertisedDevice->getAddress());
 
-            hub->_advertisedDevice = advertisedDevice;
-            hub->_isDiscovered = true;
+    if (hub == nullptr) {
+        // Unknown device, ignore it from now on.
+        _registry->CountUnknownDevice();
+        NimBLEDevice::addIgnored(advertisedDevice->getAddress());
+        return;
+    }
 
-            return;
-        }
+    if (hub->_isDiscovered || hub->_isConnected || hub->_isReconnecting) {
+        // Hub is already taken care of.
+        return;
     }
 
-    log4MC::vlogf(LOG_INFO, "BLE : Discovered unknown device: %s (%s).", advertisedDevice->getName().c_str(), advertisedDevice->getAddress().toString().c_str());
-    NimBLEDevice::addIgnored(advertisedDevice->getAddress());
-}
\ No newline at end of file
+    log4MC::vlogf(LOG_INFO, "BLE : Discovered hub: %s (%s).", advertisedDevice->getName().c_str(), advertisedDevice->getAddress().toString().c_str());
+
+    hub->_advertisedDevice = advertisedDevice;
+    hub->_isDiscovered = true;
+}
@@ -15,20 +15,48 @@ BLEHub::BLEHub(BLEHubConfiguration *config)
     initChannelControllers();
 
     _driveTaskHandle = NULL;
+    _driveLock = xSemaphoreCreateMutex();
     _hub = nullptr;
     _advertisedDeviceCallback = nullptr;
     _clientCallback = nullptr;
+    _mbrake = true;
     _ebrake = false;
     _blinkLights = false;
     _blinkUntil = 0;
     _isDiscovered = false;
     _isConnected = false;
+    _isReconnecting = false;
+    _isRetired = false;
+    _isDisconnecting = false;
+    _reconnectAttempts = 0;
+    _nextReconnectAttemptAt = 0;
+    _droppedAt = 0;
+    _dropoutCount = 0;
+    _lastRecoveryTimeInMs = 0;
+    _fallbackScanCount = 0;
+    _maxDriveLoopTimeInUs = 0;
+    _totalDriveLoopTimeInUs = 0;
+    _driveLoopCount = 0;
     _remoteControlService = nullptr;
     _remoteControlCharacteristic = nullptr;
     // _genericAccessCharacteristic = nullptr;
     // _deviceInformationCharacteristic = nullptr;
 }
 
+BLEHub::~BLEHub()
+{
+    if (_hub) {
+        NimBLEDevice::deleteClient(_hub);
+    }
+    delete _clientCallback;
+
+    for (BLEHubChannelController *controller : _channelControllers) {
+        delete controller;
+    }
+
+    vSemaphoreDelete(_driveLock);
+}
+
 bool BLEHub::IsDiscovered()
 {
     return _isDiscovered;
@@ -72,7 +100,7 @@ int16_t BLEHub::GetCurrentDrivePwrPerc()
 
 void BLEHub::Execute(MCLocoAction *action)
 {
-    BLEHubChannelController *controller = findControllerByChannel(bleHubChannelMap()[action->GetChannel()->GetAddress()]);
+    BLEHubChannelController *controller = findControllerByChannel((BLEHubChannel)action->GetChannel()->GetResolvedAddress());
 
     if (controller) {
         if (controller->GetHubChannel() == BLEHubChannel::OnboardLED) {
@@ -143,7 +171,13 @@ bool BLEHub::Connect(const uint8_t watchdogTimeOutInTensOfSeconds)
          *  second argument in connect() to prevent refreshing the service database.
          *  This saves considerable time and power.
          */
-        _hub = NimBLEDevice::getClientByPeerAddress(_advertisedDevice->getAddress());
+        NimBLEClient *client = NimBLEDevice::getClientByPeerAddress(_advertisedDevice->getAddress());
+        if (client && client != _hub) {
+            // The client belongs to a hub with the same address that was removed from the config. Wait until that hub is deleted.
+            _isDiscovered = false;
+            return false;
+        }
+        _hub = client;
         if (_hub) {
             if (!_hub->connect(_advertisedDevice, false)) {
                 /* Serial.println("Reconnect failed"); */
@@ -154,12 +188,9 @@ bool BLEHub::Connect(const uint8_t watchdogTimeOutInTensOfSeconds)
             _isConnected = true;
             log4MC::vlogf(LOG_INFO, "BLE : Reconnected to hub '%s'...", _config->DeviceAddress->toString().c_str());
         }
-        /** We don't already have a client that knows this device,
-         *  we will check for a client that is disconnected that we can use.
+        /** We don't take over disconnected clients of other hubs, as their callbacks belong to
+         *  that hub, and a hub that was removed from the config deletes its client.
          */
-        else {
-            _hub = NimBLEDevice::getDisconnectedClient();
-        }
     }
 
     /** No client to reuse? Create a new one. */
@@ -198,11 +229,148 @@ bool BLEHub::Connect(const uint8_t watchdogTimeOutInTensOfSeconds)
         }
     }
 
+    return completeConnect(watchdogTimeOutInTensOfSeconds);
+}
+
+bool BLEHub::IsReconnecting()
+{
+    return _isReconnecting;
+}
+
+bool BLEHub::IsReconnectDue()
+{
+    return _isReconnecting && (long)(millis() - _nextReconnectAttemptAt) >= 0;
+}
+
+bool BLEHub::Reconnect(const uint8_t watchdogTimeOutInTensOfSeconds)
+{
+    _reconnectAttempts++;
+
+    log4MC::vlogf(LOG_INFO, "BLE : Reconnecting to hub '%s' (attempt %u of %u)...", _config->DeviceAddress->toString().c_str(), _reconnectAttempts, MaxReconnectAttempts);
+
+    if (_hub) {
+        /** We still have the client that knows this device, so we connect to its address directly and
+         *  send false as the second argument in connect() to prevent refreshing the service database.
+         *  A short connect timeout keeps a hub that is out of range from blocking the other hubs.
+         */
+        _hub->setConnectTimeout(ReconnectDelayInSeconds);
+        bool linkUp = _hub->isConnected() || _hub->connect(*_config->DeviceAddress, false);
+        _hub->setConnectTimeout(ConnectDelayInSeconds);
+
+        if (linkUp && completeConnect(watchdogTimeOutInTensOfSeconds)) {
+            return true;
+        }
+    }
+
+    if (_reconnectAttempts >= MaxReconnectAttempts) {
+        // Directed reconnects failed. Fall back to scanning for the hub.
+        log4MC::vlogf(LOG_WARNING, "BLE : Failed to reconnect to hub '%s', falling back to scanning.", _config->DeviceAddress->toString().c_str());
+        _isReconnecting = false;
+        _isDiscovered = false;
+        _fallbackScanCount++;
+        return false;
+    }
+
+    // Back off exponentially before the next attempt.
+    _nextReconnectAttemptAt = millis() + (ReconnectBackoffInMs << (_reconnectAttempts - 1));
+    return false;
+}
+
+uint32_t BLEHub::GetDropoutCount()
+{
+    return _dropoutCount;
+}
+
+ulong BLEHub::GetLastRecoveryTimeInMs()
+{
+    return _lastRecoveryTimeInMs;
+}
+
+uint32_t BLEHub::GetFallbackScanCount()
+{
+    return _fallbackScanCount;
+}
+
+ulong BLEHub::GetMaxDriveLoopTimeInUs()
+{
+    return _maxDriveLoopTimeInUs;
+}
+
+ulong BLEHub::GetAvgDriveLoopTimeInUs()
+{
+    return _driveLoopCount == 0 ? 0 : _totalDriveLoopTimeInUs / _driveLoopCount;
+}
+
+std::vector<BLEHubChannelController *> BLEHub::GetChannelControllers()
+{
+    return _channelControllers;
+}
+
+bool BLEHub::Reconfigure(BLEHubConfiguration *config)
+{
+    if (config->HubType != _config->HubType || !config->DeviceAddress->equals(*_config->DeviceAddress) || config->Channels.size() != _channelControllers.size()) {
+        return false;
+    }
+
+    if ((config->SpeedControl == nullptr) != (_config->SpeedControl == nullptr) ||
+        (config->SpeedControl && (config->SpeedControl->Kp != _config->SpeedControl->Kp || config->SpeedControl->Ki != _config->SpeedControl->Ki))) {
+        return false;
+    }
+
+    for (int i = 0; i < _channelControllers.size(); i++) {
+        if (config->Channels[i]->GetChannel()->GetResolvedAddress() != _channelControllers[i]->GetHubChannel() ||
+            config->Channels[i]->GetAttachedDeviceType() != _channelControllers[i]->GetAttachedDevice()) {
+            return false;
+        }
+    }
+
+    // Only the way the channels are driven changed, so we can swap their configs between two passes of the drive task.
+    xSemaphoreTake(_driveLock, portMAX_DELAY);
+    for (int i = 0; i < _channelControllers.size(); i++) {
+        _channelControllers[i]->SetConfig(config->Channels[i]);
+    }
+    _config = config;
+    compileRawPwrTables();
+    xSemaphoreGive(_driveLock);
+
+    return true;
+}
+
+void BLEHub::Retire()
+{
+    _isRetired = true;
+    _isReconnecting = false;
+    SetEmergencyBrake(true);
+
+    if (_hub && _hub->isConnected()) {
+        log4MC::vlogf(LOG_INFO, "BLE : Disconnecting from hub '%s', as it was removed from the config.", _config->DeviceAddress->toString().c_str());
+        disconnect();
+    }
+}
+
+bool BLEHub::IsRetired()
+{
+    return _isRetired;
+}
+
+bool BLEHub::IsIdle()
+{
+    return _isRetired && !_isDisconnecting && !_isConnected && _driveTaskHandle == NULL && !(_hub && _hub->isConnected());
+}
+
+bool BLEHub::completeConnect(const uint8_t watchdogTimeOutInTensOfSeconds)
+{
+    if (_isRetired) {
+        // The hub was removed from the config while we were connecting.
+        disconnect();
+        return false;
+    }
+
     // Try to obtain a reference to the remote control characteristic in the remote control service of the BLE server.
     // If we can set the watchdog timeout, we consider our connection attempt a success.
     if (!SetWatchdogTimeout(watchdogTimeOutInTensOfSeconds)) {
         // Failed to find the remote control service or characteristic or write/read the value.
-        _hub->disconnect();
+        disconnect();
         return false;
     }
 
@@ -212,20 +380,70 @@ bool BLEHub::Connect(const uint8_t watchdogTimeOutInTensOfSeconds)
     }
 
     // Start drive task loop.
-    return startDriveTask();
+    if (!startDriveTask()) {
+        return false;
+    }
+
+    if (_droppedAt != 0) {
+        // We recovered from a dropout.
+        _lastRecoveryTimeInMs = millis() - _droppedAt;
+        _droppedAt = 0;
+        log4MC::vlogf(LOG_INFO, "BLE : Recovered hub '%s' in %lu ms (dropouts: %u, fallback scans: %u).", _config->DeviceAddress->toString().c_str(), _lastRecoveryTimeInMs, _dropoutCount, _fallbackScanCount);
+    }
+
+    _isReconnecting = false;
+    _reconnectAttempts = 0;
+
+    return true;
 }
 
-void BLEHub::initChannelControllers()
+void BLEHub::startReconnect()
 {
-    // TODO: This method should be made more robust to prevent config errors, like configuring the same channel twice.
+    _dropoutCount++;
+    _droppedAt = millis();
+
+    // First directed reconnect attempt is due immediately.
+    _isReconnecting = true;
+    _reconnectAttempts = 0;
+    _nextReconnectAttemptAt = _droppedAt;
+}
 
+void BLEHub::initChannelControllers()
+{
+    // Duplicate channels are rejected when loading the config.
     for (MCChannelConfig *config : _config->Channels) {
-        _channelControllers.push_back(new BLEHubChannelController(config));
+        BLEHubChannelController *controller = new BLEHubChannelController(config);
+
+        if (_config->SpeedControl && config->GetAttachedDeviceType() == DeviceType::Motor) {
+            // Motors run closed-loop as soon as the hub reports an encoder on their channel.
+            controller->EnableSpeedControl(*_config->SpeedControl);
+        }
+
+        _channelControllers.push_back(controller);
     }
 
     // log4MC::vlogf(LOG_INFO, "BLE : Hub %s channels initialized.", _config->DeviceAddress->toString().c_str());
 }
 
+void BLEHub::compileRawPwrTables()
+{
+    // Must be called from the constructor of the derived hub class, because the mapping to raw values is hub specific.
+    for (BLEHubChannelController *controller : _channelControllers) {
+        controller->CompileRawPwrTables([this](int32_t pwr) { return MapPwrToRaw(pwr); });
+    }
+}
+
+void BLEHub::recordDriveLoopTime(ulong startedAt)
+{
+    ulong loopTime = micros() - startedAt;
+
+    _totalDriveLoopTimeInUs += loopTime;
+    _driveLoopCount++;
+    if (loopTime > _maxDriveLoopTimeInUs) {
+        _maxDriveLoopTimeInUs = loopTime;
+    }
+}
+
 void BLEHub::setTargetPwrPercByAttachedDevice(DeviceType device, int16_t minPwrPerc, int16_t pwrPerc)
 {
     for (BLEHubChannelController *channel : _channelControllers) {
@@ -253,7 +471,7 @@ uint8_t BLEHub::getRawChannelPwrForController(BLEHubChannelController *controlle
         return MCLightController::Blink() ? 50 : 0;
     }
 
-    return MapPwrPercToRaw(controller->GetCurrentPwrPerc());
+    return controller->GetRawCurrentPwr();
 }
 
 BLEHubChannelController *BLEHub::findControllerByChannel(BLEHubChannel channel)
@@ -300,6 +518,16 @@ void BLEHub::driveTaskImpl(void *_this)
     ((BLEHub *)_this)->DriveTaskLoop();
 }
 
+void BLEHub::disconnect()
+{
+    // A retired hub isn't idle until the client callback handled the disconnect.
+    _isDisconnecting = _isRetired;
+    if (_hub->disconnect() != 0 && !_hub->isConnected()) {
+        // Not connected (anymore), so there's no disconnect left to handle.
+        _isDisconnecting = false;
+    }
+}
+
 void BLEHub::connected()
 {
     this->_isConnected = true;
@@ -1,9 +1,113 @@
 #include "BLEHubChannelController.h"
 
 BLEHubChannelController::BLEHubChannelController(MCChannelConfig *config)
-    : MCChannelController(config) {}
+    : MCChannelController(config)
+{
+    memset(_rawPwrForward, 0, sizeof(_rawPwrForward));
+    memset(_rawPwrReverse, 0, sizeof(_rawPwrReverse));
+
+    _speedController = nullptr;
+    _encoderAttached = false;
+    _encoderSubscribed = false;
+    _measuredSpeedPerc = 0;
+    _controlledPwrPerc = 0;
+    _lastSpeedControlUpdate = 0;
+}
+
+BLEHubChannelController::~BLEHubChannelController()
+{
+    delete _speedController;
+}
 
 BLEHubChannel BLEHubChannelController::GetHubChannel()
 {
-    return bleHubChannelMap()[_config->GetChannel()->GetAddress()];
+    return (BLEHubChannel)_config->GetChannel()->GetResolvedAddress();
+}
+
+void BLEHubChannelController::CompileRawPwrTables(std::function<int16_t(int32_t)> mapPwrToRaw)
+{
+    MCSpeedCurve *speedCurve = _config->GetSpeedCurve();
+
+    for (uint8_t pwrPerc = 0; pwrPerc < SPEED_CURVE_TABLE_SIZE; pwrPerc++) {
+        // Without a speed curve, pwr maps linearly to the raw hub pwr.
+        int32_t pwr = speedCurve ? speedCurve->GetPwr(pwrPerc) : pwrPerc << SPEED_CURVE_FIXED_POINT_BITS;
+
+        _rawPwrForward[pwrPerc] = mapPwrToRaw(pwr);
+        _rawPwrReverse[pwrPerc] = mapPwrToRaw(-pwr);
+    }
+}
+
+uint8_t BLEHubChannelController::GetRawCurrentPwr()
+{
+    int16_t pwrPerc = IsSpeedControlled() ? _controlledPwrPerc : GetCurrentPwrPerc();
+
+    return pwrPerc >= 0 ? _rawPwrForward[pwrPerc] : _rawPwrReverse[-pwrPerc];
+}
+
+void BLEHubChannelController::EnableSpeedControl(MCSpeedControlConfig config)
+{
+    _speedController = new MCSpeedController(config);
+}
+
+bool BLEHubChannelController::IsSpeedControlEnabled()
+{
+    return _speedController != nullptr;
+}
+
+bool BLEHubChannelController::IsSpeedControlled()
+{
+    return _speedController && _encoderAttached;
+}
+
+void BLEHubChannelController::SetEncoderAttached(bool attached)
+{
+    // A (re)attached encoder always needs a new subscription.
+    _encoderSubscribed = false;
+    _encoderAttached = attached;
+}
+
+bool BLEHubChannelController::NeedsEncoderSubscription()
+{
+    return IsSpeedControlled() && !_encoderSubscribed;
+}
+
+void BLEHubChannelController::SetEncoderSubscribed()
+{
+    _encoderSubscribed = true;
+}
+
+void BLEHubChannelController::SetMeasuredSpeedPerc(int8_t measuredSpeedPerc)
+{
+    _measuredSpeedPerc = measuredSpeedPerc;
+}
+
+int8_t BLEHubChannelController::GetMeasuredSpeedPerc()
+{
+    return _measuredSpeedPerc;
+}
+
+void BLEHubChannelController::UpdateSpeedControl()
+{
+    unsigned long timeStamp = millis();
+    unsigned long elapsedInMs = _lastSpeedControlUpdate == 0 ? 0 : timeStamp - _lastSpeedControlUpdate;
+    _lastSpeedControlUpdate = timeStamp;
+
+    if (!IsSpeedControlled()) {
+        return;
+    }
+
+    int16_t targetSpeedPerc = GetCurrentPwrPerc();
+    if (targetSpeedPerc == 0) {
+        // Stopping (or braking) is never corrected, and we start from scratch when driving off again.
+        _speedController->Reset();
+        _controlledPwrPerc = 0;
+        return;
+    }
+
+    _controlledPwrPerc = _speedController->Update(targetSpeedPerc, _measuredSpeedPerc, elapsedInMs);
+}
+
+MCSpeedController *BLEHubChannelController::GetSpeedController()
+{
+    return _speedController;
 }
\ No newline at end of file
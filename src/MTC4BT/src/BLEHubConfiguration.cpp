@@ -1,8 +1,18 @@
 #include "BLEHubConfiguration.h"
 
-BLEHubConfiguration::BLEHubConfiguration(BLEHubType hubType, std::string deviceAddress, std::vector<MCChannelConfig *> channels)
+BLEHubConfiguration::BLEHubConfiguration(BLEHubType hubType, std::string deviceAddress, std::vector<MCChannelConfig *> channels, MCSpeedControlConfig *speedControl)
 {
     HubType = hubType;
     DeviceAddress = new NimBLEAddress(deviceAddress);
     Channels = channels;
+    SpeedControl = speedControl;
+}
+
+BLEHubConfiguration::~BLEHubConfiguration()
+{
+    delete DeviceAddress;
+
+    for (MCChannelConfig *channel : Channels) {
+        delete channel;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "BLEHubRegistry.h"
+
+BLEHubRegistry::BLEHubRegistry()
+{
+    _unknownDeviceCount = 0;
+    _lock = xSemaphoreCreateMutex();
+}
+
+void BLEHubRegistry::Add(BLEHub *hub)
+{
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _hubs[PackAddress(hub->GetAddress())] = hub;
+    xSemaphoreGive(_lock);
+}
+
+void BLEHubRegistry::Remove(BLEHub *hub)
+{
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    auto it = _hubs.find(PackAddress(hub->GetAddress()));
+    if (it != _hubs.end() && it->second == hub) {
+        _hubs.erase(it);
+    }
+    xSemaphoreGive(_lock);
+}
+
+BLEHub *BLEHubRegistry::Find(const NimBLEAddress &address)
+{
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    auto it = _hubs.find(PackAddress(address));
+    BLEHub *hub = it != _hubs.end() ? it->second : nullptr;
+    xSemaphoreGive(_lock);
+
+    return hub;
+}
+
+uint BLEHubRegistry::Size()
+{
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    uint size = _hubs.size();
+    xSemaphoreGive(_lock);
+
+    return size;
+}
+
+uint32_t BLEHubRegistry::GetUnknownDeviceCount()
+{
+    return _unknownDeviceCount;
+}
+
+void BLEHubRegistry::CountUnknownDevice()
+{
+    _unknownDeviceCount++;
+}
+
+uint64_t BLEHubRegistry::PackAddress(const NimBLEAddress &address)
+{
+    const uint8_t *native = address.getNative();
+
+    uint64_t packed = 0;
+    for (int i = 5; i >= 0; i--) {
+        packed = (packed << 8) | native[i];
+    }
+
+    return packed;
+}
@@ -4,8 +4,9 @@
 #include "BLEHubScanner.h"
 #include "log4MC.h"
 
-BLEHubScanner::BLEHubScanner()
+BLEHubScanner::BLEHubScanner(BLEHubRegistry *registry)
 {
+    _registry = registry;
     _advertisedDeviceCallback = nullptr;
     _isDiscovering = false;
 
@@ -39,13 +40,13 @@ void BLEHubScanner::StartDiscovery(std::vector<BLEHub *> &hubs, const uint32_t s
 
     // Set the callback we want to use to be informed when we have detected a new device.
     if (_advertisedDeviceCallback == nullptr) {
-        _advertisedDeviceCallback = new BLEDeviceCallbacks(hubs);
+        _advertisedDeviceCallback = new BLEDeviceCallbacks(_registry);
         _scanner->setAdvertisedDeviceCallbacks(_advertisedDeviceCallback, false);
     }
 
     _scanner->start(scanDurationInSeconds, false);
 
-    log4MC::vlogf(LOG_INFO, "BLE : Scanning for %u hub(s) aborted.", hubs.size());
+    log4MC::vlogf(LOG_INFO, "BLE : Scanning for %u hub(s) aborted (unknown devices ignored so far: %u).", hubs.size(), _registry->GetUnknownDeviceCount());
 
     // Discovery stopped.
     _isDiscovering = false;
@@ -6,9 +6,21 @@
 #include "log4MC.h"
 
 BLELocomotive::BLELocomotive(BLELocomotiveConfiguration *config, MController *controller)
+    : BLELocomotive(config, controller, {}) {}
+
+BLELocomotive::BLELocomotive(BLELocomotiveConfiguration *config, MController *controller, std::vector<BLEHub *> reusableHubs)
     : _config{config}, _controller{controller}
 {
-    initHubs();
+    initHubs(reusableHubs);
+
+    _triggerIndex = new MCTriggerIndex(_config->_events);
+    _triggerDispatchCount = 0;
+    _maxTriggerLookupTimeInUs = 0;
+}
+
+BLELocomotive::~BLELocomotive()
+{
+    delete _triggerIndex;
 }
 
 bool BLELocomotive::AllHubsConnected()
@@ -52,32 +64,51 @@ void BLELocomotive::Drive(const int16_t minSpeed, const int16_t pwrPerc)
     }
 }
 
-void BLELocomotive::TriggerEvent(MCTriggerSource source, std::string eventType, std::string eventId, std::string value)
-{
-    for (MCLocoEvent *event : _config->_events) {
-        if (event->HasTrigger(source, eventType, eventId, value)) {
-            for (MCLocoAction *action : event->GetActions()) {
-                ChannelType portType = action->GetChannel()->GetChannelType();
-                switch (portType) {
-                case ChannelType::BleHubChannel: {
-                    // Ask hub to execute action.
-                    BLEHub *hub = getHubByAddress(action->GetChannel()->GetParentAddress());
-                    if (hub) {
-                        hub->Execute(action);
-                    }
-                    break;
-                }
-                case ChannelType::EspPinChannel: {
-                    // Ask controller to execute action.
-                    _controller->Execute(action);
-                    break;
-                }
-                }
-            }
+void BLELocomotive::TriggerEvent(MCTriggerSource source, const char *eventType, const char *eventId, const char *value)
+{
+    ulong lookupStart = micros();
+    MCLocoActionSpan actions = _triggerIndex->Find(source, eventType, eventId, value);
+    ulong lookupTime = micros() - lookupStart;
+
+    _triggerDispatchCount++;
+    if (lookupTime > _maxTriggerLookupTimeInUs) {
+        _maxTriggerLookupTimeInUs = lookupTime;
+    }
+
+    if (actions.size() == 0) {
+        return;
+    }
+
+    // This event supersedes any delayed actions of earlier events still pending for the same channels.
+    MCTimerWheel *timerWheel = _controller->GetTimerWheel();
+    for (const MCTriggeredAction &triggered : actions) {
+        timerWheel->Cancel(this, triggered.Action->GetChannel());
+    }
+
+    for (const MCTriggeredAction &triggered : actions) {
+        if (triggered.DelayInMs == 0) {
+            executeAction(triggered.Action);
+        } else {
+            timerWheel->Schedule(this, triggered.Action->GetChannel(), triggered.DelayInMs, executeDelayedAction, triggered.Action);
         }
     }
 }
 
+uint BLELocomotive::GetTriggerCount()
+{
+    return _triggerIndex->Size();
+}
+
+uint32_t BLELocomotive::GetTriggerDispatchCount()
+{
+    return _triggerDispatchCount;
+}
+
+ulong BLELocomotive::GetMaxTriggerLookupTimeInUs()
+{
+    return _maxTriggerLookupTimeInUs;
+}
+
 void BLELocomotive::BlinkLights(int durationInMs)
 {
     if (!AllHubsConnected()) {
@@ -134,18 +165,28 @@ BLEHub *BLELocomotive::GetHub(uint index)
     return Hubs.at(index);
 }
 
-void BLELocomotive::initHubs()
+void BLELocomotive::initHubs(std::vector<BLEHub *> reusableHubs)
 {
     for (BLEHubConfiguration *hubConfig : _config->_hubs) {
-        BLEHub *hub;
-
-        switch (hubConfig->HubType) {
-        case BLEHubType::SBrick:
-            hub = new SBrickHub(hubConfig);
-            break;
-        case BLEHubType::PU:
-            hub = new PUHub(hubConfig);
-            break;
+        BLEHub *hub = nullptr;
+
+        for (BLEHub *reusableHub : reusableHubs) {
+            if (reusableHub->GetAddress().equals(*hubConfig->DeviceAddress) && reusableHub->Reconfigure(hubConfig)) {
+                // Keep the hub connected.
+                hub = reusableHub;
+                break;
+            }
+        }
+
+        if (!hub) {
+            switch (hubConfig->HubType) {
+            case BLEHubType::SBrick:
+                hub = new SBrickHub(hubConfig);
+                break;
+            case BLEHubType::PU:
+                hub = new PUHub(hubConfig);
+                break;
+            }
         }
 
         if (hub) {
@@ -154,6 +195,11 @@ void BLELocomotive::initHubs()
         }
     }
 
+    if (!reusableHubs.empty()) {
+        // Hubs we took over keep driving only if all hubs of the loco are connected.
+        setManualBrake(!AllHubsConnected());
+    }
+
     // log4MC::vlogf(LOG_INFO, "Loco: %s hub config initialized.", _config->_name.c_str());
 }
 
@@ -180,6 +226,31 @@ void BLELocomotive::setManualBrake(const bool enabled)
     }
 }
 
+void BLELocomotive::executeAction(MCLocoAction *action)
+{
+    ChannelType portType = action->GetChannel()->GetChannelType();
+    switch (portType) {
+    case ChannelType::BleHubChannel: {
+        // Ask hub to execute action.
+        BLEHub *hub = getHubByAddress(action->GetChannel()->GetParentAddress());
+        if (hub) {
+            hub->Execute(action);
+        }
+        break;
+    }
+    case ChannelType::EspPinChannel: {
+        // Ask controller to execute action.
+        _controller->Execute(action);
+        break;
+    }
+    }
+}
+
+void BLELocomotive::executeDelayedAction(void *owner, void *payload)
+{
+    ((BLELocomotive *)owner)->executeAction((MCLocoAction *)payload);
+}
+
 BLEHub *BLELocomotive::getHubByAddress(std::string address)
 {
     for (BLEHub *hub : Hubs) {
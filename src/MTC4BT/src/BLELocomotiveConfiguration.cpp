@@ -1,8 +1,40 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <set>
 
 #include "BLELocomotiveConfiguration.h"
 
 BLELocomotiveConfiguration::BLELocomotiveConfiguration(uint address, std::string name, std::vector<BLEHubConfiguration *> hubs,
                                                        std::vector<MCLocoEvent *> events)
-    : _address{address}, _name{name}, _hubs{hubs}, _events{events} {}
\ No newline at end of file
+    : _address{address}, _name{name}, _hubs{hubs}, _events{events} {}
+
+BLELocomotiveConfiguration::~BLELocomotiveConfiguration()
+{
+    // Hubs may share the speed control tuning of the loco, and channels the speed curve of their hub or loco, so delete each tuning and curve only once.
+    std::set<MCSpeedControlConfig *> speedControls;
+    std::set<MCSpeedCurve *> speedCurves;
+
+    for (BLEHubConfiguration *hub : _hubs) {
+        if (hub->SpeedControl) {
+            speedControls.insert(hub->SpeedControl);
+        }
+        for (MCChannelConfig *channel : hub->Channels) {
+            if (channel->GetSpeedCurve()) {
+                speedCurves.insert(channel->GetSpeedCurve());
+            }
+        }
+        delete hub;
+    }
+
+    for (MCSpeedControlConfig *speedControl : speedControls) {
+        delete speedControl;
+    }
+
+    for (MCSpeedCurve *speedCurve : speedCurves) {
+        delete speedCurve;
+    }
+
+    for (MCLocoEvent *event : _events) {
+        delete event;
+    }
+}
\ No newline at end of file
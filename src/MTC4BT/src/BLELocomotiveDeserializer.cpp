@@ -1,14 +1,19 @@
+#include <algorithm>
+
 #include "BLELocomotiveDeserializer.h"
 #include "BLEHubChannel.h"
 #include "MCLocoAction.h"
 
-BLELocomotiveConfiguration *BLELocomotiveDeserializer::Deserialize(JsonObject locoConfig, std::vector<MCChannelConfig *> espPins, int16_t defaultPwrIncStep, int16_t defaultPwrDecStep)
+BLELocomotiveConfiguration *BLELocomotiveDeserializer::Deserialize(JsonObject locoConfig, std::vector<MCChannelConfig *> espPins, int16_t defaultPwrIncRate, int16_t defaultPwrDecRate, int16_t defaultPwrJerk, uint &errorCount)
 {
     // Read loco properties.
     const uint address = locoConfig["address"];
     const std::string name = locoConfig["name"]; // | "loco_" + locoConfig["address"];
-    int16_t locoPwrIncStep = locoConfig["pwrIncStep"] | defaultPwrIncStep;
-    int16_t locoPwrDecStep = locoConfig["pwrDecStep"] | defaultPwrDecStep;
+    int16_t locoPwrIncRate = MCJsonConfig::ReadPwrRate(locoConfig, "pwrIncRate", "pwrIncStep", defaultPwrIncRate);
+    int16_t locoPwrDecRate = MCJsonConfig::ReadPwrRate(locoConfig, "pwrDecRate", "pwrDecStep", defaultPwrDecRate);
+    int16_t locoPwrJerk = locoConfig["pwrJerk"] | defaultPwrJerk;
+    MCSpeedCurve *locoSpeedCurve = MCJsonConfig::ReadSpeedCurve(locoConfig, nullptr);
+    MCSpeedControlConfig *locoSpeedControl = MCJsonConfig::ReadSpeedControl(locoConfig, nullptr);
 
     // Iterate over hub configs and copy values from the JsonDocument to BLEHubConfiguration objects.
     std::vector<BLEHubConfiguration *> hubs;
@@ -18,8 +23,19 @@ BLELocomotiveConfiguration *BLELocomotiveDeserializer::Deserialize(JsonObject lo
         // Read hub specific properties.
         const std::string hubType = hubConfig["type"];
         const std::string address = hubConfig["address"];
-        int16_t hubPwrIncStep = hubConfig["pwrIncStep"] | locoPwrIncStep;
-        int16_t hubPwrDecStep = hubConfig["pwrDecStep"] | locoPwrDecStep;
+        int16_t hubPwrIncRate = MCJsonConfig::ReadPwrRate(hubConfig, "pwrIncRate", "pwrIncStep", locoPwrIncRate);
+        int16_t hubPwrDecRate = MCJsonConfig::ReadPwrRate(hubConfig, "pwrDecRate", "pwrDecStep", locoPwrDecRate);
+        int16_t hubPwrJerk = hubConfig["pwrJerk"] | locoPwrJerk;
+        MCSpeedControlConfig *hubSpeedControl = MCJsonConfig::ReadSpeedControl(hubConfig, locoSpeedControl);
+
+        auto sameAddress = [&address](BLEHubConfiguration *hub) { return hub->DeviceAddress->toString().compare(address) == 0; };
+        if (std::any_of(hubs.begin(), hubs.end(), sameAddress)) {
+            log4MC::vlogf(LOG_ERR, "Config: Hub '%s' configured twice for loco '%s'. Second hub ignored.", address.c_str(), name.c_str());
+            errorCount++;
+            continue;
+        }
+
+        MCSpeedCurve *hubSpeedCurve = MCJsonConfig::ReadSpeedCurve(hubConfig, locoSpeedCurve);
 
         // Iterate over channel configs and copy values from the JsonDocument to PortConfiguration objects.
         std::vector<MCChannelConfig *> channels;
@@ -28,19 +44,28 @@ BLELocomotiveConfiguration *BLELocomotiveDeserializer::Deserialize(JsonObject lo
             // Read hub channel properties.
             const std::string channel = channelConfig["channel"];
             std::string attachedDevice = channelConfig["attachedDevice"] | "nothing";
-            const int16_t chnlPwrIncStep = channelConfig["pwrIncStep"] | hubPwrIncStep;
-            const int16_t chnlPwrDecStep = channelConfig["pwrDecStep"] | hubPwrDecStep;
+            const int16_t chnlPwrIncRate = MCJsonConfig::ReadPwrRate(channelConfig, "pwrIncRate", "pwrIncStep", hubPwrIncRate);
+            const int16_t chnlPwrDecRate = MCJsonConfig::ReadPwrRate(channelConfig, "pwrDecRate", "pwrDecStep", hubPwrDecRate);
+            const int16_t chnlPwrJerk = channelConfig["pwrJerk"] | hubPwrJerk;
             const char *dir = channelConfig["direction"] | "forward";
             bool isInverted = strcmp(dir, "backward") == 0 || strcmp(dir, "reverse") == 0;
             bool isPU = strcmp(hubType.c_str(), "PU") == 0;
 
+            auto sameChannel = [&channel](MCChannelConfig *c) { return c->GetChannel()->GetAddress().compare(channel) == 0; };
+            if (std::any_of(channels.begin(), channels.end(), sameChannel)) {
+                log4MC::vlogf(LOG_ERR, "Config: Channel %s of hub '%s' configured twice. Second channel ignored.", channel.c_str(), address.c_str());
+                errorCount++;
+                continue;
+            }
+
             MCChannel *hubChannel = new MCChannel(ChannelType::BleHubChannel, channel);
             hubChannel->SetParentAddress(address);
+            hubChannel->SetResolvedAddress(parseBleHubChannel(channel));
 
-            if (bleHubChannelMap()[hubChannel->GetAddress()] == BLEHubChannel::OnboardLED) {
+            if (hubChannel->GetResolvedAddress() == BLEHubChannel::OnboardLED) {
                 if (!isPU) {
                     // We currently only support the onboad LED of the PU Hub, so we skip this LED channel for now.
-                    log4MC::vlogf(LOG_WARNING, "Config: Support for hub channel %s is currently only available for PU Hubs.", channel);
+                    log4MC::vlogf(LOG_WARNING, "Config: Support for hub channel %s is currently only available for PU Hubs.", channel.c_str());
                     continue;
                 }
 
@@ -48,10 +73,35 @@ BLELocomotiveConfiguration *BLELocomotiveDeserializer::Deserialize(JsonObject lo
                 attachedDevice = "light";
             }
 
-            channels.push_back(new MCChannelConfig(hubChannel, chnlPwrIncStep, chnlPwrDecStep, isInverted, deviceTypeMap()[attachedDevice]));
+            // Speed curves only apply to motors, lights are always mapped linearly.
+            DeviceType deviceType = parseDeviceType(attachedDevice);
+            MCSpeedCurve *chnlSpeedCurve = deviceType == DeviceType::Motor ? MCJsonConfig::ReadSpeedCurve(channelConfig, hubSpeedCurve) : nullptr;
+
+            channels.push_back(new MCChannelConfig(hubChannel, chnlPwrIncRate, chnlPwrDecRate, chnlPwrJerk, chnlSpeedCurve, isInverted, deviceType));
+        }
+
+        // The loco config only owns the speed curves its channels use, so drop the hub curve if no motor uses it.
+        auto usesHubSpeedCurve = [hubSpeedCurve](MCChannelConfig *c) { return c->GetSpeedCurve() == hubSpeedCurve; };
+        if (hubSpeedCurve != locoSpeedCurve && std::none_of(channels.begin(), channels.end(), usesHubSpeedCurve)) {
+            delete hubSpeedCurve;
+        }
+
+        BLEHubType type = parseBleHubType(hubType);
+        if (hubSpeedControl && type != BLEHubType::PU) {
+            // Only PU hubs report the speed of motors with encoders.
+            log4MC::vlogf(LOG_WARNING, "Config: Closed-loop speed control is only available for PU Hubs. Hub %s runs open-loop.", address.c_str());
+            hubSpeedControl = nullptr;
         }
 
-        hubs.push_back(new BLEHubConfiguration(bleHubTypeMap()[hubType], address, channels));
+        hubs.push_back(new BLEHubConfiguration(type, address, channels, hubSpeedControl));
+    }
+
+    // Drop the loco curve too if no motor of any hub uses it.
+    auto usesLocoSpeedCurve = [locoSpeedCurve](BLEHubConfiguration *hub) {
+        return std::any_of(hub->Channels.begin(), hub->Channels.end(), [locoSpeedCurve](MCChannelConfig *c) { return c->GetSpeedCurve() == locoSpeedCurve; });
+    };
+    if (std::none_of(hubs.begin(), hubs.end(), usesLocoSpeedCurve)) {
+        delete locoSpeedCurve;
     }
 
     // Iterate over events and copy values from the JsonDocument to MCLocoEvent objects.
@@ -66,14 +116,13 @@ BLELocomotiveConfiguration *BLELocomotiveDeserializer::Deserialize(JsonObject lo
             const std::string eventType = triggerConfig["eventType"];
             const std::string eventId = triggerConfig["identifier"] | "";
             const std::string value = triggerConfig["value"];
-            int8_t delayInMs = triggerConfig["delayInMs"] | 0;
+            uint32_t delayInMs = triggerConfig["delayInMs"] | 0;
 
-            triggers.push_back(new MCLocoTrigger(triggerSourceMap()[source], eventType, eventId, value, delayInMs));
+            triggers.push_back(new MCLocoTrigger(parseTriggerSource(source), eventType, eventId, value, delayInMs));
         }
 
         std::vector<MCLocoAction *> actions;
         JsonArray actionConfigs = eventConfig["actions"].as<JsonArray>();
-        MCChannelConfig *foundChannel;
         for (JsonObject actionConfig : actionConfigs) {
             // Read action properties.
             const std::string device = actionConfig["device"] | "bleHub";
@@ -82,9 +131,9 @@ BLELocomotiveConfiguration *BLELocomotiveDeserializer::Deserialize(JsonObject lo
             int16_t pwrPerc = actionConfig["pwrPerc"] | 0;
             const std::string color = actionConfig["color"] | "";
 
-            foundChannel = nullptr;
+            MCChannelConfig *foundChannel = nullptr;
 
-            switch (channelTypeMap()[device]) {
+            switch (parseChannelType(device)) {
             case ChannelType::EspPinChannel: {
                 // Check if there's an ESP pin with the specified pin number in the controller config.
 
@@ -96,13 +145,14 @@ BLELocomotiveConfiguration *BLELocomotiveDeserializer::Deserialize(JsonObject lo
                 }
 
                 if (foundChannel == nullptr) {
-                    log4MC::vlogf(LOG_WARNING, "Config: ESP pin %u not configured in 'espPins' section. Configured action ignored.", address);
+                    log4MC::vlogf(LOG_ERR, "Config: ESP pin %s not configured in 'espPins' section. Configured action ignored.", address.c_str());
+                    errorCount++;
                     continue;
                 }
 
                 // Check if the ESP pin with the specified address defined in the config has a light attached to it.
                 if (foundChannel->GetAttachedDeviceType() != DeviceType::Light) {
-                    log4MC::vlogf(LOG_WARNING, "Config: ESP pin %u in the 'espPins' section is not configured with `light` as the `attachedDevice`. Configured action ignored.", address);
+                    log4MC::vlogf(LOG_WARNING, "Config: ESP pin %s in the 'espPins' section is not configured with `light` as the `attachedDevice`. Configured action ignored.", address.c_str());
                     continue;
                 }
 
@@ -119,13 +169,15 @@ BLELocomotiveConfiguration *BLELocomotiveDeserializer::Deserialize(JsonObject lo
                             break;
                         }
                     }
-                } else {
+                } else if (!hubs.empty()) {
                     // No hub address specified, so assume first hub.
                     foundHub = hubs.at(0);
                 }
 
                 if (foundHub == nullptr) {
-                    log4MC::vlogf(LOG_ERR, "Config: Hub '%s' not configured in this loco's 'bleHubs' section.", address);
+                    log4MC::vlogf(LOG_ERR, "Config: Hub '%s' not configured in this loco's 'bleHubs' section. Configured action ignored.", address.c_str());
+                    errorCount++;
+                    continue;
                 }
 
                 // Check if the specified channel is defined in the hub config.
@@ -137,14 +189,16 @@ BLELocomotiveConfiguration *BLELocomotiveDeserializer::Deserialize(JsonObject lo
                 }
 
                 if (foundChannel == nullptr) {
-                    log4MC::vlogf(LOG_ERR, "Config: Hub channel %s not configured in this loco's 'bleHubs' section.", channel);
+                    log4MC::vlogf(LOG_ERR, "Config: Hub channel %s not configured in this loco's 'bleHubs' section. Configured action ignored.", channel.c_str());
+                    errorCount++;
+                    continue;
                 }
 
                 break;
             }
             }
 
-            actions.push_back(new MCLocoAction(foundChannel->GetChannel(), pwrPerc, hubLedColorMap()[color]));
+            actions.push_back(new MCLocoAction(foundChannel->GetChannel(), pwrPerc, parseHubLedColor(color)));
         }
 
         events.push_back(new MCLocoEvent(triggers, actions));
@@ -0,0 +1,460 @@
+#include <algorithm>
+#include <SPIFFS.h>
+
+#include "BLEHubConfiguration.h"
+#include "MTC4BTConfigurationCache.h"
+#include "log4MC.h"
+
+// Size of the cache file header (magic, version, payload size and payload checksum).
+#define CONFIG_CACHE_HEADER_SIZE 14
+
+// Reference kinds of the channel an action targets.
+#define CONFIG_CACHE_ESP_PIN_CHANNEL 0
+#define CONFIG_CACHE_HUB_CHANNEL 1
+
+// Index written for channels without a speed curve.
+#define CONFIG_CACHE_NO_SPEED_CURVE 0xFF
+
+MTC4BTConfiguration *MTC4BTConfigurationCache::Load(const char *cacheFilePath)
+{
+    ulong startedAt = millis();
+
+    File file = SPIFFS.open(cacheFilePath);
+    if (!file) {
+        return nullptr;
+    }
+
+    // Read the whole cache file with a single read.
+    size_t size = file.size();
+    uint8_t *buffer = (uint8_t *)malloc(size);
+    if (!buffer) {
+        file.close();
+        log4MC::vlogf(LOG_WARNING, "Config: Not enough memory to read config cache (%u bytes).", size);
+        return nullptr;
+    }
+    size_t bytesRead = file.read(buffer, size);
+    file.close();
+
+    MCBinaryReader header(buffer, bytesRead);
+    uint32_t magic = header.ReadUInt32();
+    uint16_t version = header.ReadUInt16();
+    uint32_t payloadSize = header.ReadUInt32();
+    uint32_t payloadChecksum = header.ReadUInt32();
+
+    if (header.Failed() || magic != CONFIG_CACHE_MAGIC || version != CONFIG_CACHE_VERSION || payloadSize != bytesRead - CONFIG_CACHE_HEADER_SIZE) {
+        free(buffer);
+        log4MC::info("Config: Config cache has an unknown format, ignoring it.");
+        return nullptr;
+    }
+
+    const uint8_t *payload = buffer + CONFIG_CACHE_HEADER_SIZE;
+    if (checksum(payload, payloadSize) != payloadChecksum) {
+        free(buffer);
+        log4MC::warn("Config: Config cache is corrupt, ignoring it.");
+        return nullptr;
+    }
+
+    MCBinaryReader reader(payload, payloadSize);
+
+    // Check whether the JSON config files the cache was compiled from are unchanged.
+    uint8_t sourceCount = reader.ReadUInt8();
+    for (int i = 0; i < sourceCount; i++) {
+        std::string sourceFilePath = reader.ReadString();
+        uint32_t sourceSize = reader.ReadUInt32();
+        uint32_t sourceChecksum = reader.ReadUInt32();
+
+        uint32_t actualSize;
+        uint32_t actualChecksum;
+        if (!checksumFile(sourceFilePath.c_str(), &actualSize, &actualChecksum) || actualSize != sourceSize || actualChecksum != sourceChecksum) {
+            free(buffer);
+            log4MC::vlogf(LOG_INFO, "Config: Config file %s changed, ignoring config cache.", sourceFilePath.c_str());
+            return nullptr;
+        }
+    }
+
+    // Read the speed curves, which may be shared by several channels.
+    std::vector<MCSpeedCurve *> speedCurves;
+    uint8_t speedCurveCount = reader.ReadUInt8();
+    for (int i = 0; i < speedCurveCount; i++) {
+        uint16_t table[SPEED_CURVE_TABLE_SIZE];
+        for (int j = 0; j < SPEED_CURVE_TABLE_SIZE; j++) {
+            table[j] = reader.ReadUInt16();
+        }
+        speedCurves.push_back(new MCSpeedCurve(table));
+    }
+
+    MTC4BTConfiguration *config = new MTC4BTConfiguration();
+    config->ControllerName = strdup(reader.ReadString().c_str());
+    config->PwrIncRate = reader.ReadInt16();
+    config->PwrDecRate = reader.ReadInt16();
+    config->PwrJerk = reader.ReadInt16();
+
+    uint16_t espPinCount = reader.ReadUInt16();
+    for (int i = 0; i < espPinCount; i++) {
+        config->EspPins.push_back(readChannelConfig(reader, speedCurves));
+    }
+
+    bool failed = false;
+    uint16_t locoCount = reader.ReadUInt16();
+    for (int i = 0; i < locoCount && !failed; i++) {
+        BLELocomotiveConfiguration *loco = readLocomotive(reader, config->EspPins, speedCurves);
+        if (loco) {
+            config->Locomotives.push_back(loco);
+        } else {
+            failed = true;
+        }
+    }
+
+    failed = failed || reader.Failed() || !reader.AtEnd();
+    free(buffer);
+
+    if (failed) {
+        // Can only happen when the format changed without bumping the version (the checksum rules out corruption).
+        log4MC::error("Config: Config cache doesn't match its format, ignoring it.");
+        deleteConfiguration(config, speedCurves);
+        return nullptr;
+    }
+
+    log4MC::vlogf(LOG_INFO, "Config: Read %u locos from config cache in %lu ms (free heap: %u bytes).", config->Locomotives.size(), millis() - startedAt, ESP.getFreeHeap());
+
+    return config;
+}
+
+bool MTC4BTConfigurationCache::Save(const char *cacheFilePath, MTC4BTConfiguration *config, const std::vector<std::string> &sourceFilePaths)
+{
+    // Write the configuration first, collecting the speed curves it uses.
+    std::vector<MCSpeedCurve *> speedCurves;
+    MCBinaryWriter body;
+    body.WriteString(config->ControllerName);
+    body.WriteInt16(config->PwrIncRate);
+    body.WriteInt16(config->PwrDecRate);
+    body.WriteInt16(config->PwrJerk);
+
+    body.WriteUInt16(config->EspPins.size());
+    for (MCChannelConfig *espPin : config->EspPins) {
+        writeChannelConfig(body, espPin, speedCurves);
+    }
+
+    body.WriteUInt16(config->Locomotives.size());
+    for (BLELocomotiveConfiguration *loco : config->Locomotives) {
+        if (!writeLocomotive(body, loco, config->EspPins, speedCurves)) {
+            log4MC::vlogf(LOG_WARNING, "Config: Unable to cache config of loco %s, not writing config cache.", loco->_name.c_str());
+            return false;
+        }
+    }
+
+    if (speedCurves.size() >= CONFIG_CACHE_NO_SPEED_CURVE) {
+        log4MC::warn("Config: Too many speed curves to cache, not writing config cache.");
+        return false;
+    }
+
+    // Write the payload: the source files, the speed curves and the configuration.
+    MCBinaryWriter payload;
+    payload.WriteUInt8(sourceFilePaths.size());
+    for (const std::string &sourceFilePath : sourceFilePaths) {
+        uint32_t sourceSize;
+        uint32_t sourceChecksum;
+        if (!checksumFile(sourceFilePath.c_str(), &sourceSize, &sourceChecksum)) {
+            log4MC::vlogf(LOG_WARNING, "Config: Unable to read config file %s, not writing config cache.", sourceFilePath.c_str());
+            return false;
+        }
+
+        payload.WriteString(sourceFilePath);
+        payload.WriteUInt32(sourceSize);
+        payload.WriteUInt32(sourceChecksum);
+    }
+
+    payload.WriteUInt8(speedCurves.size());
+    for (MCSpeedCurve *speedCurve : speedCurves) {
+        for (int i = 0; i < SPEED_CURVE_TABLE_SIZE; i++) {
+            payload.WriteUInt16(speedCurve->GetPwr(i));
+        }
+    }
+
+    payload.WriteBytes(body.GetBuffer().data(), body.GetBuffer().size());
+
+    MCBinaryWriter header;
+    header.WriteUInt32(CONFIG_CACHE_MAGIC);
+    header.WriteUInt16(CONFIG_CACHE_VERSION);
+    header.WriteUInt32(payload.GetBuffer().size());
+    header.WriteUInt32(checksum(payload.GetBuffer().data(), payload.GetBuffer().size()));
+
+    File file = SPIFFS.open(cacheFilePath, FILE_WRITE);
+    if (!file) {
+        log4MC::warn("Config: Unable to open config cache for writing.");
+        return false;
+    }
+
+    bool written = file.write(header.GetBuffer().data(), header.GetBuffer().size()) == header.GetBuffer().size() &&
+                   file.write(payload.GetBuffer().data(), payload.GetBuffer().size()) == payload.GetBuffer().size();
+    file.close();
+
+    if (!written) {
+        // Don't leave a truncated cache behind.
+        SPIFFS.remove(cacheFilePath);
+        log4MC::warn("Config: Unable to write config cache.");
+        return false;
+    }
+
+    log4MC::vlogf(LOG_INFO, "Config: Wrote config cache (%u bytes).", CONFIG_CACHE_HEADER_SIZE + payload.GetBuffer().size());
+    return true;
+}
+
+bool MTC4BTConfigurationCache::checksumFile(const char *filePath, uint32_t *size, uint32_t *checksum)
+{
+    File file = SPIFFS.open(filePath);
+    if (!file) {
+        return false;
+    }
+
+    uint8_t chunk[256];
+    uint32_t crc = 0;
+    size_t chunkSize;
+    while ((chunkSize = file.read(chunk, sizeof(chunk))) > 0) {
+        crc = MTC4BTConfigurationCache::checksum(chunk, chunkSize, crc);
+    }
+
+    *size = file.size();
+    *checksum = crc;
+    file.close();
+
+    return true;
+}
+
+uint32_t MTC4BTConfigurationCache::checksum(const uint8_t *data, size_t size, uint32_t crc)
+{
+    // CRC-32 (IEEE 802.3), calculated bitwise, as it only runs over a few kB of config at boot.
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+void MTC4BTConfigurationCache::writeChannelConfig(MCBinaryWriter &writer, MCChannelConfig *channelConfig, std::vector<MCSpeedCurve *> &speedCurves)
+{
+    MCChannel *channel = channelConfig->GetChannel();
+    writer.WriteUInt8(channel->GetChannelType());
+    writer.WriteString(channel->GetAddress());
+    writer.WriteString(channel->GetParentAddress());
+    writer.WriteInt16(channel->GetResolvedAddress());
+    writer.WriteInt16(channelConfig->GetPwrIncRate());
+    writer.WriteInt16(channelConfig->GetPwrDecRate());
+    writer.WriteInt16(channelConfig->GetPwrJerk());
+
+    MCSpeedCurve *speedCurve = channelConfig->GetSpeedCurve();
+    if (speedCurve) {
+        auto it = std::find(speedCurves.begin(), speedCurves.end(), speedCurve);
+        if (it == speedCurves.end()) {
+            it = speedCurves.insert(speedCurves.end(), speedCurve);
+        }
+        writer.WriteUInt8(it - speedCurves.begin());
+    } else {
+        writer.WriteUInt8(CONFIG_CACHE_NO_SPEED_CURVE);
+    }
+
+    writer.WriteBool(channelConfig->IsInverted());
+    writer.WriteUInt8(channelConfig->GetAttachedDeviceType());
+}
+
+bool MTC4BTConfigurationCache::writeLocomotive(MCBinaryWriter &writer, BLELocomotiveConfiguration *loco, std::vector<MCChannelConfig *> &espPins, std::vector<MCSpeedCurve *> &speedCurves)
+{
+    writer.WriteUInt32(loco->_address);
+    writer.WriteString(loco->_name);
+
+    writer.WriteUInt8(loco->_hubs.size());
+    for (BLEHubConfiguration *hub : loco->_hubs) {
+        writer.WriteUInt8(hub->HubType);
+        writer.WriteString(hub->DeviceAddress->toString());
+        writer.WriteBool(hub->SpeedControl != nullptr);
+        if (hub->SpeedControl) {
+            writer.WriteInt16(hub->SpeedControl->Kp);
+            writer.WriteInt16(hub->SpeedControl->Ki);
+        }
+
+        writer.WriteUInt8(hub->Channels.size());
+        for (MCChannelConfig *channelConfig : hub->Channels) {
+            writeChannelConfig(writer, channelConfig, speedCurves);
+        }
+    }
+
+    writer.WriteUInt16(loco->_events.size());
+    for (MCLocoEvent *event : loco->_events) {
+        writer.WriteUInt8(event->GetTriggers().size());
+        for (MCLocoTrigger *trigger : event->GetTriggers()) {
+            writer.WriteUInt8(trigger->GetSource());
+            writer.WriteString(trigger->GetEventType());
+            writer.WriteString(trigger->GetEventId());
+            writer.WriteString(trigger->GetValue());
+            writer.WriteUInt32(trigger->GetDelayInMs());
+        }
+
+        writer.WriteUInt8(event->GetActions().size());
+        for (MCLocoAction *action : event->GetActions()) {
+            // Actions refer to channels by their position in the config, so they can be linked up again when reading the cache.
+            bool found = false;
+
+            for (int i = 0; i < espPins.size() && !found; i++) {
+                if (espPins[i]->GetChannel() == action->GetChannel()) {
+                    writer.WriteUInt8(CONFIG_CACHE_ESP_PIN_CHANNEL);
+                    writer.WriteUInt16(i);
+                    found = true;
+                }
+            }
+
+            for (int i = 0; i < loco->_hubs.size() && !found; i++) {
+                for (int j = 0; j < loco->_hubs[i]->Channels.size() && !found; j++) {
+                    if (loco->_hubs[i]->Channels[j]->GetChannel() == action->GetChannel()) {
+                        writer.WriteUInt8(CONFIG_CACHE_HUB_CHANNEL);
+                        writer.WriteUInt8(i);
+                        writer.WriteUInt8(j);
+                        found = true;
+                    }
+                }
+            }
+
+            if (!found) {
+                return false;
+            }
+
+            writer.WriteInt16(action->GetTargetPowerPerc());
+            writer.WriteUInt8(action->GetColor());
+        }
+    }
+
+    return true;
+}
+
+MCChannelConfig *MTC4BTConfigurationCache::readChannelConfig(MCBinaryReader &reader, std::vector<MCSpeedCurve *> &speedCurves)
+{
+    ChannelType channelType = (ChannelType)reader.ReadUInt8();
+    std::string address = reader.ReadString();
+    std::string parentAddress = reader.ReadString();
+    int16_t resolvedAddress = reader.ReadInt16();
+    int16_t pwrIncRate = reader.ReadInt16();
+    int16_t pwrDecRate = reader.ReadInt16();
+    int16_t pwrJerk = reader.ReadInt16();
+    uint8_t speedCurveIndex = reader.ReadUInt8();
+    bool isInverted = reader.ReadBool();
+    DeviceType deviceType = (DeviceType)reader.ReadUInt8();
+
+    MCChannel *channel = new MCChannel(channelType, address);
+    channel->SetParentAddress(parentAddress);
+    channel->SetResolvedAddress(resolvedAddress);
+
+    MCSpeedCurve *speedCurve = speedCurveIndex < speedCurves.size() ? speedCurves[speedCurveIndex] : nullptr;
+
+    return new MCChannelConfig(channel, pwrIncRate, pwrDecRate, pwrJerk, speedCurve, isInverted, deviceType);
+}
+
+BLELocomotiveConfiguration *MTC4BTConfigurationCache::readLocomotive(MCBinaryReader &reader, std::vector<MCChannelConfig *> &espPins, std::vector<MCSpeedCurve *> &speedCurves)
+{
+    uint address = reader.ReadUInt32();
+    std::string name = reader.ReadString();
+
+    std::vector<BLEHubConfiguration *> hubs;
+    uint8_t hubCount = reader.ReadUInt8();
+    for (int i = 0; i < hubCount; i++) {
+        BLEHubType hubType = (BLEHubType)reader.ReadUInt8();
+        std::string hubAddress = reader.ReadString();
+
+        MCSpeedControlConfig *speedControl = nullptr;
+        if (reader.ReadBool()) {
+            speedControl = new MCSpeedControlConfig();
+            speedControl->Kp = reader.ReadInt16();
+            speedControl->Ki = reader.ReadInt16();
+        }
+
+        std::vector<MCChannelConfig *> channels;
+        uint8_t channelCount = reader.ReadUInt8();
+        for (int j = 0; j < channelCount; j++) {
+            channels.push_back(readChannelConfig(reader, speedCurves));
+        }
+
+        hubs.push_back(new BLEHubConfiguration(hubType, hubAddress, channels, speedControl));
+    }
+
+    std::vector<MCLocoEvent *> events;
+    bool failed = false;
+    uint16_t eventCount = reader.ReadUInt16();
+    for (int i = 0; i < eventCount && !failed; i++) {
+        std::vector<MCLocoTrigger *> triggers;
+        uint8_t triggerCount = reader.ReadUInt8();
+        for (int j = 0; j < triggerCount; j++) {
+            MCTriggerSource source = (MCTriggerSource)reader.ReadUInt8();
+            std::string eventType = reader.ReadString();
+            std::string eventId = reader.ReadString();
+            std::string value = reader.ReadString();
+            uint32_t delayInMs = reader.ReadUInt32();
+            triggers.push_back(new MCLocoTrigger(source, eventType, eventId, value, delayInMs));
+        }
+
+        std::vector<MCLocoAction *> actions;
+        uint8_t actionCount = reader.ReadUInt8();
+        for (int j = 0; j < actionCount; j++) {
+            MCChannelConfig *channelConfig = nullptr;
+
+            if (reader.ReadUInt8() == CONFIG_CACHE_ESP_PIN_CHANNEL) {
+                uint16_t espPinIndex = reader.ReadUInt16();
+                channelConfig = espPinIndex < espPins.size() ? espPins[espPinIndex] : nullptr;
+            } else {
+                uint8_t hubIndex = reader.ReadUInt8();
+                uint8_t channelIndex = reader.ReadUInt8();
+                if (hubIndex < hubs.size() && channelIndex < hubs[hubIndex]->Channels.size()) {
+                    channelConfig = hubs[hubIndex]->Channels[channelIndex];
+                }
+            }
+
+            int16_t pwrPerc = reader.ReadInt16();
+            HubLedColor color = (HubLedColor)reader.ReadUInt8();
+
+            if (reader.Failed() || channelConfig == nullptr) {
+                failed = true;
+                break;
+            }
+
+            actions.push_back(new MCLocoAction(channelConfig->GetChannel(), pwrPerc, color));
+        }
+
+        events.push_back(new MCLocoEvent(triggers, actions));
+    }
+
+    BLELocomotiveConfiguration *loco = new BLELocomotiveConfiguration(address, name, hubs, events);
+
+    // The loco owns the speed curves of its channels from now on, so take them out of the shared list (a later loco referring to them gets no curve instead of sharing them).
+    for (BLEHubConfiguration *hub : hubs) {
+        for (MCChannelConfig *channel : hub->Channels) {
+            std::replace(speedCurves.begin(), speedCurves.end(), channel->GetSpeedCurve(), (MCSpeedCurve *)nullptr);
+        }
+    }
+
+    if (failed) {
+        // Delete what we've read so far.
+        delete loco;
+        return nullptr;
+    }
+
+    return loco;
+}
+
+void MTC4BTConfigurationCache::deleteConfiguration(MTC4BTConfiguration *config, std::vector<MCSpeedCurve *> &speedCurves)
+{
+    for (BLELocomotiveConfiguration *loco : config->Locomotives) {
+        delete loco;
+    }
+
+    for (MCChannelConfig *espPin : config->EspPins) {
+        delete espPin;
+    }
+
+    free((void *)config->ControllerName);
+    delete config;
+
+    // The locos deleted the speed curves of their channels, delete the ones left (used by the ESP pins, or by nothing).
+    for (MCSpeedCurve *speedCurve : speedCurves) {
+        delete speedCurve;
+    }
+}
\ No newline at end of file
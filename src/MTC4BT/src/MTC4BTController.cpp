@@ -1,4 +1,8 @@
+#include <algorithm>
+
 #include "MTC4BTController.h"
+#include "BLELocomotiveDeserializer.h"
+#include "MCBootTimeline.h"
 #include "MCLed.h"
 #include "MCStatusLed.h"
 #include "enums.h"
@@ -26,6 +30,15 @@ const uint32_t BLE_SCAN_DURATION_IN_SECONDS = 2;
 // Duration between BLE discovery and connect attempts in seconds.
 const uint32_t BLE_CONNECT_DELAY_IN_SECONDS = 3;
 
+// Interval in milliseconds at which we check for hubs that need a directed reconnect while waiting for the next discovery round.
+const uint32_t BLE_RECONNECT_POLL_INTERVAL_IN_MS = 50;
+
+// Time in milliseconds a loco replaced or removed by a reload is kept after its removed hubs are idle. Swapping the loco doesn't wait for the tasks that read the old loco or its config without taking a lock,
+// so this covers their reads that were already under way: the ticker task walking its copy of the loco list, a delayed action of the old loco that the timer wheel task already took off the wheel (CancelAll
+// can't stop it anymore), a connect callback of a kept hub already running on the NimBLE task when it was rebound to the new loco, and notify callbacks of a kept hub reading a channel config just
+// before BLEHub::Reconfigure swapped it. Each of those lasts a single pass of its task (milliseconds), far below this delay.
+const uint32_t RETIRED_LOCO_DELETE_DELAY_IN_MS = 5000;
+
 // Sets the watchdog timeout (0D &lt; timeout in 0.1 secs, 1 byte &gt;)
 // The purpose of the watchdog is to stop driving in case of an application failure.
 // Watchdog starts when the first DRIVE command is issued during a connection.
@@ -38,6 +51,7 @@ const int8_t WATCHDOG_TIMEOUT_IN_TENS_OF_SECONDS = 3;
 
 MTC4BTController::MTC4BTController() : MController()
 {
+    _locomotivesLock = xSemaphoreCreateMutex();
 }
 
 void MTC4BTController::Setup(MTC4BTConfiguration *config)
@@ -51,9 +65,17 @@ void MTC4BTController::Setup(MTC4BTConfiguration *config)
     // Setup MTC4BT specific controller configuration.
     initLocomotives(config->Locomotives);
 
+    // Register all hubs, so discovered devices can be matched against them by address.
+    _hubRegistry = new BLEHubRegistry();
+    for (BLELocomotive *loco : Locomotives) {
+        for (BLEHub *hub : loco->Hubs) {
+            _hubRegistry->Add(hub);
+        }
+    }
+
     // Initialize BLE hub scanner.
     log4MC::info("Setup: Initializing BLE...");
-    _hubScanner = new BLEHubScanner();
+    _hubScanner = new BLEHubScanner(_hubRegistry);
 
     // Start BLE device discovery task loop (will detect and connect to configured BLE devices).
     xTaskCreatePinnedToCore(this->discoveryLoop, "DiscoveryLoop", Discovery_StackDepth, this, Discovery_TaskPriority, NULL, Discovery_CoreID);
@@ -65,9 +87,20 @@ void MTC4BTController::Loop()
     MController::Loop();
 
     // Handle e-brake on all locomotives.
+    xSemaphoreTake(_locomotivesLock, portMAX_DELAY);
     for (BLELocomotive *loco : Locomotives) {
         loco->SetEmergencyBrake(GetEmergencyBrake());
     }
+    xSemaphoreGive(_locomotivesLock);
+}
+
+std::vector<BLELocomotive *> MTC4BTController::GetLocomotives()
+{
+    xSemaphoreTake(_locomotivesLock, portMAX_DELAY);
+    std::vector<BLELocomotive *> locos = Locomotives;
+    xSemaphoreGive(_locomotivesLock);
+
+    return locos;
 }
 
 bool MTC4BTController::HasLocomotive(uint address)
@@ -88,7 +121,8 @@ void MTC4BTController::HandleLc(int locoAddress, int speed, int minSpeed, int ma
         // Loco is under the control of this controller. Process command!
 
         // Calculate target speed percentage (as percentage if mode is "percent", or else as a percentage of max speed).
-        int targetSpeedPerc = strcmp(mode, "percent") == 0 ? speed : (speed * maxSpeed) / 100;
+        // The loco's speed curve takes care of mapping the percentage to the actual motor pwr.
+        int targetSpeedPerc = strcmp(mode, "percent") == 0 ? speed : (maxSpeed > 0 ? min(speed * 100 / maxSpeed, 100) : 0);
 
         // Calculate direction multiplier (1 or -1)
         int8_t dirMultiplier = dirForward ? 1 : -1;
@@ -99,7 +133,7 @@ void MTC4BTController::HandleLc(int locoAddress, int speed, int minSpeed, int ma
     }
 }
 
-void MTC4BTController::HandleTrigger(int locoAddress, MCTriggerSource source, std::string eventType, std::string eventId, std::string value)
+void MTC4BTController::HandleTrigger(int locoAddress, MCTriggerSource source, const char *eventType, const char *eventId, const char *value)
 {
     BLELocomotive *loco = getLocomotive(locoAddress);
     if (!loco) {
@@ -111,37 +145,140 @@ void MTC4BTController::HandleTrigger(int locoAddress, MCTriggerSource source, st
     loco->TriggerEvent(source, eventType, eventId, value);
 }
 
+void MTC4BTController::ReloadLocomotive(JsonObject locoConfig)
+{
+    const uint address = locoConfig["address"];
+    const bool enabled = locoConfig["enabled"] | true;
+    BLELocomotive *oldLoco = getLocomotive(address);
+
+    if (!enabled && !oldLoco) {
+        log4MC::vlogf(LOG_INFO, "Ctrl: Loco with address '%u' is not under our control. Nothing to remove.", address);
+        return;
+    }
+
+    BLELocomotiveConfiguration *newConfig = nullptr;
+    BLELocomotive *newLoco = nullptr;
+    if (enabled) {
+        uint errorCount = 0;
+        newConfig = BLELocomotiveDeserializer::Deserialize(locoConfig, _config->EspPins, _config->PwrIncRate, _config->PwrDecRate, _config->PwrJerk, errorCount);
+        if (errorCount > 0) {
+            // Keep the loco as it is, rather than replacing it with a partially working one.
+            log4MC::vlogf(LOG_ERR, "Ctrl: Found %u errors in the config of loco with address '%u'. Config change rejected.", errorCount, address);
+            delete newConfig;
+            return;
+        }
+
+        if (!checkHubs(newConfig)) {
+            log4MC::vlogf(LOG_ERR, "Ctrl: Hubs of loco with address '%u' can't be connected. Config change rejected.", address);
+            delete newConfig;
+            return;
+        }
+
+        newLoco = new BLELocomotive(newConfig, this, oldLoco ? oldLoco->Hubs : std::vector<BLEHub *>());
+    }
+
+    // Determine which hubs of the old loco weren't taken over by the new loco, and which hubs of the new loco are new.
+    std::vector<BLEHub *> removedHubs;
+    std::vector<BLEHub *> addedHubs;
+    if (oldLoco) {
+        for (BLEHub *hub : oldLoco->Hubs) {
+            if (!newLoco || std::find(newLoco->Hubs.begin(), newLoco->Hubs.end(), hub) == newLoco->Hubs.end()) {
+                removedHubs.push_back(hub);
+            }
+        }
+    }
+    if (newLoco) {
+        for (BLEHub *hub : newLoco->Hubs) {
+            if (!oldLoco || std::find(oldLoco->Hubs.begin(), oldLoco->Hubs.end(), hub) == oldLoco->Hubs.end()) {
+                addedHubs.push_back(hub);
+            }
+        }
+    }
+
+    // Swap the locos. The old loco is deleted by the discovery task later on, as other tasks (hub callbacks, delayed actions) may still hold a reference to it.
+    xSemaphoreTake(_locomotivesLock, portMAX_DELAY);
+    auto loco = std::find(Locomotives.begin(), Locomotives.end(), oldLoco);
+    if (oldLoco && newLoco) {
+        *loco = newLoco;
+    } else if (oldLoco) {
+        Locomotives.erase(loco);
+    } else {
+        Locomotives.push_back(newLoco);
+    }
+
+    BLELocomotiveConfiguration *oldConfig = nullptr;
+    auto config = std::find_if(_config->Locomotives.begin(), _config->Locomotives.end(), [address](BLELocomotiveConfiguration *c) { return c->_address == address; });
+    if (config != _config->Locomotives.end()) {
+        oldConfig = *config;
+        _config->Locomotives.erase(config);
+    }
+    if (newConfig) {
+        _config->Locomotives.push_back(newConfig);
+    }
+
+    if (oldLoco) {
+        _retiredLocomotives.push_back({oldLoco, oldConfig, removedHubs, millis()});
+    }
+    xSemaphoreGive(_locomotivesLock);
+
+    if (oldLoco) {
+        // Delayed actions of the old loco refer to its config.
+        GetTimerWheel()->CancelAll(oldLoco);
+    }
+
+    // Disconnect removed hubs first, as a replaced hub may have the same address as its replacement.
+    for (BLEHub *hub : removedHubs) {
+        _hubRegistry->Remove(hub);
+        hub->Retire();
+    }
+
+    for (BLEHub *hub : addedHubs) {
+        // The scanner ignores devices that weren't configured when it saw them.
+        NimBLEDevice::removeIgnored(hub->GetAddress());
+        _hubRegistry->Add(hub);
+    }
+
+    log4MC::vlogf(LOG_INFO, "Ctrl: Reloaded loco with address '%u' (hubs kept connected: %u, added: %u, removed: %u).",
+                  address, newLoco ? newLoco->Hubs.size() - addedHubs.size() : 0, addedHubs.size(), removedHubs.size());
+}
+
 void MTC4BTController::discoveryLoop(void *parm)
 {
     MTC4BTController *controller = (MTC4BTController *)parm;
 
+    MCBootTimeline::Mark("ble_discovery");
+
     for (;;) {
+        // Retired locos are deleted here, so this task never uses one while it's being deleted.
+        controller->deleteRetiredLocomotives();
+
         std::vector<BLEHub *> undiscoveredHubs;
 
-        for (BLELocomotive *loco : controller->Locomotives) {
+        for (BLELocomotive *loco : controller->GetLocomotives()) {
             // All loco hubs are already connected. Skip to the next loco.
             if (loco->AllHubsConnected()) {
                 continue;
             }
 
             for (BLEHub *hub : loco->Hubs) {
-                if (hub->IsConnected()) {
-                    // Hub is already connected. Skip to the next Hub.
+                if (hub->IsConnected() || hub->IsRetired()) {
+                    // Hub is already connected (or was removed from the config by a reload). Skip to the next Hub.
+                    continue;
+                }
+
+                if (hub->IsReconnecting()) {
+                    // Hub dropped its connection, reconnect to its known address directly (when the next attempt is due).
+                    if (hub->IsReconnectDue() && hub->Reconnect(WATCHDOG_TIMEOUT_IN_TENS_OF_SECONDS)) {
+                        handleHubConnected(loco);
+                    }
+
                     continue;
                 }
 
                 if (hub->IsDiscovered()) {
                     // Hub discovered, try to connect now.
                     if (hub->Connect(WATCHDOG_TIMEOUT_IN_TENS_OF_SECONDS)) {
-                        if (loco->AllHubsConnected()) {
-                            log4MC::vlogf(LOG_INFO, "Loop: Connected to all hubs of loco '%s'.", loco->GetLocoName().c_str());
-
-                            // For hubs of this loco that have an onboard LED, force it to be on (white) by default.
-                            loco->SetHubLedColor(HubLedColor::WHITE);
-
-                            // Blink lights for a while when connected.
-                            loco->BlinkLights(BLINK_AT_CONNECT_DURATION_IN_MS);
-                        }
+                        handleHubConnected(loco);
                     } else {
                         // Connect attempt failed. Will retry in next loop.
                         log4MC::warn("Loop: Connect failed. Will retry...");
@@ -155,14 +292,115 @@ void MTC4BTController::discoveryLoop(void *parm)
             }
         }
 
-        if (undiscoveredHubs.size() > 0) {
-            // Start discovery for undiscovered hubs.
+        if (undiscoveredHubs.size() > 0 && !controller->hasReconnectingHubs()) {
+            // Start discovery for undiscovered hubs (directed reconnects go first, because a scan blocks this loop).
             controller->_hubScanner->StartDiscovery(undiscoveredHubs, BLE_SCAN_DURATION_IN_SECONDS);
         }
 
         // Delay next discovery/connect attempts for a while, allowing the background tasks of already connected Hubs to send their periodic drive commands.
-        delay(BLE_CONNECT_DELAY_IN_SECONDS * 1000 / portTICK_PERIOD_MS);
+        // Stop waiting as soon as a hub dropped its connection, so we can reconnect to it immediately.
+        for (uint32_t waitedInMs = 0; waitedInMs < BLE_CONNECT_DELAY_IN_SECONDS * 1000 && !controller->hasReconnectingHubs(); waitedInMs += BLE_RECONNECT_POLL_INTERVAL_IN_MS) {
+            delay(BLE_RECONNECT_POLL_INTERVAL_IN_MS / portTICK_PERIOD_MS);
+        }
+
+        if (controller->hasReconnectingHubs()) {
+            // Don't spin while waiting for the next (backed off) directed reconnect attempt.
+            delay(BLE_RECONNECT_POLL_INTERVAL_IN_MS / portTICK_PERIOD_MS);
+        }
+    }
+}
+
+bool MTC4BTController::checkHubs(BLELocomotiveConfiguration *locoConfig)
+{
+    // Check the hubs of all locos together (like when loading the config), as we can only connect to every hub once and to a limited number of hubs.
+    std::vector<std::string> hubAddresses;
+    for (BLELocomotiveConfiguration *loco : _config->Locomotives) {
+        if (loco->_address == locoConfig->_address) {
+            // The loco we're replacing.
+            continue;
+        }
+
+        for (BLEHubConfiguration *hub : loco->_hubs) {
+            hubAddresses.push_back(hub->DeviceAddress->toString());
+        }
+    }
+
+    bool valid = true;
+    for (BLEHubConfiguration *hub : locoConfig->_hubs) {
+        std::string hubAddress = hub->DeviceAddress->toString();
+        if (std::find(hubAddresses.begin(), hubAddresses.end(), hubAddress) != hubAddresses.end()) {
+            log4MC::vlogf(LOG_ERR, "Ctrl: Hub '%s' of loco '%s' is used by another loco as well.", hubAddress.c_str(), locoConfig->_name.c_str());
+            valid = false;
+        }
+        hubAddresses.push_back(hubAddress);
+    }
+
+    if (hubAddresses.size() > CONFIG_BT_NIMBLE_MAX_CONNECTIONS) {
+        log4MC::vlogf(LOG_ERR, "Ctrl: Too many hubs configured (%u, max. is %u). Not all hubs can be connected.", hubAddresses.size(), CONFIG_BT_NIMBLE_MAX_CONNECTIONS);
+        valid = false;
     }
+
+    return valid;
+}
+
+void MTC4BTController::deleteRetiredLocomotives()
+{
+    xSemaphoreTake(_locomotivesLock, portMAX_DELAY);
+
+    for (auto retired = _retiredLocomotives.begin(); retired != _retiredLocomotives.end();) {
+        bool idle = std::all_of(retired->Hubs.begin(), retired->Hubs.end(), [](BLEHub *hub) { return hub->IsIdle(); });
+        if (!idle) {
+            // Restart the delay until the hubs are done disconnecting.
+            retired->RetiredAt = millis();
+            retired++;
+            continue;
+        }
+
+        if (millis() - retired->RetiredAt < RETIRED_LOCO_DELETE_DELAY_IN_MS) {
+            retired++;
+            continue;
+        }
+
+        // The old loco may have scheduled delayed actions since it was replaced.
+        GetTimerWheel()->CancelAll(retired->Loco);
+
+        // The config of the old loco also holds the configs of its removed hubs (the hubs that were kept use the new config).
+        for (BLEHub *hub : retired->Hubs) {
+            delete hub;
+        }
+        delete retired->Config;
+        delete retired->Loco;
+
+        retired = _retiredLocomotives.erase(retired);
+    }
+
+    xSemaphoreGive(_locomotivesLock);
+}
+
+void MTC4BTController::handleHubConnected(BLELocomotive *loco)
+{
+    if (loco->AllHubsConnected()) {
+        log4MC::vlogf(LOG_INFO, "Loop: Connected to all hubs of loco '%s'.", loco->GetLocoName().c_str());
+
+        // For hubs of this loco that have an onboard LED, force it to be on (white) by default.
+        loco->SetHubLedColor(HubLedColor::WHITE);
+
+        // Blink lights for a while when connected.
+        loco->BlinkLights(BLINK_AT_CONNECT_DURATION_IN_MS);
+    }
+}
+
+bool MTC4BTController::hasReconnectingHubs()
+{
+    for (BLELocomotive *loco : GetLocomotives()) {
+        for (BLEHub *hub : loco->Hubs) {
+            if (hub->IsReconnecting()) {
+                return true;
+            }
+        }
+    }
+
+    return false;
 }
 
 void MTC4BTController::initLocomotives(std::vector<BLELocomotiveConfiguration *> locoConfigs)
@@ -1,12 +1,17 @@
 #include "MTC4BTMQTTHandler.h"
+#include "MCJsonConfig.h"
 #include "log4MC.h"
 
 void MTC4BTMQTTHandler::Handle(const char *message, MTC4BTController *controller)
 {
     char *pos;
 
+    if (message[0] == '{') {
+        // Config changes are the only JSON messages we receive.
+        handleConfig(message, controller);
+    }
     // parse the rocrail mqtt messages, all of them,
-    if ((pos = strstr(message, "<sys ")) != nullptr) {
+    else if ((pos = strstr(message, "<sys ")) != nullptr) {
         // found <sys
         handleSys(pos, controller);
     } else if ((pos = strstr(message, "<lc ")) != nullptr) {
@@ -155,4 +160,19 @@ void MTC4BTMQTTHandler::handleFn(const char *message, MTC4BTController *controll
 
     // Ask controller to handle the function.
     controller->HandleTrigger(addr, MCTriggerSource::RocRail, "fnchanged", fnId, fnchangedstate ? "on" : "off");
+}
+
+void MTC4BTMQTTHandler::handleConfig(const char *message, MTC4BTController *controller)
+{
+    // The message contains the config of a single loco, in the same format as in the config files.
+    DynamicJsonDocument doc = MCJsonConfig::ParseJson(message);
+    JsonObject locoConfig = doc.as<JsonObject>();
+
+    if (locoConfig.isNull() || !locoConfig.containsKey("address")) {
+        log4MC::warn("MQTT: Received config change, but couldn't read loco config with 'address' attribute.");
+        return;
+    }
+
+    log4MC::vlogf(LOG_INFO, "MQTT: Received config change for loco with address '%u'.", locoConfig["address"].as<uint>());
+    controller->ReloadLocomotive(locoConfig);
 }
\ No newline at end of file
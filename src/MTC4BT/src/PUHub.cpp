@@ -12,6 +12,8 @@ PUHub::PUHub(BLEHubConfiguration *config)
     : BLEHub(config)
 {
     _hubLedPort = 0;
+
+    compileRawPwrTables();
 }
 
 bool PUHub::SetWatchdogTimeout(const uint8_t watchdogTimeOutInTensOfSeconds)
@@ -36,6 +38,10 @@ bool PUHub::SetWatchdogTimeout(const uint8_t watchdogTimeOutInTensOfSeconds)
 void PUHub::DriveTaskLoop()
 {
     for (;;) {
+        // Hold the drive lock during the pass, so the channel configs can't be swapped halfway.
+        xSemaphoreTake(_driveLock, portMAX_DELAY);
+        ulong loopStartedAt = micros();
+
         bool motorFound = false;
         int16_t currentSpeedPerc = 0;
         int16_t targetSpeedPerc = 0;
@@ -52,8 +58,15 @@ void PUHub::DriveTaskLoop()
                 // Update onboard LED channel state.
                 setLedColor(getRawLedColorForController(controller));
             } else {
+                if (controller->NeedsEncoderSubscription()) {
+                    // Ask the motor to report its speed, so we can run it closed-loop.
+                    subscribeToEncoder(controller->GetHubChannel());
+                    controller->SetEncoderSubscribed();
+                }
+
                 // Update current channel pwr.
                 controller->UpdateCurrentPwrPerc();
+                controller->UpdateSpeedControl();
 
                 // Construct drive command.
                 byte channelPwr = getRawChannelPwrForController(controller);
@@ -62,6 +75,9 @@ void PUHub::DriveTaskLoop()
             }
         }
 
+        recordDriveLoopTime(loopStartedAt);
+        xSemaphoreGive(_driveLock);
+
         // Wait half the watchdog timeout (converted from s/10 to s/1000).
         // vTaskDelay(_watchdogTimeOutInTensOfSeconds * 50 / portTICK_PERIOD_MS);
 
@@ -70,17 +86,17 @@ void PUHub::DriveTaskLoop()
     }
 }
 
-int16_t PUHub::MapPwrPercToRaw(int pwrPerc)
+int16_t PUHub::MapPwrToRaw(int32_t pwr)
 {
-    if (pwrPerc == 0) {
+    if (pwr == 0) {
         return 0; // 0 = float, 127 = stop motor
     }
 
-    if (pwrPerc > 0) {
-        return map(pwrPerc, 0, 100, PU_MIN_SPEED_FORWARD, PU_MAX_SPEED_FORWARD);
+    if (pwr > 0) {
+        return map(pwr, 0, SPEED_CURVE_MAX_PWR, PU_MIN_SPEED_FORWARD, PU_MAX_SPEED_FORWARD);
     }
 
-    return map(abs(pwrPerc), 0, 100, PU_MIN_SPEED_REVERSE, PU_MAX_SPEED_REVERSE);
+    return map(abs(pwr), 0, SPEED_CURVE_MAX_PWR, PU_MIN_SPEED_REVERSE, PU_MAX_SPEED_REVERSE);
 }
 
 void PUHub::NotifyCallback(NimBLERemoteCharacteristic *pBLERemoteCharacteristic, uint8_t *pData, size_t length, bool isNotify)
@@ -95,11 +111,10 @@ void PUHub::NotifyCallback(NimBLERemoteCharacteristic *pBLERemoteCharacteristic,
         parsePortMessage(pData);
         break;
     }
-        // case (byte)MessageType::PORT_VALUE_SINGLE:
-        // {
-        //     parseSensorMessage(pData);
-        //     break;
-        // }
+    case (byte)MessageType::PORT_VALUE_SINGLE: {
+        parseSensorMessage(pData);
+        break;
+    }
         // case (byte)MessageType::PORT_OUTPUT_COMMAND_FEEDBACK:
         // {
         //     parsePortAction(pData);
@@ -123,6 +138,61 @@ void PUHub::parsePortMessage(uint8_t *pData)
             log4MC::vlogf(LOG_INFO, "PU  : Found integrated RGB LED at port %x", port);
         }
     }
+
+    BLEHubChannelController *controller = findControllerByChannel((BLEHubChannel)port);
+    if (controller && controller->IsSpeedControlEnabled()) {
+        // The encoder subscription itself is sent from the drive task, as we shouldn't write from within a notification callback.
+        bool hasEncoder = isConnected && isMotorWithEncoder(pData[5]);
+        controller->SetEncoderAttached(hasEncoder);
+        log4MC::vlogf(LOG_INFO, "PU  : %s at port %x, running it %s.", hasEncoder ? "Found motor with encoder" : "No motor with encoder", port, hasEncoder ? "closed-loop" : "open-loop");
+    }
+}
+
+/**
+ * @brief Parse the incoming characteristic notification for a Port Value (Single) message
+ * @param [in] pData The pointer to the received data
+ */
+void PUHub::parseSensorMessage(uint8_t *pData)
+{
+    byte port = pData[3];
+
+    BLEHubChannelController *controller = findControllerByChannel((BLEHubChannel)port);
+    if (controller && controller->IsSpeedControlled()) {
+        // Motors with encoders report their speed as a signed percentage of their max. speed.
+        controller->SetMeasuredSpeedPerc((int8_t)pData[4]);
+    }
+}
+
+/**
+ * @brief Subscribe to the speed reported by the motor with encoder at the given channel
+ * @param [in] channel The hub channel the motor is attached to
+ */
+void PUHub::subscribeToEncoder(BLEHubChannel channel)
+{
+    // Port input format setup (single): report every change of at least 1% in speed mode.
+    byte setSpeedMode[8] = {0x41, (byte)channel, PU_MOTOR_MODE_SPEED, 0x01, 0x00, 0x00, 0x00, 0x01};
+    writeValue(setSpeedMode, 8);
+}
+
+/**
+ * @brief Check whether the given IO type is a motor with an encoder (tacho motor)
+ * @param [in] ioType The IO type id reported in the attached IO message
+ */
+bool PUHub::isMotorWithEncoder(byte ioType)
+{
+    switch (ioType) {
+    case 0x26: // BOOST interactive motor
+    case 0x2E: // Technic large motor
+    case 0x2F: // Technic XL motor
+    case 0x30: // Technic medium angular motor
+    case 0x31: // Technic large angular motor
+    case 0x41: // Technic small angular motor
+    case 0x4B: // Technic medium angular motor (grey)
+    case 0x4C: // Technic large angular motor (grey)
+        return true;
+    default:
+        return false;
+    }
 }
 
 /**
@@ -18,6 +18,7 @@ const int16_t SBRICK_MIN_CHANNEL_SPEED = -254;
 SBrickHub::SBrickHub(BLEHubConfiguration *config)
     : BLEHub(config)
 {
+    compileRawPwrTables();
 }
 
 bool SBrickHub::SetWatchdogTimeout(const uint8_t watchdogTimeOutInTensOfSeconds)
@@ -64,6 +65,10 @@ void SBrickHub::DriveTaskLoop()
     uint8_t channelDPwr = 0;
 
     for (;;) {
+        // Hold the drive lock during the pass, so the channel configs can't be swapped halfway.
+        xSemaphoreTake(_driveLock, portMAX_DELAY);
+        ulong loopStartedAt = micros();
+
         for (BLEHubChannelController *controller : _channelControllers) {
             // Update current channel pwr, if needed.
             controller->UpdateCurrentPwrPerc();
@@ -109,6 +114,9 @@ void SBrickHub::DriveTaskLoop()
             log4MC::vlogf(LOG_ERR, "SBK : Drive failed. Unabled to write to SBrick characteristic.");
         }
 
+        recordDriveLoopTime(loopStartedAt);
+        xSemaphoreGive(_driveLock);
+
         // Wait half the watchdog timeout (converted from s/10 to s/1000).
         // vTaskDelay(_watchdogTimeOutInTensOfSeconds * 50 / portTICK_PERIOD_MS);
 
@@ -117,10 +125,10 @@ void SBrickHub::DriveTaskLoop()
     }
 }
 
-int16_t SBrickHub::MapPwrPercToRaw(int pwrPerc)
+int16_t SBrickHub::MapPwrToRaw(int32_t pwr)
 {
     // Map absolute speed (no matter the direction) to raw channel speed.
-    return map(abs(pwrPerc), 0, 100, 0, SBRICK_MAX_CHANNEL_SPEED);
+    return map(abs(pwr), 0, SPEED_CURVE_MAX_PWR, 0, SBRICK_MAX_CHANNEL_SPEED);
 }
 
 void SBrickHub::NotifyCallback(NimBLERemoteCharacteristic *pBLERemoteCharacteristic, uint8_t *pData, size_t length, bool isNotify)
@@ -1,65 +1,91 @@
 #pragma once
 
+#include <algorithm>
+
 #include "BLELocomotiveDeserializer.h"
+#include "MTC4BTConfigurationCache.h"
 
 #define DEFAULT_CONTROLLER_NAME "MTC4BT"
-#define DEFAULT_PWR_INC_STEP 10
-#define DEFAULT_PWR_DEC_STEP 10
+#define DEFAULT_PWR_INC_RATE 40
+#define DEFAULT_PWR_DEC_RATE 40
+#define DEFAULT_PWR_JERK 0
 
-MTC4BTConfiguration *loadControllerConfiguration(const char *configFilePath)
+// Parses the JSON controller config file and the loco config files it refers to, adding the paths of all files read to the given list.
+// Invalid parts of the config are logged as errors, counted in the given error count and skipped.
+MTC4BTConfiguration *parseControllerConfiguration(const char *configFilePath, std::vector<std::string> &sourceFilePaths, uint &errorCount)
 {
     // New up a configation object, so we can set its properties.
     MTC4BTConfiguration *config = new MTC4BTConfiguration();
 
-    // Initialize file system.
-    if (!SPIFFS.begin(true)) {
-        Serial.println("Config: An error has occurred while mounting SPIFFS");
-        return config;
-    }
+    ulong startedAt = millis();
 
-    // Read JSON controller config file.
-    StaticJsonDocument<4096> doc = MCJsonConfig::ReadJsonFile(configFilePath);
+    // Read the JSON controller config file without the locos, which are read one at a time below, so memory use doesn't depend on the number of locos.
+    StaticJsonDocument<256> filter;
+    for (const char *key : {"name", "pwrIncRate", "pwrDecRate", "pwrIncStep", "pwrDecStep", "pwrJerk", "espPins", "locoConfigs"}) {
+        filter[key] = true;
+    }
+    DynamicJsonDocument doc = MCJsonConfig::ReadJsonFile(configFilePath, filter);
+    sourceFilePaths.push_back(configFilePath);
 
     // Read controller name.
     const char *controllerName = doc["name"] | DEFAULT_CONTROLLER_NAME;
-    config->ControllerName = controllerName;
+    config->ControllerName = strdup(controllerName);
     log4MC::vlogf(LOG_INFO, "Config: Read controller name: %s", config->ControllerName);
 
-    int16_t pwrIncStep = doc["pwrIncStep"] | DEFAULT_PWR_INC_STEP;
-    int16_t pwrDecStep = doc["pwrDecStep"] | DEFAULT_PWR_DEC_STEP;
+    // Read ramping rates (in %/s) and jerk (in %/s², 0 = linear ramping).
+    int16_t pwrIncRate = MCJsonConfig::ReadPwrRate(doc.as<JsonObject>(), "pwrIncRate", "pwrIncStep", DEFAULT_PWR_INC_RATE);
+    int16_t pwrDecRate = MCJsonConfig::ReadPwrRate(doc.as<JsonObject>(), "pwrDecRate", "pwrDecStep", DEFAULT_PWR_DEC_RATE);
+    int16_t pwrJerk = doc["pwrJerk"] | DEFAULT_PWR_JERK;
+    config->PwrIncRate = pwrIncRate;
+    config->PwrDecRate = pwrDecRate;
+    config->PwrJerk = pwrJerk;
 
     // Iterate over ESP pins and copy values from the JsonDocument to MCChannelConfig objects.
     JsonArray espPinConfigs = doc["espPins"].as<JsonArray>();
     for (JsonObject espPinConfig : espPinConfigs) {
         // Use pin number as its device address.
         const std::string address = espPinConfig["pin"];
-        int16_t pinPwrIncStep = espPinConfig["pwrIncStep"] | pwrIncStep;
-        int16_t pinPwrDecStep = espPinConfig["pwrDecStep"] | pwrDecStep;
+        int16_t pinPwrIncRate = MCJsonConfig::ReadPwrRate(espPinConfig, "pwrIncRate", "pwrIncStep", pwrIncRate);
+        int16_t pinPwrDecRate = MCJsonConfig::ReadPwrRate(espPinConfig, "pwrDecRate", "pwrDecStep", pwrDecRate);
+        int16_t pinPwrJerk = espPinConfig["pwrJerk"] | pwrJerk;
         const bool isInverted = espPinConfig["inverted"] | false;
         const std::string attachedDevice = espPinConfig["attachedDevice"] | "nothing";
 
+        auto samePin = [&address](MCChannelConfig *c) { return c->GetChannel()->GetAddress().compare(address) == 0; };
+        if (std::any_of(config->EspPins.begin(), config->EspPins.end(), samePin)) {
+            log4MC::vlogf(LOG_ERR, "Config: ESP pin %s configured twice. Second pin ignored.", address.c_str());
+            errorCount++;
+            continue;
+        }
+
+        if (config->EspPins.size() >= MAX_ESP_PIN_COUNT) {
+            log4MC::vlogf(LOG_ERR, "Config: Too many ESP pins configured (max. is %u). ESP pin %s ignored.", MAX_ESP_PIN_COUNT, address.c_str());
+            errorCount++;
+            continue;
+        }
+
         MCChannel *espChannel = new MCChannel(ChannelType::EspPinChannel, address);
-        config->EspPins.push_back(new MCChannelConfig(espChannel, pinPwrIncStep, pinPwrDecStep, isInverted, deviceTypeMap()[attachedDevice]));
+        config->EspPins.push_back(new MCChannelConfig(espChannel, pinPwrIncRate, pinPwrDecRate, pinPwrJerk, nullptr, isInverted, parseDeviceType(attachedDevice)));
     }
     log4MC::vlogf(LOG_INFO, "Config: Read ESP pin configuration (%u).", config->EspPins.size());
 
-    // Iterate over loco configs and copy values from the JsonDocument to BLELocomotiveConfiguration objects.
-    JsonArray locoConfigs = doc["locos"].as<JsonArray>();
-    for (JsonObject locoConfig : locoConfigs) {
+    // Read loco configs one at a time and copy values from their JsonDocuments to BLELocomotiveConfiguration objects.
+    MCJsonConfig::ReadJsonArray(configFilePath, "locos", [&](JsonObject locoConfig) {
         // Read if loco is enabled.
         const bool enabled = locoConfig["enabled"] | true;
         if (!enabled) {
             // Skip if loco is not enabled.
-            continue;
+            return;
         }
 
-        config->Locomotives.push_back(BLELocomotiveDeserializer::Deserialize(locoConfig, config->EspPins, pwrIncStep, pwrDecStep));
-    }
+        config->Locomotives.push_back(BLELocomotiveDeserializer::Deserialize(locoConfig, config->EspPins, pwrIncRate, pwrDecRate, pwrJerk, errorCount));
+    });
 
     // Read loco config files.
     JsonArray locoConfigFiles = doc["locoConfigs"].as<JsonArray>();
     for (int i = 0; i < locoConfigFiles.size(); i++) {
         const std::string locoConfigFile = locoConfigFiles[i];
+        sourceFilePaths.push_back(locoConfigFile);
 
         // Read JSON controller config file.
         DynamicJsonDocument locoConfigDoc = MCJsonConfig::ReadJsonFile(locoConfigFile.c_str());
@@ -72,9 +98,59 @@ MTC4BTConfiguration *loadControllerConfiguration(const char *configFilePath)
             continue;
         }
 
-        config->Locomotives.push_back(BLELocomotiveDeserializer::Deserialize(locoConfig, config->EspPins, pwrIncStep, pwrDecStep));
+        config->Locomotives.push_back(BLELocomotiveDeserializer::Deserialize(locoConfig, config->EspPins, pwrIncRate, pwrDecRate, pwrJerk, errorCount));
     }
 
+    // Check the hubs of all locos together, as we can only connect to every hub once and to a limited number of hubs.
+    std::vector<std::string> hubAddresses;
+    for (BLELocomotiveConfiguration *loco : config->Locomotives) {
+        for (BLEHubConfiguration *hub : loco->_hubs) {
+            std::string hubAddress = hub->DeviceAddress->toString();
+            if (std::find(hubAddresses.begin(), hubAddresses.end(), hubAddress) != hubAddresses.end()) {
+                log4MC::vlogf(LOG_ERR, "Config: Hub '%s' of loco '%s' is used by another loco as well.", hubAddress.c_str(), loco->_name.c_str());
+                errorCount++;
+            }
+            hubAddresses.push_back(hubAddress);
+        }
+    }
+
+    if (hubAddresses.size() > CONFIG_BT_NIMBLE_MAX_CONNECTIONS) {
+        log4MC::vlogf(LOG_ERR, "Config: Too many hubs configured (%u, max. is %u). Not all hubs can be connected.", hubAddresses.size(), CONFIG_BT_NIMBLE_MAX_CONNECTIONS);
+        errorCount++;
+    }
+
+    log4MC::vlogf(LOG_INFO, "Config: Read %u locos in %lu ms (free heap: %u bytes).", config->Locomotives.size(), millis() - startedAt, ESP.getFreeHeap());
+
     // Return MTC4BTConfiguration object.
+    return config;
+}
+
+MTC4BTConfiguration *loadControllerConfiguration(const char *configFilePath, const char *cacheFilePath)
+{
+    // Initialize file system (a no-op if the network configuration already mounted it).
+    if (!SPIFFS.begin(true)) {
+        Serial.println("Config: An error has occurred while mounting SPIFFS");
+        return new MTC4BTConfiguration();
+    }
+
+    // Use the compiled config cache, as long as the JSON config files didn't change since it was written.
+    MTC4BTConfiguration *config = MTC4BTConfigurationCache::Load(cacheFilePath);
+    if (config) {
+        return config;
+    }
+
+    std::vector<std::string> sourceFilePaths;
+    uint errorCount = 0;
+    config = parseControllerConfiguration(configFilePath, sourceFilePaths, errorCount);
+
+    if (errorCount > 0) {
+        // Keep reporting the errors at every boot, until they are fixed.
+        log4MC::vlogf(LOG_WARNING, "Config: Found %u errors in the config, not writing config cache.", errorCount);
+        return config;
+    }
+
+    // Compile the config into the cache, so we can skip parsing the JSON config files at the next boot.
+    MTC4BTConfigurationCache::Save(cacheFilePath, config, sourceFilePaths);
+
     return config;
 }
\ No newline at end of file
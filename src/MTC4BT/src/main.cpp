@@ -1,5 +1,6 @@
 #include <Arduino.h>
 
+#include "MCBootTimeline.h"
 #include "MTC4BTController.h"
 #include "MTC4BTMQTTHandler.h"
 #include "MattzoMQTTSubscriber.h"
@@ -11,6 +12,7 @@
 
 #define NETWORK_CONFIG_FILE "/network_config.json"
 #define CONTROLLER_CONFIG_FILE "/controller_config.json"
+#define CONTROLLER_CONFIG_CACHE_FILE "/controller_config.bin"
 
 // Globals
 MCNetworkConfiguration *networkConfig;
@@ -26,11 +28,30 @@ void handleTickerLoop(void *param)
 {
     long minuteTicker = 0;
     unsigned long timeTaken = 0;
+    uint32_t lastLoopCount = 0;
     for (;;) {
         timeTaken = millis();
         log4MC::vlogf(LOG_INFO, "Minutes uptime: %d.%02d", (minuteTicker / TICKER), (minuteTicker % TICKER) * (60 / TICKER));
         log4MC::vlogf(LOG_INFO, "  Messages in queue: %d", uxQueueMessagesWaiting(MattzoMQTTSubscriber::IncomingQueue));
         log4MC::vlogf(LOG_INFO, "  Memory Heap free: %8u max alloc: %8u min free: %8u", ESP.getFreeHeap(), ESP.getMaxAllocHeap(), ESP.getMinFreeHeap());
+        log4MC::vlogf(LOG_INFO, "  Delayed actions pending: %u dropped: %u", controller->GetTimerWheel()->GetPendingCount(), controller->GetTimerWheel()->GetOverflowCount());
+        uint32_t loopCount = controller->GetLoopCount();
+        log4MC::vlogf(LOG_INFO, "  Controller loop: %u iterations/s", (loopCount - lastLoopCount) / (60 / TICKER));
+        lastLoopCount = loopCount;
+        log4MC::vlogf(LOG_INFO, "  Log messages dropped: %u", log4MC::GetDroppedCount());
+        for (BLELocomotive *loco : controller->GetLocomotives()) {
+            log4MC::vlogf(LOG_INFO, "  Loco %s triggers: %u dispatched events: %u max lookup: %lu us", loco->GetLocoName().c_str(), loco->GetTriggerCount(), loco->GetTriggerDispatchCount(), loco->GetMaxTriggerLookupTimeInUs());
+            for (BLEHub *hub : loco->Hubs) {
+                log4MC::vlogf(LOG_INFO, "  Hub %s dropouts: %u last recovery: %lu ms fallback scans: %u", hub->GetRawAddress().c_str(), hub->GetDropoutCount(), hub->GetLastRecoveryTimeInMs(), hub->GetFallbackScanCount());
+                log4MC::vlogf(LOG_INFO, "  Hub %s drive loop avg: %lu us max: %lu us", hub->GetRawAddress().c_str(), hub->GetAvgDriveLoopTimeInUs(), hub->GetMaxDriveLoopTimeInUs());
+                for (BLEHubChannelController *channel : hub->GetChannelControllers()) {
+                    if (channel->IsSpeedControlled()) {
+                        MCSpeedController *speedController = channel->GetSpeedController();
+                        log4MC::vlogf(LOG_INFO, "  Hub %s channel %s speed: %d%% error: %d%% output: %d%%", hub->GetRawAddress().c_str(), channel->GetChannel()->GetAddress().c_str(), channel->GetMeasuredSpeedPerc(), speedController->GetError(), speedController->GetOutput());
+                    }
+                }
+            }
+        }
         minuteTicker++;
         timeTaken = abs((long)(timeTaken - millis()));
         delay(60000 / TICKER - timeTaken);
@@ -71,6 +92,8 @@ void handleMQTTMessageLoop(void *parm)
 
 void setup()
 {
+    MCBootTimeline::Mark("setup");
+
     // Configure Serial.
     Serial.begin(115200);
 
@@ -83,26 +106,32 @@ void setup()
     // Load the network configuration.
     Serial.println("[" + String(xPortGetCoreID()) + "] Setup: Loading network configuration...");
     networkConfig = loadNetworkConfiguration(NETWORK_CONFIG_FILE);
+    MCBootTimeline::Mark("network_config");
 
     // Setup logging (from now on we can use log4MC).
     log4MC::Setup(networkConfig->WiFi->hostname.c_str(), networkConfig->Logging);
 
+    // Setup WiFi. It connects in the background, while we bring up the rest of the controller.
+    MattzoWifiClient::Setup(networkConfig->WiFi);
+
     // Load the controller configuration.
     log4MC::info("Setup: Loading controller configuration...");
-    controllerConfig = loadControllerConfiguration(CONTROLLER_CONFIG_FILE);
+    controllerConfig = loadControllerConfiguration(CONTROLLER_CONFIG_FILE, CONTROLLER_CONFIG_CACHE_FILE);
+    MCBootTimeline::Mark("controller_config");
+
+    // Setup the controller (starts BLE discovery in the background).
     controller = new MTC4BTController();
     controller->Setup(controllerConfig);
+    MCBootTimeline::Mark("controller_setup");
     log4MC::info("Setup: Controller configuration completed.");
 
-    // Setup and connect to WiFi.
-    MattzoWifiClient::Setup(networkConfig->WiFi);
-
     // Setup MQTT publisher (with a queue that can hold 1000 messages).
     // MattzoMQTTPublisher::Setup(ROCRAIL_COMMAND_QUEUE, MQTT_OUTGOING_QUEUE_LENGTH);
 
-    // Setup MQTT subscriber (use controller name as part of the subscriber name).
+    // Setup MQTT subscriber (use controller name as part of the subscriber name). It connects as soon as WiFi is up.
     networkConfig->MQTT->SubscriberName = controllerConfig->ControllerName;
     MattzoMQTTSubscriber::Setup(networkConfig->MQTT, handleMQTTMessageLoop);
+    MCBootTimeline::Mark("mqtt_setup");
 
     log4MC::info("Setup: MattzoTrainController for BLE running.");
     log4MC::vlogf(LOG_INFO, "Setup: Number of locos to discover hubs for: %u", controllerConfig->Locomotives.size());
@@ -0,0 +1,54 @@
+#pragma once
+
+// Host stand-ins for the parts of the Arduino API used by the controller's config code.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <sys/types.h>
+#include <vector>
+
+typedef unsigned long ulong;
+
+#define F(string) string
+
+// Returns the number of milliseconds since the tool started.
+unsigned long millis();
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+template <typename A, typename B>
+typename std::common_type<A, B>::type min(A a, B b)
+{
+    return a < b ? a : b;
+}
+
+template <typename A, typename B>
+typename std::common_type<A, B>::type max(A a, B b)
+{
+    return a > b ? a : b;
+}
+
+// Writes to stderr.
+class HardwareSerial
+{
+  public:
+    void print(const char *message);
+    void println(const char *message = "");
+};
+
+extern HardwareSerial Serial;
+
+class EspClass
+{
+  public:
+    // There's no heap to report on the host.
+    uint32_t getFreeHeap();
+};
+
+extern EspClass ESP;
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Host stand-in for the NimBLE address, parsing and formatting addresses the same way.
+class NimBLEAddress
+{
+  public:
+    // Parses an address formatted as 'xx:xx:xx:xx:xx:xx' (all zeros if it's invalid).
+    NimBLEAddress(const std::string &address);
+
+    // Returns the address formatted as 'xx:xx:xx:xx:xx:xx' (lower case).
+    std::string toString() const;
+
+    bool equals(const NimBLEAddress &otherAddress) const;
+
+    // Returns the address bytes in little endian order.
+    const uint8_t *getNative() const;
+
+  private:
+    uint8_t _address[6];
+};
\ No newline at end of file
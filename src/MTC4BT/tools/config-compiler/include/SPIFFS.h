@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+
+// Host stand-in for an Arduino file, backed by a file in the data folder.
+class File
+{
+  public:
+    File(FILE *file = nullptr);
+
+    operator bool() const;
+    size_t size();
+    size_t position();
+    bool seek(size_t position);
+    int available();
+    int peek();
+    int read();
+    size_t read(uint8_t *buffer, size_t size);
+    size_t readBytes(char *buffer, size_t size);
+    size_t write(const uint8_t *buffer, size_t size);
+
+    void close();
+
+  private:
+    std::shared_ptr<FILE> _file;
+};
+
+// Host stand-in for the SPIFFS file system, mapping the absolute paths used by the controller to files in the data folder.
+class HostFS
+{
+  public:
+    // Sets the data folder (the folder uploaded to SPIFFS by 'pio run -t uploadfs').
+    void SetRoot(const std::string &root);
+
+    bool begin(bool formatOnFail = false);
+    bool exists(const char *path);
+    File open(const char *path, const char *mode = FILE_READ);
+    bool remove(const char *path);
+
+  private:
+    std::string getHostPath(const char *path);
+
+    std::string _root;
+};
+
+extern HostFS SPIFFS;
\ No newline at end of file
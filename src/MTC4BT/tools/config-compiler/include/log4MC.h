@@ -0,0 +1,31 @@
+#pragma once
+
+#include <Arduino.h>
+#include <syslog.h>
+
+// Host stand-in for the controller's logger. Writes to stderr and counts the logged warnings and errors.
+class log4MC
+{
+  public:
+    static void vlogf(uint8_t level, const char *fmt, ...);
+    static void log(uint8_t level, const char *message);
+    static void debug(const char *message);
+    static void info(const char *message);
+    static void warn(const char *message);
+    static void error(const char *message);
+    static void fatal(const char *message);
+
+    // Returns the number of logged warnings.
+    static uint GetWarningCount();
+
+    // Returns the number of logged errors (or worse).
+    static uint GetErrorCount();
+
+    // Sets whether info and debug messages are logged.
+    static void SetVerbose(bool verbose);
+
+  private:
+    static uint _warningCount;
+    static uint _errorCount;
+    static bool _verbose;
+};
\ No newline at end of file
@@ -0,0 +1,15 @@
+// Compiles the controller's config code for the host, so the tool validates and compiles configs exactly the way the controller does.
+
+#include "../../../../lib/MController/MCBinaryReader.cpp"
+#include "../../../../lib/MController/MCBinaryWriter.cpp"
+#include "../../../../lib/MController/MCChannel.cpp"
+#include "../../../../lib/MController/MCChannelConfig.cpp"
+#include "../../../../lib/MController/MCJsonConfig.cpp"
+#include "../../../../lib/MController/MCLocoAction.cpp"
+#include "../../../../lib/MController/MCLocoEvent.cpp"
+#include "../../../../lib/MController/MCLocoTrigger.cpp"
+#include "../../../../lib/MController/MCSpeedCurve.cpp"
+#include "../../../src/BLEHubConfiguration.cpp"
+#include "../../../src/BLELocomotiveConfiguration.cpp"
+#include "../../../src/BLELocomotiveDeserializer.cpp"
+#include "../../../src/MTC4BTConfigurationCache.cpp"
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include <cstdarg>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "NimBLEAddress.h"
+#include "SPIFFS.h"
+#include "log4MC.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+HostFS SPIFFS;
+
+unsigned long millis()
+{
+    static timespec startedAt;
+    timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (startedAt.tv_sec == 0 && startedAt.tv_nsec == 0) {
+        startedAt = now;
+    }
+
+    return (now.tv_sec - startedAt.tv_sec) * 1000 + (now.tv_nsec - startedAt.tv_nsec) / 1000000;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+void HardwareSerial::print(const char *message)
+{
+    fputs(message, stderr);
+}
+
+void HardwareSerial::println(const char *message)
+{
+    fprintf(stderr, "%s\n", message);
+}
+
+uint32_t EspClass::getFreeHeap()
+{
+    return 0;
+}
+
+File::File(FILE *file)
+{
+    if (file) {
+        _file = std::shared_ptr<FILE>(file, fclose);
+    }
+}
+
+File::operator bool() const
+{
+    return _file != nullptr;
+}
+
+size_t File::size()
+{
+    struct stat info;
+    return fstat(fileno(_file.get()), &info) == 0 ? info.st_size : 0;
+}
+
+size_t File::position()
+{
+    return ftell(_file.get());
+}
+
+bool File::seek(size_t position)
+{
+    return fseek(_file.get(), position, SEEK_SET) == 0;
+}
+
+int File::available()
+{
+    return size() - position();
+}
+
+int File::peek()
+{
+    int c = getc(_file.get());
+    if (c != EOF) {
+        ungetc(c, _file.get());
+    }
+
+    return c == EOF ? -1 : c;
+}
+
+int File::read()
+{
+    int c = getc(_file.get());
+    return c == EOF ? -1 : c;
+}
+
+size_t File::read(uint8_t *buffer, size_t size)
+{
+    return fread(buffer, 1, size, _file.get());
+}
+
+size_t File::readBytes(char *buffer, size_t size)
+{
+    return fread(buffer, 1, size, _file.get());
+}
+
+size_t File::write(const uint8_t *buffer, size_t size)
+{
+    return fwrite(buffer, 1, size, _file.get());
+}
+
+void File::close()
+{
+    _file.reset();
+}
+
+void HostFS::SetRoot(const std::string &root)
+{
+    _root = root;
+}
+
+bool HostFS::begin(bool formatOnFail)
+{
+    struct stat info;
+    return stat(_root.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+bool HostFS::exists(const char *path)
+{
+    struct stat info;
+    return stat(getHostPath(path).c_str(), &info) == 0;
+}
+
+File HostFS::open(const char *path, const char *mode)
+{
+    return File(fopen(getHostPath(path).c_str(), strcmp(mode, FILE_WRITE) == 0 ? "wb" : "rb"));
+}
+
+bool HostFS::remove(const char *path)
+{
+    return ::remove(getHostPath(path).c_str()) == 0;
+}
+
+std::string HostFS::getHostPath(const char *path)
+{
+    // Paths on SPIFFS are absolute, so they can simply be appended to the data folder.
+    return _root + (path[0] == '/' ? "" : "/") + path;
+}
+
+NimBLEAddress::NimBLEAddress(const std::string &address)
+{
+    memset(_address, 0, sizeof(_address));
+
+    unsigned int bytes[6];
+    if (address.length() == 17 && sscanf(address.c_str(), "%2x:%2x:%2x:%2x:%2x:%2x", &bytes[5], &bytes[4], &bytes[3], &bytes[2], &bytes[1], &bytes[0]) == 6) {
+        for (int i = 0; i < 6; i++) {
+            _address[i] = bytes[i];
+        }
+    }
+}
+
+std::string NimBLEAddress::toString() const
+{
+    char address[18];
+    snprintf(address, sizeof(address), "%02x:%02x:%02x:%02x:%02x:%02x", _address[5], _address[4], _address[3], _address[2], _address[1], _address[0]);
+    return address;
+}
+
+bool NimBLEAddress::equals(const NimBLEAddress &otherAddress) const
+{
+    return memcmp(_address, otherAddress._address, sizeof(_address)) == 0;
+}
+
+const uint8_t *NimBLEAddress::getNative() const
+{
+    return _address;
+}
+
+void log4MC::vlogf(uint8_t level, const char *fmt, ...)
+{
+    char message[512];
+
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(message, sizeof(message), fmt, args);
+    va_end(args);
+
+    log(level, message);
+}
+
+void log4MC::log(uint8_t level, const char *message)
+{
+    if (level <= LOG_ERR) {
+        _errorCount++;
+        fprintf(stderr, "error: %s\n", message);
+    } else if (level == LOG_WARNING) {
+        _warningCount++;
+        fprintf(stderr, "warning: %s\n", message);
+    } else if (_verbose) {
+        fprintf(stderr, "%s\n", message);
+    }
+}
+
+void log4MC::debug(const char *message)
+{
+    log(LOG_DEBUG, message);
+}
+
+void log4MC::info(const char *message)
+{
+    log(LOG_INFO, message);
+}
+
+void log4MC::warn(const char *message)
+{
+    log(LOG_WARNING, message);
+}
+
+void log4MC::error(const char *message)
+{
+    log(LOG_ERR, message);
+}
+
+void log4MC::fatal(const char *message)
+{
+    log(LOG_CRIT, message);
+}
+
+uint log4MC::GetWarningCount()
+{
+    return _warningCount;
+}
+
+uint log4MC::GetErrorCount()
+{
+    return _errorCount;
+}
+
+void log4MC::SetVerbose(bool verbose)
+{
+    _verbose = verbose;
+}
+
+uint log4MC::_warningCount = 0;
+uint log4MC::_errorCount = 0;
+bool log4MC::_verbose = false;
\ No newline at end of file
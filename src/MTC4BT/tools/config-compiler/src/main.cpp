@@ -0,0 +1,113 @@
+#include <Arduino.h>
+
+#include "MCJsonConfig.h"
+#include "log4MC.h"
+#include "loadControllerConfiguration.h"
+#include "loadNetworkConfiguration.h"
+
+// Keep in sync with the file names in the controller's main.cpp.
+#define NETWORK_CONFIG_FILE "/network_config.json"
+#define CONTROLLER_CONFIG_FILE "/controller_config.json"
+#define CONTROLLER_CONFIG_CACHE_FILE "/controller_config.bin"
+
+// Returns whether the given file exists and contains valid JSON, logging an error if it doesn't.
+bool checkJsonFile(const char *jsonFilePath)
+{
+    if (!SPIFFS.exists(jsonFilePath)) {
+        log4MC::vlogf(LOG_ERR, "Config: File %s not found.", jsonFilePath);
+        return false;
+    }
+
+    if (MCJsonConfig::ReadJsonFile(jsonFilePath).isNull()) {
+        log4MC::vlogf(LOG_ERR, "Config: File %s doesn't contain valid JSON.", jsonFilePath);
+        return false;
+    }
+
+    return true;
+}
+
+// Checks the network config, so a typo doesn't leave the controller unreachable.
+void checkNetworkConfiguration()
+{
+    if (!checkJsonFile(NETWORK_CONFIG_FILE)) {
+        return;
+    }
+
+    MCNetworkConfiguration *networkConfig = loadNetworkConfiguration(NETWORK_CONFIG_FILE);
+
+    if (networkConfig->WiFi->SSID.empty()) {
+        log4MC::error("Config: No WiFi SSID configured (wifi.SSID).");
+    }
+
+    if (networkConfig->MQTT->ServerAddress.empty()) {
+        log4MC::error("Config: No MQTT broker configured (mqtt.broker).");
+    }
+}
+
+// Checks the controller config and the loco configs it refers to. Returns the config, or nullptr if it's invalid.
+MTC4BTConfiguration *checkControllerConfiguration()
+{
+    if (!checkJsonFile(CONTROLLER_CONFIG_FILE)) {
+        return nullptr;
+    }
+
+    std::vector<std::string> sourceFilePaths;
+    uint errorCount = 0;
+    MTC4BTConfiguration *config = parseControllerConfiguration(CONTROLLER_CONFIG_FILE, sourceFilePaths, errorCount);
+
+    // The first source file is the controller config, which has been checked above.
+    for (size_t i = 1; i < sourceFilePaths.size(); i++) {
+        checkJsonFile(sourceFilePaths[i].c_str());
+    }
+
+    const NimBLEAddress invalidAddress("00:00:00:00:00:00");
+    for (BLELocomotiveConfiguration *loco : config->Locomotives) {
+        for (BLEHubConfiguration *hub : loco->_hubs) {
+            if (hub->DeviceAddress->equals(invalidAddress)) {
+                log4MC::vlogf(LOG_ERR, "Config: Hub of loco '%s' has an invalid address (expected 'xx:xx:xx:xx:xx:xx').", loco->_name.c_str());
+            }
+        }
+    }
+
+    if (errorCount > 0 || log4MC::GetErrorCount() > 0) {
+        return nullptr;
+    }
+
+    if (!MTC4BTConfigurationCache::Save(CONTROLLER_CONFIG_CACHE_FILE, config, sourceFilePaths)) {
+        return nullptr;
+    }
+
+    return config;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <data folder>\n", argv[0]);
+        return 2;
+    }
+
+    SPIFFS.SetRoot(argv[1]);
+    if (!SPIFFS.begin()) {
+        fprintf(stderr, "error: Data folder %s not found.\n", argv[1]);
+        return 2;
+    }
+
+    checkNetworkConfiguration();
+    MTC4BTConfiguration *config = checkControllerConfiguration();
+
+    if (!config || log4MC::GetErrorCount() > 0) {
+        // Don't leave a stale cache behind, as it would be uploaded along with the broken config files.
+        SPIFFS.remove(CONTROLLER_CONFIG_CACHE_FILE);
+        fprintf(stderr, "Config is invalid (%u errors, %u warnings).\n", log4MC::GetErrorCount(), log4MC::GetWarningCount());
+        return 1;
+    }
+
+    uint hubCount = 0;
+    for (BLELocomotiveConfiguration *loco : config->Locomotives) {
+        hubCount += loco->_hubs.size();
+    }
+
+    printf("Config is valid (%u warnings): %u locos, %u hubs, %u ESP pins. Wrote %s.\n", log4MC::GetWarningCount(), (uint)config->Locomotives.size(), hubCount, (uint)config->EspPins.size(), CONTROLLER_CONFIG_CACHE_FILE);
+    return 0;
+}
\ No newline at end of file
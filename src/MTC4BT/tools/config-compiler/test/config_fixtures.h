@@ -0,0 +1,45 @@
+#pragma once
+
+// Config files shared by the tests of the controller's config code.
+
+#include <SPIFFS.h>
+#include <string>
+
+// Writes the given JSON to the given file in the data folder.
+void writeFile(const char *path, const std::string &json)
+{
+    File file = SPIFFS.open(path, FILE_WRITE);
+    file.write((const uint8_t *)json.c_str(), json.size());
+    file.close();
+}
+
+// Returns the JSON of a loco with two hubs, lights and a few events.
+std::string locoJson(int address)
+{
+    char json[1536];
+    snprintf(json, sizeof(json),
+             "{\"address\": %d, \"name\": \"loco %d\", \"enabled\": true,"
+             "\"bleHubs\": ["
+             "{\"type\": \"PU\", \"address\": \"90:84:2b:00:00:%02x\", \"channels\": [{\"channel\": \"A\", \"attachedDevice\": \"motor\", \"direction\": \"forward\"}, {\"channel\": \"B\", \"attachedDevice\": \"light\"}]},"
+             "{\"type\": \"PU\", \"address\": \"90:84:2b:00:01:%02x\", \"channels\": [{\"channel\": \"A\", \"attachedDevice\": \"motor\", \"direction\": \"reverse\"}, {\"channel\": \"B\", \"attachedDevice\": \"light\"}]}"
+             "],"
+             "\"events\": ["
+             "{\"triggers\": [{\"source\": \"rr\", \"eventType\": \"fnchanged\", \"identifier\": \"f1\", \"value\": \"on\"}], \"actions\": [{\"address\": \"90:84:2b:00:00:%02x\", \"channel\": \"B\", \"pwrPerc\": 100}]},"
+             "{\"triggers\": [{\"source\": \"rr\", \"eventType\": \"fnchanged\", \"identifier\": \"f1\", \"value\": \"off\"}], \"actions\": [{\"address\": \"90:84:2b:00:00:%02x\", \"channel\": \"B\", \"pwrPerc\": 0}]}"
+             "]}",
+             address, address, address, address, address, address);
+    return json;
+}
+
+// Writes a controller config with the given number of locos to the data folder. Returns the size of the file.
+size_t writeControllerConfig(const char *path, int locoCount)
+{
+    std::string json = "{\"name\": \"benchmark\", \"locos\": [";
+    for (int i = 1; i <= locoCount; i++) {
+        json += (i > 1 ? ",\n" : "\n") + locoJson(i);
+    }
+    json += "\n]}";
+    writeFile(path, json);
+
+    return json.size();
+}
\ No newline at end of file
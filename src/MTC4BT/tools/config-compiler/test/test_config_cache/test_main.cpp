@@ -0,0 +1,180 @@
+// Tests and benchmarks booting from the compiled config cache (MTC4BTConfigurationCache::Load), against parsing the JSON config and deserializing its locos (parseControllerConfiguration) on the same config.
+
+#include <chrono>
+#include <unistd.h>
+#include <unity.h>
+
+#include "../../src/firmware.cpp"
+#include "../../src/host.cpp"
+#include "../config_fixtures.h"
+#include "loadControllerConfiguration.h"
+
+#define CONFIG_FILE "/controller_config.json"
+#define CACHE_FILE "/controller_config.bin"
+
+// Number of locos of the benchmark config (2 hubs each, so all hubs can be connected).
+#define BENCHMARK_LOCO_COUNT 4
+
+// Number of boots timed.
+#define BENCHMARK_REPEAT_COUNT 100
+
+std::string dataFolder;
+
+// Deletes the given config.
+void deleteConfiguration(MTC4BTConfiguration *config)
+{
+    for (BLELocomotiveConfiguration *loco : config->Locomotives) {
+        delete loco;
+    }
+
+    for (MCChannelConfig *espPin : config->EspPins) {
+        delete espPin;
+    }
+
+    free((void *)config->ControllerName);
+    delete config;
+}
+
+// Returns the config parsed from the JSON config file, checking it has no errors.
+MTC4BTConfiguration *parseConfig(std::vector<std::string> &sourceFilePaths)
+{
+    uint errorCount = 0;
+    MTC4BTConfiguration *config = parseControllerConfiguration(CONFIG_FILE, sourceFilePaths, errorCount);
+    TEST_ASSERT_EQUAL_UINT32(0, errorCount);
+
+    return config;
+}
+
+// Writes the config cache of the JSON config file.
+void saveCache()
+{
+    std::vector<std::string> sourceFilePaths;
+    MTC4BTConfiguration *config = parseConfig(sourceFilePaths);
+    TEST_ASSERT_TRUE(MTC4BTConfigurationCache::Save(CACHE_FILE, config, sourceFilePaths));
+    deleteConfiguration(config);
+}
+
+// Returns the size of the given file in the data folder.
+size_t fileSize(const char *path)
+{
+    File file = SPIFFS.open(path);
+    size_t size = file.size();
+    file.close();
+
+    return size;
+}
+
+void setUp()
+{
+    writeControllerConfig(CONFIG_FILE, BENCHMARK_LOCO_COUNT);
+    SPIFFS.remove(CACHE_FILE);
+}
+
+void tearDown()
+{
+}
+
+void test_cache_loads_same_config()
+{
+    saveCache();
+
+    std::vector<std::string> sourceFilePaths;
+    MTC4BTConfiguration *parsed = parseConfig(sourceFilePaths);
+    MTC4BTConfiguration *cached = MTC4BTConfigurationCache::Load(CACHE_FILE);
+    TEST_ASSERT_NOT_NULL(cached);
+
+    TEST_ASSERT_EQUAL_STRING(parsed->ControllerName, cached->ControllerName);
+    TEST_ASSERT_EQUAL_INT16(parsed->PwrIncRate, cached->PwrIncRate);
+    TEST_ASSERT_EQUAL_INT16(parsed->PwrDecRate, cached->PwrDecRate);
+    TEST_ASSERT_EQUAL_INT16(parsed->PwrJerk, cached->PwrJerk);
+    TEST_ASSERT_EQUAL_UINT32(BENCHMARK_LOCO_COUNT, parsed->Locomotives.size());
+    TEST_ASSERT_EQUAL_UINT32(parsed->Locomotives.size(), cached->Locomotives.size());
+
+    for (size_t i = 0; i < parsed->Locomotives.size(); i++) {
+        BLELocomotiveConfiguration *parsedLoco = parsed->Locomotives[i];
+        BLELocomotiveConfiguration *cachedLoco = cached->Locomotives[i];
+        TEST_ASSERT_EQUAL_UINT32(parsedLoco->_address, cachedLoco->_address);
+        TEST_ASSERT_EQUAL_STRING(parsedLoco->_name.c_str(), cachedLoco->_name.c_str());
+        TEST_ASSERT_EQUAL_UINT32(parsedLoco->_hubs.size(), cachedLoco->_hubs.size());
+
+        for (size_t j = 0; j < parsedLoco->_hubs.size(); j++) {
+            BLEHubConfiguration *parsedHub = parsedLoco->_hubs[j];
+            BLEHubConfiguration *cachedHub = cachedLoco->_hubs[j];
+            TEST_ASSERT_TRUE(parsedHub->DeviceAddress->equals(*cachedHub->DeviceAddress));
+            TEST_ASSERT_EQUAL_UINT32(parsedHub->Channels.size(), cachedHub->Channels.size());
+
+            for (size_t k = 0; k < parsedHub->Channels.size(); k++) {
+                TEST_ASSERT_EQUAL_INT(parsedHub->Channels[k]->GetChannel()->GetResolvedAddress(), cachedHub->Channels[k]->GetChannel()->GetResolvedAddress());
+                TEST_ASSERT_EQUAL(parsedHub->Channels[k]->IsInverted(), cachedHub->Channels[k]->IsInverted());
+                TEST_ASSERT_EQUAL(parsedHub->Channels[k]->GetAttachedDeviceType(), cachedHub->Channels[k]->GetAttachedDeviceType());
+            }
+        }
+
+        TEST_ASSERT_EQUAL_UINT32(parsedLoco->_events.size(), cachedLoco->_events.size());
+        for (size_t j = 0; j < parsedLoco->_events.size(); j++) {
+            MCLocoTrigger *parsedTrigger = parsedLoco->_events[j]->GetTriggers()[0];
+            MCLocoTrigger *cachedTrigger = cachedLoco->_events[j]->GetTriggers()[0];
+            TEST_ASSERT_EQUAL_STRING(parsedTrigger->GetEventId().c_str(), cachedTrigger->GetEventId().c_str());
+            TEST_ASSERT_EQUAL_STRING(parsedTrigger->GetValue().c_str(), cachedTrigger->GetValue().c_str());
+            TEST_ASSERT_EQUAL_INT16(parsedLoco->_events[j]->GetActions()[0]->GetTargetPowerPerc(), cachedLoco->_events[j]->GetActions()[0]->GetTargetPowerPerc());
+        }
+    }
+
+    deleteConfiguration(parsed);
+    deleteConfiguration(cached);
+}
+
+void test_cache_is_ignored_after_config_change()
+{
+    saveCache();
+
+    writeControllerConfig(CONFIG_FILE, BENCHMARK_LOCO_COUNT - 1);
+    TEST_ASSERT_NULL(MTC4BTConfigurationCache::Load(CACHE_FILE));
+}
+
+void test_benchmark_cache_vs_json()
+{
+    saveCache();
+
+    auto jsonStartedAt = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_REPEAT_COUNT; i++) {
+        std::vector<std::string> sourceFilePaths;
+        uint errorCount = 0;
+        deleteConfiguration(parseControllerConfiguration(CONFIG_FILE, sourceFilePaths, errorCount));
+    }
+    double jsonUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - jsonStartedAt).count() / BENCHMARK_REPEAT_COUNT;
+
+    auto cacheStartedAt = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_REPEAT_COUNT; i++) {
+        MTC4BTConfiguration *config = MTC4BTConfigurationCache::Load(CACHE_FILE);
+        TEST_ASSERT_NOT_NULL(config);
+        deleteConfiguration(config);
+    }
+    double cacheUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - cacheStartedAt).count() / BENCHMARK_REPEAT_COUNT;
+
+    // The cache is checked against the JSON config file at every boot, so its load time includes checksumming the JSON file.
+    char message[256];
+    snprintf(message, sizeof(message), "%d locos: JSON config (%u bytes) parsed and deserialized in %.0f us, config cache (%u bytes) loaded in %.0f us.",
+             BENCHMARK_LOCO_COUNT, (uint)fileSize(CONFIG_FILE), jsonUs, (uint)fileSize(CACHE_FILE), cacheUs);
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_TRUE(cacheUs < jsonUs);
+}
+
+int main(int argc, char **argv)
+{
+    char folder[] = "/tmp/config-compiler-test-XXXXXX";
+    dataFolder = mkdtemp(folder);
+    SPIFFS.SetRoot(dataFolder);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_cache_loads_same_config);
+    RUN_TEST(test_cache_is_ignored_after_config_change);
+    RUN_TEST(test_benchmark_cache_vs_json);
+    int failures = UNITY_END();
+
+    SPIFFS.remove(CONFIG_FILE);
+    SPIFFS.remove(CACHE_FILE);
+    rmdir(dataFolder.c_str());
+    return failures;
+}
\ No newline at end of file
@@ -0,0 +1,260 @@
+// Tests and benchmarks reading the 'locos' array of the controller config one loco at a time (MCJsonConfig::ReadJsonArray), against reading the whole file into one document.
+
+#include <chrono>
+#include <malloc.h>
+#include <unistd.h>
+#include <unity.h>
+
+#include "../../src/firmware.cpp"
+#include "../../src/host.cpp"
+#include "../config_fixtures.h"
+#include "loadControllerConfiguration.h"
+
+// Number of times every loader is timed.
+#define BENCHMARK_REPEAT_COUNT 10
+
+std::string dataFolder;
+
+// Heap in use (in bytes), and the highest heap in use since the last reset, counted by the malloc family below.
+long heapInUse = 0;
+long peakHeapInUse = 0;
+
+// glibc's own allocator, which the malloc family below forwards to.
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+extern "C" void __libc_free(void *ptr);
+
+void countAllocated(void *ptr)
+{
+    if (ptr) {
+        heapInUse += malloc_usable_size(ptr);
+        peakHeapInUse = max(peakHeapInUse, heapInUse);
+    }
+}
+
+void countFreed(void *ptr)
+{
+    if (ptr) {
+        heapInUse -= malloc_usable_size(ptr);
+    }
+}
+
+// Counts every allocation, including the ones of ArduinoJson's documents (malloc) and the ones of the config objects (operator new).
+extern "C" void *malloc(size_t size) noexcept
+{
+    void *ptr = __libc_malloc(size);
+    countAllocated(ptr);
+    return ptr;
+}
+
+extern "C" void *calloc(size_t count, size_t size) noexcept
+{
+    void *ptr = __libc_calloc(count, size);
+    countAllocated(ptr);
+    return ptr;
+}
+
+extern "C" void *realloc(void *ptr, size_t size) noexcept
+{
+    countFreed(ptr);
+    void *newPtr = __libc_realloc(ptr, size);
+    countAllocated(newPtr);
+    return newPtr;
+}
+
+extern "C" void free(void *ptr) noexcept
+{
+    countFreed(ptr);
+    __libc_free(ptr);
+}
+
+// Time and heap needed to load the locos of the benchmark config.
+struct LoadResult {
+    // Avg. time to load all locos (in microseconds).
+    double TimeInUs;
+
+    // Peak heap in use while loading the locos, on top of the heap in use before.
+    long PeakHeap;
+
+    // Part of the peak heap not used by the loaded loco configs (mostly JSON documents).
+    long DocumentHeap;
+};
+
+// Reads the whole given file into one document, doubling its capacity until the JSON fits.
+// Unlike MCJsonConfig::ReadJsonFile, there's no max. capacity, so loading the whole file can be compared for every number of locos.
+DynamicJsonDocument readWholeFile(const char *path)
+{
+    File file = SPIFFS.open(path);
+
+    for (size_t capacity = JSON_DOCUMENT_INITIAL_SIZE;; capacity *= 2) {
+        DynamicJsonDocument doc(capacity);
+
+        file.seek(0);
+        if (deserializeJson(doc, file) != DeserializationError::NoMemory) {
+            doc.shrinkToFit();
+            return doc;
+        }
+    }
+}
+
+// Loads the locos of the given config file from one document holding the whole file (the way the controller read its config before).
+void loadWholeFile(const char *path, std::vector<BLELocomotiveConfiguration *> &locos, uint &errorCount)
+{
+    DynamicJsonDocument doc = readWholeFile(path);
+
+    for (JsonObject locoConfig : doc["locos"].as<JsonArray>()) {
+        locos.push_back(BLELocomotiveDeserializer::Deserialize(locoConfig, {}, DEFAULT_PWR_INC_RATE, DEFAULT_PWR_DEC_RATE, DEFAULT_PWR_JERK, errorCount));
+    }
+}
+
+// Loads the locos of the given config file one at a time (the way parseControllerConfiguration reads them).
+void loadStreamed(const char *path, std::vector<BLELocomotiveConfiguration *> &locos, uint &errorCount)
+{
+    MCJsonConfig::ReadJsonArray(path, "locos", [&](JsonObject locoConfig) {
+        locos.push_back(BLELocomotiveDeserializer::Deserialize(locoConfig, {}, DEFAULT_PWR_INC_RATE, DEFAULT_PWR_DEC_RATE, DEFAULT_PWR_JERK, errorCount));
+    });
+}
+
+// Loads the locos of the given config file with the given loader, checking every loco is read completely. Returns the avg. time and the peak heap.
+LoadResult benchmarkLoader(const char *path, int locoCount, void (*load)(const char *, std::vector<BLELocomotiveConfiguration *> &, uint &))
+{
+    LoadResult result = {0, 0, 0};
+    std::chrono::steady_clock::duration totalTime{0};
+
+    for (int i = 0; i < BENCHMARK_REPEAT_COUNT; i++) {
+        std::vector<BLELocomotiveConfiguration *> locos;
+        uint errorCount = 0;
+
+        long heapBefore = heapInUse;
+        peakHeapInUse = heapInUse;
+        auto startedAt = std::chrono::steady_clock::now();
+        load(path, locos, errorCount);
+        totalTime += std::chrono::steady_clock::now() - startedAt;
+
+        result.PeakHeap = peakHeapInUse - heapBefore;
+        result.DocumentHeap = peakHeapInUse - heapInUse;
+
+        TEST_ASSERT_EQUAL_UINT32(0, errorCount);
+        TEST_ASSERT_EQUAL_UINT32(locoCount, locos.size());
+        for (BLELocomotiveConfiguration *loco : locos) {
+            TEST_ASSERT_EQUAL_UINT32(2, loco->_hubs.size());
+            TEST_ASSERT_EQUAL_UINT32(2, loco->_events.size());
+
+            // The triggers are read with the keys of the actual config schema.
+            MCLocoTrigger *trigger = loco->_events[0]->GetTriggers()[0];
+            TEST_ASSERT_TRUE(trigger->GetSource() == MCTriggerSource::RocRail);
+            TEST_ASSERT_EQUAL_STRING("f1", trigger->GetEventId().c_str());
+            TEST_ASSERT_EQUAL_STRING("on", trigger->GetValue().c_str());
+            TEST_ASSERT_EQUAL_UINT32(1, loco->_events[0]->GetActions().size());
+
+            delete loco;
+        }
+    }
+
+    result.TimeInUs = std::chrono::duration<double, std::micro>(totalTime).count() / BENCHMARK_REPEAT_COUNT;
+    return result;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_reads_all_elements()
+{
+    writeFile("/test.json", "{\"locos\": [" + locoJson(1) + ", " + locoJson(2) + ",\n" + locoJson(3) + "]}");
+
+    std::vector<int> addresses;
+    uint count = MCJsonConfig::ReadJsonArray("/test.json", "locos", [&](JsonObject locoConfig) {
+        addresses.push_back(locoConfig["address"]);
+    });
+
+    TEST_ASSERT_EQUAL_UINT32(3, count);
+    TEST_ASSERT_EQUAL_INT(1, addresses[0]);
+    TEST_ASSERT_EQUAL_INT(2, addresses[1]);
+    TEST_ASSERT_EQUAL_INT(3, addresses[2]);
+}
+
+void test_reads_empty_and_missing_array()
+{
+    uint calls = 0;
+
+    writeFile("/test.json", "{\"name\": \"test\", \"locos\": [ ]}");
+    TEST_ASSERT_EQUAL_UINT32(0, MCJsonConfig::ReadJsonArray("/test.json", "locos", [&](JsonObject) { calls++; }));
+
+    writeFile("/test.json", "{\"name\": \"test\"}");
+    TEST_ASSERT_EQUAL_UINT32(0, MCJsonConfig::ReadJsonArray("/test.json", "locos", [&](JsonObject) { calls++; }));
+
+    TEST_ASSERT_EQUAL_UINT32(0, calls);
+}
+
+void test_only_matches_top_level_key()
+{
+    // The key also appears in a comment, in string values and as the key of a nested object, before the actual array.
+    writeFile("/test.json",
+              "{\n"
+              "  // \"locos\": [{\"address\": 91}]\n"
+              "  /* \"locos\": [{\"address\": 92}] */\n"
+              "  \"name\": \"locos\",\n"
+              "  \"description\": \"see \\\"locos\\\": [{\\\"address\\\": 93}]\",\n"
+              "  \"espPins\": [{\"pin\": 1, \"locos\": [{\"address\": 94}]}],\n"
+              "  \"locosExtra\": [{\"address\": 95}],\n"
+              "  \"locos\" /* the real one */ : [{\"address\": 1}, /* a comment */ {\"address\": 2}]\n"
+              "}");
+
+    std::vector<int> addresses;
+    uint count = MCJsonConfig::ReadJsonArray("/test.json", "locos", [&](JsonObject locoConfig) {
+        addresses.push_back(locoConfig["address"]);
+    });
+
+    TEST_ASSERT_EQUAL_UINT32(2, count);
+    TEST_ASSERT_EQUAL_INT(1, addresses[0]);
+    TEST_ASSERT_EQUAL_INT(2, addresses[1]);
+}
+
+void test_benchmark_streaming_vs_whole_file()
+{
+    LoadResult singleLocoStreamed;
+
+    for (int locoCount : {1, 10, 50}) {
+        size_t jsonSize = writeControllerConfig("/test.json", locoCount);
+
+        LoadResult wholeFile = benchmarkLoader("/test.json", locoCount, loadWholeFile);
+        LoadResult streamed = benchmarkLoader("/test.json", locoCount, loadStreamed);
+
+        char message[256];
+        snprintf(message, sizeof(message), "%d locos, %u bytes of JSON: whole file %.0f us, peak heap %ld bytes (%ld for JSON); streamed %.0f us, peak heap %ld bytes (%ld for JSON).",
+                 locoCount, (uint)jsonSize, wholeFile.TimeInUs, wholeFile.PeakHeap, wholeFile.DocumentHeap, streamed.TimeInUs, streamed.PeakHeap, streamed.DocumentHeap);
+        TEST_MESSAGE(message);
+
+        if (locoCount == 1) {
+            singleLocoStreamed = streamed;
+        } else {
+            // Reading the whole file needs more heap, and the heap needed for JSON no longer grows with the number of locos when streaming.
+            TEST_ASSERT_TRUE(streamed.PeakHeap < wholeFile.PeakHeap);
+            TEST_ASSERT_TRUE(streamed.DocumentHeap <= 2 * singleLocoStreamed.DocumentHeap);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    char folder[] = "/tmp/config-compiler-test-XXXXXX";
+    dataFolder = mkdtemp(folder);
+    SPIFFS.SetRoot(dataFolder);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_reads_all_elements);
+    RUN_TEST(test_reads_empty_and_missing_array);
+    RUN_TEST(test_only_matches_top_level_key);
+    RUN_TEST(test_benchmark_streaming_vs_whole_file);
+    int failures = UNITY_END();
+
+    SPIFFS.remove("/test.json");
+    rmdir(dataFolder.c_str());
+    return failures;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+// Host stand-ins for the parts of the Arduino API used by the tested controller code.
+// The clock doesn't run by itself: tests advance it, so they can step the code with a fixed time step.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <sys/types.h>
+#include <type_traits>
+
+typedef unsigned long ulong;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Current time of the host clock (in microseconds). Starts at 1, as the controller code treats 0 as "never updated".
+inline unsigned long hostMicros = 1;
+
+inline unsigned long micros()
+{
+    return hostMicros;
+}
+
+inline unsigned long millis()
+{
+    return hostMicros / 1000;
+}
+
+// Advances the host clock.
+inline void advanceMillis(unsigned long ms)
+{
+    hostMicros += ms * 1000;
+}
+
+#define HIGH 1
+#define LOW 0
+#define OUTPUT 3
+
+// Number of LEDC (PWM) channels of the ESP32.
+#define HOST_LEDC_CHANNEL_COUNT 16
+
+// Last duty written to each LEDC channel, so tests can check what the controller outputs on its pins.
+inline uint32_t hostLedcDuty[HOST_LEDC_CHANNEL_COUNT];
+
+inline void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t val)
+{
+}
+
+inline double ledcSetup(uint8_t channel, double freq, uint8_t resolution_bits)
+{
+    return freq;
+}
+
+inline void ledcAttachPin(uint8_t pin, uint8_t channel)
+{
+}
+
+inline void ledcWrite(uint8_t channel, uint32_t duty)
+{
+    hostLedcDuty[channel] = duty;
+}
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// FreeRTOS stand-ins. The tests run on a single thread: tasks aren't started (tests call the task's work directly) and locks are no-ops.
+typedef void *SemaphoreHandle_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define portMAX_DELAY 0xffffffffUL
+#define pdTRUE 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    return nullptr;
+}
+
+inline int xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait)
+{
+    return pdTRUE;
+}
+
+inline int xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    return pdTRUE;
+}
+
+inline int xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stackDepth, void *parameters, uint32_t priority, void *createdTask, int coreId)
+{
+    return pdTRUE;
+}
+
+inline TickType_t xTaskGetTickCount()
+{
+    return millis();
+}
+
+inline void vTaskDelayUntil(TickType_t *previousWakeTime, TickType_t timeIncrement)
+{
+    *previousWakeTime += timeIncrement;
+}
+
+template <typename A, typename B>
+typename std::common_type<A, B>::type min(A a, B b)
+{
+    return a < b ? a : b;
+}
+
+template <typename A, typename B>
+typename std::common_type<A, B>::type max(A a, B b)
+{
+    return a > b ? a : b;
+}
\ No newline at end of file
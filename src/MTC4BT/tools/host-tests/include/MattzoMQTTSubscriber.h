@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+// Host stand-in for the controller's MQTT subscriber. Tests set the MQTT status, and can check how often the controller queried it.
+
+#define MQTT_UNINITIALIZED -10
+#define MQTT_CONNECTED 0
+
+class MattzoMQTTSubscriber
+{
+  public:
+    // MQTT status returned by GetStatus.
+    static inline volatile int HostStatus = MQTT_UNINITIALIZED;
+
+    // Number of times GetStatus was called.
+    static inline uint32_t HostStatusQueryCount = 0;
+
+    // Returns the current MQTT connection status. Not inlined, as the controller queries the MQTT client through a call as well.
+    static __attribute__((noinline)) int GetStatus()
+    {
+        HostStatusQueryCount++;
+        return HostStatus;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+// Host stand-in for the controller's WiFi client. Tests set the WiFi status, and can check how often the controller queried it.
+
+#define WL_UNINITIALIZED -2
+#define WL_INITIALIZING -1
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+
+class MattzoWifiClient
+{
+  public:
+    // WiFi status returned by GetStatus.
+    static inline volatile int HostStatus = WL_UNINITIALIZED;
+
+    // Number of times GetStatus was called.
+    static inline uint32_t HostStatusQueryCount = 0;
+
+    // Returns the current WiFi connection status. Not inlined, as the controller queries the WiFi driver through a call as well.
+    static __attribute__((noinline)) int GetStatus()
+    {
+        HostStatusQueryCount++;
+        return HostStatus;
+    }
+};
\ No newline at end of file
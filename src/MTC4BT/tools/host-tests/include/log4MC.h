@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstdarg>
+#include <cstdio>
+#include <syslog.h>
+
+// Host stand-in for the controller's logger. Writes warnings and errors to stderr, and drops info and debug messages so they don't clutter the test output.
+class log4MC
+{
+  public:
+    static void vlogf(uint8_t level, const char *fmt, ...)
+    {
+        if (level > LOG_WARNING) {
+            return;
+        }
+
+        va_list args;
+        va_start(args, fmt);
+        vfprintf(stderr, fmt, args);
+        va_end(args);
+        fputc('\n', stderr);
+    }
+
+    static void log(uint8_t level, const char *message)
+    {
+        if (level <= LOG_WARNING) {
+            fprintf(stderr, "%s\n", message);
+        }
+    }
+
+    static void debug(const char *message)
+    {
+        log(LOG_DEBUG, message);
+    }
+
+    static void info(const char *message)
+    {
+        log(LOG_INFO, message);
+    }
+
+    static void warn(const char *message)
+    {
+        log(LOG_WARNING, message);
+    }
+
+    static void error(const char *message)
+    {
+        log(LOG_ERR, message);
+    }
+
+    static void fatal(const char *message)
+    {
+        log(LOG_CRIT, message);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,168 @@
+// Steps the channel controller with a fixed time step and checks its pwr ramps against the configured rates and jerk.
+
+#include <unity.h>
+
+#include "../../../../../lib/MController/MCChannelConfig.cpp"
+#include "../../../../../lib/MController/MCChannelController.cpp"
+#include "../../../../../lib/MController/MCLightController.cpp"
+
+#define STEP_IN_MS 10
+#define STEP_IN_SECONDS (STEP_IN_MS / 1000.0f)
+
+// Allowed float error on the rate (in %/s) per step.
+#define RATE_TOLERANCE 0.01f
+
+#define PWR_INC_RATE 50
+#define PWR_DEC_RATE 80
+#define PWR_JERK 100
+
+// Highest rate (in %/s) and change of rate (in %/s per step) seen while stepping.
+float maxAbsRate;
+float maxRateChange;
+
+// Returns a controller of a motor channel, released from the manual brake and updated once, so the next update has a time step.
+MCChannelController *createController(int pwrJerk)
+{
+    MCChannelConfig *config = new MCChannelConfig(nullptr, PWR_INC_RATE, PWR_DEC_RATE, pwrJerk, nullptr, false, DeviceType::Motor);
+    MCChannelController *controller = new MCChannelController(config);
+    controller->ManualBrake(false);
+    controller->UpdateCurrentPwrPerc();
+    return controller;
+}
+
+// Steps the controller until it no longer changes its pwr (or for the max. number of steps), checking the pwr change of every step against the rates. Returns the number of steps that changed the pwr.
+int step(MCChannelController *controller, int maxSteps)
+{
+    for (int steps = 0; steps < maxSteps; steps++) {
+        float previousRate = controller->GetCurrentRate();
+        int16_t previousPwr = controller->GetCurrentPwrPerc();
+
+        advanceMillis(STEP_IN_MS);
+        if (!controller->UpdateCurrentPwrPerc()) {
+            return steps;
+        }
+
+        float rate = controller->GetCurrentRate();
+        maxAbsRate = max(maxAbsRate, fabsf(rate));
+        maxRateChange = max(maxRateChange, fabsf(rate - previousRate));
+
+        // The rounded pwr never changes by more than the max. rate allows (plus rounding).
+        TEST_ASSERT_INT_WITHIN(PWR_DEC_RATE * STEP_IN_SECONDS + 1, previousPwr, controller->GetCurrentPwrPerc());
+    }
+
+    return maxSteps;
+}
+
+void setUp()
+{
+    maxAbsRate = 0;
+    maxRateChange = 0;
+}
+
+void tearDown()
+{
+}
+
+void test_linear_ramp_takes_rate_time()
+{
+    MCChannelController *controller = createController(0);
+
+    controller->SetTargetPwrPerc(100);
+    int steps = step(controller, 1000);
+
+    // 100% at 50%/s takes 2 seconds.
+    TEST_ASSERT_EQUAL_INT16(100, controller->GetCurrentPwrPerc());
+    TEST_ASSERT_INT_WITHIN(1, 2000 / STEP_IN_MS, steps);
+
+    // Decelerating to 20% at 80%/s takes 1 second.
+    controller->SetTargetPwrPerc(20);
+    steps = step(controller, 1000);
+
+    TEST_ASSERT_EQUAL_INT16(20, controller->GetCurrentPwrPerc());
+    TEST_ASSERT_INT_WITHIN(1, 1000 / STEP_IN_MS, steps);
+}
+
+void test_s_curve_keeps_rate_and_jerk_limits()
+{
+    MCChannelController *controller = createController(PWR_JERK);
+
+    controller->SetTargetPwrPerc(100);
+    step(controller, 1000);
+
+    TEST_ASSERT_EQUAL_INT16(100, controller->GetCurrentPwrPerc());
+    TEST_ASSERT_FLOAT_WITHIN(RATE_TOLERANCE, PWR_INC_RATE, maxAbsRate);
+    TEST_ASSERT_TRUE(maxRateChange <= PWR_JERK * STEP_IN_SECONDS + RATE_TOLERANCE);
+
+    // Arrived with a rate of zero.
+    TEST_ASSERT_EQUAL_FLOAT(0, controller->GetCurrentRate());
+}
+
+void test_s_curve_is_slower_than_linear_ramp()
+{
+    MCChannelController *controller = createController(PWR_JERK);
+
+    controller->SetTargetPwrPerc(100);
+    int steps = step(controller, 1000);
+
+    // 2 seconds at the max. rate, plus the time to ramp the rate up to it (and down again): 50%/s / 100%/s² = 0.5 second.
+    TEST_ASSERT_INT_WITHIN(2, 2500 / STEP_IN_MS, steps);
+}
+
+void test_s_curve_direction_change_keeps_jerk_limit()
+{
+    MCChannelController *controller = createController(PWR_JERK);
+
+    // Reverse half way the ramp, while the rate is high.
+    controller->SetTargetPwrPerc(60);
+    step(controller, 100);
+    TEST_ASSERT_TRUE(controller->GetCurrentRate() > 0);
+
+    controller->SetTargetPwrPerc(-60);
+    step(controller, 1000);
+
+    TEST_ASSERT_EQUAL_INT16(-60, controller->GetCurrentPwrPerc());
+    TEST_ASSERT_TRUE(maxAbsRate <= PWR_DEC_RATE + RATE_TOLERANCE);
+    TEST_ASSERT_TRUE(maxRateChange <= PWR_JERK * STEP_IN_SECONDS + RATE_TOLERANCE);
+}
+
+void test_s_curve_lower_target_keeps_jerk_limit()
+{
+    MCChannelController *controller = createController(PWR_JERK);
+
+    // Lower the target while accelerating towards it: the controller overshoots a little rather than breaking the jerk limit, and settles at the new target.
+    controller->SetTargetPwrPerc(100);
+    step(controller, 100);
+
+    controller->SetTargetPwrPerc(40);
+    step(controller, 1000);
+
+    TEST_ASSERT_EQUAL_INT16(40, controller->GetCurrentPwrPerc());
+    TEST_ASSERT_TRUE(maxRateChange <= PWR_JERK * STEP_IN_SECONDS + RATE_TOLERANCE);
+}
+
+void test_brake_stops_immediately()
+{
+    MCChannelController *controller = createController(PWR_JERK);
+
+    controller->SetTargetPwrPerc(100);
+    step(controller, 1000);
+
+    controller->EmergencyBrake(true);
+    advanceMillis(STEP_IN_MS);
+    controller->UpdateCurrentPwrPerc();
+
+    TEST_ASSERT_EQUAL_INT16(0, controller->GetCurrentPwrPerc());
+    TEST_ASSERT_EQUAL_FLOAT(0, controller->GetCurrentRate());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_linear_ramp_takes_rate_time);
+    RUN_TEST(test_s_curve_keeps_rate_and_jerk_limits);
+    RUN_TEST(test_s_curve_is_slower_than_linear_ramp);
+    RUN_TEST(test_s_curve_direction_change_keeps_jerk_limit);
+    RUN_TEST(test_s_curve_lower_target_keeps_jerk_limit);
+    RUN_TEST(test_brake_stops_immediately);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,275 @@
+// Tests and benchmarks the controller loop (MController::Loop) of a controller with several lights and status lights on its ESP pins, sampling the connection status once per iteration and using the leds bound at setup, against querying the connection status and looking up the led for every channel the way MController::Loop did before.
+
+#include <chrono>
+#include <cstring>
+#include <unity.h>
+#include <vector>
+
+#include "../../../../../lib/MController/MCChannel.cpp"
+#include "../../../../../lib/MController/MCChannelConfig.cpp"
+#include "../../../../../lib/MController/MCChannelController.cpp"
+#include "../../../../../lib/MController/MCLed.cpp"
+#include "../../../../../lib/MController/MCLedBase.cpp"
+#include "../../../../../lib/MController/MCLightController.cpp"
+#include "../../../../../lib/MController/MCLocoAction.cpp"
+#include "../../../../../lib/MController/MCPinController.cpp"
+#include "../../../../../lib/MController/MCStatusLed.cpp"
+#include "../../../../../lib/MController/MCTimerWheel.cpp"
+#include "../../../../../lib/MController/MController.cpp"
+
+#define LIGHT_COUNT 8
+#define STATUS_LIGHT_COUNT 4
+#define BENCHMARK_ITERATIONS 200000
+
+// Controller under test (the MTC4BT specifics aren't needed to run the loop).
+class TestController : public MController
+{
+  public:
+    void HandleSys(const bool ebrake) override {}
+    void HandleTrigger(int locoAddress, MCTriggerSource source, const char *eventType, const char *eventId, const char *value) override {}
+};
+
+// The removed controller loop state: its channel controllers and leds, and the e-brake flag.
+struct PerChannelController {
+    std::vector<MCChannelController *> Channels;
+    std::vector<MCLedBase *> Leds;
+    bool Ebrake;
+};
+
+// Returns the led for the given pin (the removed per-iteration MController::findLedByPinNumber).
+MCLedBase *findLedByPinNumber(PerChannelController &controller, int pin)
+{
+    for (MCLedBase *led : controller.Leds) {
+        if (led->GetPin() == pin) {
+            return led;
+        }
+    }
+
+    return nullptr;
+}
+
+// Returns whether the e-brake is enabled, querying the connection status (the removed MController::GetEmergencyBrake).
+bool getEmergencyBrake(PerChannelController &controller)
+{
+    return controller.Ebrake || MController::GetConnectionStatus() != MCConnectionStatus::connected;
+}
+
+// Runs one iteration of the removed MController::Loop.
+void loopPerChannel(PerChannelController &controller)
+{
+    int currentPwrPerc;
+
+    for (MCChannelController *channel : controller.Channels) {
+        // Update channel e-brake status.
+        channel->EmergencyBrake(getEmergencyBrake(controller));
+
+        // Update current channel pwr (continue if request was ignored).
+        if (!channel->UpdateCurrentPwrPerc()) {
+            continue;
+        }
+
+        // Get new pwr perc.
+        currentPwrPerc = channel->GetCurrentPwrPerc();
+
+        if (channel->GetAttachedDevice() == DeviceType::Light) {
+            MCLedBase *led = findLedByPinNumber(controller, channel->GetChannel()->GetAddressAsEspPinNumber());
+            if (led) {
+                led->SetCurrentPwrPerc(currentPwrPerc);
+            }
+        }
+
+        if (channel->GetAttachedDevice() == DeviceType::StatusLight) {
+            MCLedBase *led = findLedByPinNumber(controller, channel->GetChannel()->GetAddressAsEspPinNumber());
+            if (led) {
+                switch (MController::GetConnectionStatus()) {
+                case uninitialized:
+                case initializing: {
+                    // Two flashes per second.
+                    currentPwrPerc = MCLightController::TwoFlashesPerSecond() ? 100 : 0;
+                    break;
+                }
+                case MCConnectionStatus::connecting_wifi: {
+                    // One short flash per second (on 10%).
+                    currentPwrPerc = MCLightController::OneFlashPerSecond() ? 100 : 0;
+                    break;
+                }
+                case MCConnectionStatus::connecting_mqtt: {
+                    // Blink (on 50%).
+                    currentPwrPerc = MCLightController::Blink() ? 100 : 0;
+                    break;
+                }
+                case connected: {
+                    // Off.
+                    currentPwrPerc = 0;
+                    break;
+                }
+                };
+
+                led->SetCurrentPwrPerc(currentPwrPerc);
+            }
+        }
+    }
+}
+
+// Returns the config of a controller with lights and status lights on its ESP pins.
+MCConfiguration *createConfig()
+{
+    MCConfiguration *config = new MCConfiguration();
+    config->ControllerName = "host";
+
+    for (int i = 0; i < LIGHT_COUNT + STATUS_LIGHT_COUNT; i++) {
+        MCChannel *channel = new MCChannel(ChannelType::EspPinChannel, std::to_string(12 + i));
+        DeviceType deviceType = i < LIGHT_COUNT ? DeviceType::Light : DeviceType::StatusLight;
+        config->EspPins.push_back(new MCChannelConfig(channel, 50, 80, 0, nullptr, false, deviceType));
+    }
+
+    return config;
+}
+
+// Returns the removed controller loop state for the given config (the removed MController::initChannelControllers).
+PerChannelController createPerChannelController(MCConfiguration *config)
+{
+    PerChannelController controller;
+    controller.Ebrake = false;
+
+    for (int i = 0; i < config->EspPins.size(); i++) {
+        MCChannelConfig *espPinConfig = config->EspPins.at(i);
+        if (espPinConfig->GetAttachedDeviceType() == DeviceType::Light) {
+            controller.Leds.push_back(new MCLed(i, espPinConfig->GetChannel()->GetAddressAsEspPinNumber(), espPinConfig->IsInverted()));
+        }
+
+        if (espPinConfig->GetAttachedDeviceType() == DeviceType::StatusLight) {
+            controller.Leds.push_back(new MCStatusLed(i, espPinConfig->GetChannel()->GetAddressAsEspPinNumber(), false));
+        }
+
+        controller.Channels.push_back(new MCChannelController(espPinConfig));
+    }
+
+    return controller;
+}
+
+// Sets the connection status reported by the WiFi client and MQTT subscriber stand-ins.
+void setConnectionStatus(MCConnectionStatus status)
+{
+    switch (status) {
+    case MCConnectionStatus::uninitialized:
+        MattzoWifiClient::HostStatus = WL_UNINITIALIZED;
+        break;
+    case MCConnectionStatus::initializing:
+        MattzoWifiClient::HostStatus = WL_INITIALIZING;
+        break;
+    case MCConnectionStatus::connecting_wifi:
+        MattzoWifiClient::HostStatus = WL_DISCONNECTED;
+        break;
+    default:
+        MattzoWifiClient::HostStatus = WL_CONNECTED;
+        break;
+    }
+
+    MattzoMQTTSubscriber::HostStatus = status == MCConnectionStatus::connected ? MQTT_CONNECTED : MQTT_UNINITIALIZED;
+}
+
+// Returns the number of WiFi and MQTT status queries made since the last call.
+uint32_t takeStatusQueryCount()
+{
+    uint32_t count = MattzoWifiClient::HostStatusQueryCount + MattzoMQTTSubscriber::HostStatusQueryCount;
+    MattzoWifiClient::HostStatusQueryCount = 0;
+    MattzoMQTTSubscriber::HostStatusQueryCount = 0;
+    return count;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_loop_drives_same_leds()
+{
+    MCConfiguration *config = createConfig();
+    PerChannelController perChannelController = createPerChannelController(config);
+    TestController controller;
+    controller.Setup(config);
+
+    for (MCConnectionStatus status : {MCConnectionStatus::uninitialized, MCConnectionStatus::initializing, MCConnectionStatus::connecting_wifi, MCConnectionStatus::connecting_mqtt, MCConnectionStatus::connected}) {
+        setConnectionStatus(status);
+
+        // Run both loops for two seconds, so every status light pattern goes through its on and off phases.
+        for (int ms = 0; ms < 2000; ms++) {
+            advanceMillis(1);
+
+            loopPerChannel(perChannelController);
+            uint32_t expectedDuty[HOST_LEDC_CHANNEL_COUNT];
+            memcpy(expectedDuty, hostLedcDuty, sizeof(expectedDuty));
+
+            controller.Loop();
+            TEST_ASSERT_EQUAL_UINT32_ARRAY(expectedDuty, hostLedcDuty, LIGHT_COUNT + STATUS_LIGHT_COUNT);
+        }
+
+        TEST_ASSERT_EQUAL(getEmergencyBrake(perChannelController), controller.GetEmergencyBrake());
+    }
+}
+
+void test_loop_samples_connection_status_once()
+{
+    MCConfiguration *config = createConfig();
+    PerChannelController perChannelController = createPerChannelController(config);
+    TestController controller;
+    controller.Setup(config);
+
+    setConnectionStatus(MCConnectionStatus::connected);
+    takeStatusQueryCount();
+    MController::GetConnectionStatus();
+    uint32_t queriesPerSample = takeStatusQueryCount();
+
+    // The removed loop sampled the status for the e-brake of every channel, and again for every status light.
+    loopPerChannel(perChannelController);
+    TEST_ASSERT_EQUAL_UINT32((LIGHT_COUNT + 2 * STATUS_LIGHT_COUNT) * queriesPerSample, takeStatusQueryCount());
+
+    controller.Loop();
+    TEST_ASSERT_EQUAL_UINT32(queriesPerSample, takeStatusQueryCount());
+}
+
+void test_benchmark_snapshot_vs_per_channel_status()
+{
+    MCConfiguration *config = createConfig();
+    PerChannelController perChannelController = createPerChannelController(config);
+    TestController controller;
+    controller.Setup(config);
+
+    // Connected is the state the controller spends its time in (both WiFi and MQTT are queried).
+    setConnectionStatus(MCConnectionStatus::connected);
+
+    auto perChannelStartedAt = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        advanceMillis(1);
+        loopPerChannel(perChannelController);
+    }
+    double perChannelSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - perChannelStartedAt).count();
+
+    auto snapshotStartedAt = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        advanceMillis(1);
+        controller.Loop();
+    }
+    double snapshotSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - snapshotStartedAt).count();
+
+    char result[200];
+    snprintf(result, sizeof(result), "Controller loop with %d lights and %d status lights: per-channel status and led lookup %.0f iterations/s, sampled status and bound leds %.0f iterations/s.",
+             LIGHT_COUNT, STATUS_LIGHT_COUNT, BENCHMARK_ITERATIONS / perChannelSeconds, BENCHMARK_ITERATIONS / snapshotSeconds);
+    TEST_MESSAGE(result);
+
+    TEST_ASSERT_EQUAL_UINT32(BENCHMARK_ITERATIONS, controller.GetLoopCount());
+    TEST_ASSERT_TRUE(snapshotSeconds < perChannelSeconds);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_loop_drives_same_leds);
+    RUN_TEST(test_loop_samples_connection_status_once);
+    RUN_TEST(test_benchmark_snapshot_vs_per_channel_status);
+    return UNITY_END();
+}
\ No newline at end of file
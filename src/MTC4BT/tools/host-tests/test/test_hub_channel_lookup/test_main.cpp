@@ -0,0 +1,186 @@
+// Benchmarks a drive loop pass of a hub, resolving its channels through the enum values resolved when loading the config, against building the string map of hub channels on every lookup the way BLEHub::Execute and BLEHubChannelController::GetHubChannel did before.
+
+#include <chrono>
+#include <map>
+#include <unity.h>
+#include <vector>
+
+#include "../../../../../lib/MController/MCChannel.cpp"
+#include "../../../../../lib/MController/MCChannelConfig.cpp"
+#include "../../../../../lib/MController/MCChannelController.cpp"
+#include "../../../../../lib/MController/MCLightController.cpp"
+#include "../../../../../lib/MController/MCSpeedController.cpp"
+#include "../../../../../lib/MController/MCSpeedCurve.cpp"
+#include "../../../../src/BLEHubChannelController.cpp"
+
+#define BENCHMARK_ITERATIONS 100000
+
+// The removed string switch of hub channels, built by every lookup.
+struct bleHubChannelMap : public std::map<std::string, BLEHubChannel> {
+    bleHubChannelMap()
+    {
+        this->operator[]("A") = BLEHubChannel::A;
+        this->operator[]("a") = BLEHubChannel::A;
+        this->operator[]("B") = BLEHubChannel::B;
+        this->operator[]("b") = BLEHubChannel::B;
+        this->operator[]("C") = BLEHubChannel::C;
+        this->operator[]("c") = BLEHubChannel::C;
+        this->operator[]("D") = BLEHubChannel::D;
+        this->operator[]("d") = BLEHubChannel::D;
+        this->operator[]("LED") = BLEHubChannel::OnboardLED;
+        this->operator[]("Led") = BLEHubChannel::OnboardLED;
+        this->operator[]("led") = BLEHubChannel::OnboardLED;
+    };
+    ~bleHubChannelMap() {}
+};
+
+// Channel controller of a hub, with its config (which the controller keeps to itself).
+struct TestChannel {
+    MCChannelConfig *Config;
+    BLEHubChannelController *Controller;
+};
+
+// Returns the hub channel of the given channel, resolved when loading the config (BLEHubChannelController::GetHubChannel).
+BLEHubChannel getResolvedHubChannel(TestChannel &channel)
+{
+    return channel.Controller->GetHubChannel();
+}
+
+// Returns the hub channel of the given channel, looked up by the channel's address in a new string map (the removed BLEHubChannelController::GetHubChannel).
+BLEHubChannel getMappedHubChannel(TestChannel &channel)
+{
+    return bleHubChannelMap()[channel.Config->GetChannel()->GetAddress()];
+}
+
+// Returns the channel with the given hub channel, using the given function to get the hub channel of a channel (BLEHub::findControllerByChannel).
+template <typename GetHubChannel>
+TestChannel *findChannel(std::vector<TestChannel> &channels, BLEHubChannel hubChannel, GetHubChannel getHubChannel)
+{
+    for (TestChannel &channel : channels) {
+        if (getHubChannel(channel) == hubChannel) {
+            return &channel;
+        }
+    }
+
+    return nullptr;
+}
+
+// Runs one pass of the PU hub drive loop (PUHub::DriveTaskLoop, minus the BLE writes), using the given function to get the hub channel of a channel. Returns a checksum of the drive commands.
+template <typename GetHubChannel>
+uint32_t drivePass(std::vector<TestChannel> &channels, GetHubChannel getHubChannel)
+{
+    uint32_t checksum = 0;
+
+    for (TestChannel &channel : channels) {
+        if (getHubChannel(channel) == BLEHubChannel::OnboardLED) {
+            checksum += channel.Controller->GetHubLedColor();
+        } else {
+            channel.Controller->UpdateCurrentPwrPerc();
+            channel.Controller->UpdateSpeedControl();
+
+            uint8_t setMotorCommand[6] = {0x81, (uint8_t)getHubChannel(channel), 0x11, 0x51, 0x00, channel.Controller->GetRawCurrentPwr()};
+            checksum += setMotorCommand[1] * 256 + setMotorCommand[5];
+        }
+    }
+
+    return checksum;
+}
+
+// Executes an action on the given channel address, the way BLEHub::Execute resolves it now (by the resolved address) or did before (through a new string map).
+void execute(std::vector<TestChannel> &channels, MCChannel *actionChannel, int16_t targetPwrPerc, bool resolved)
+{
+    TestChannel *channel = resolved ? findChannel(channels, (BLEHubChannel)actionChannel->GetResolvedAddress(), getResolvedHubChannel)
+                                    : findChannel(channels, bleHubChannelMap()[actionChannel->GetAddress()], getMappedHubChannel);
+
+    if (channel) {
+        channel->Controller->SetTargetPwrPerc(targetPwrPerc);
+    }
+}
+
+// Returns the channels of a PU hub with two motors, a light and the onboard LED, resolving their addresses the way BLELocomotiveDeserializer does.
+std::vector<TestChannel> createChannels()
+{
+    std::vector<TestChannel> channels;
+
+    struct {
+        const char *Address;
+        DeviceType Device;
+    } channelConfigs[] = {{"A", DeviceType::Motor}, {"b", DeviceType::Motor}, {"C", DeviceType::Light}, {"led", DeviceType::Light}};
+
+    for (auto &channelConfig : channelConfigs) {
+        MCChannel *channel = new MCChannel(ChannelType::BleHubChannel, channelConfig.Address);
+        channel->SetResolvedAddress(parseBleHubChannel(channelConfig.Address));
+
+        MCChannelConfig *config = new MCChannelConfig(channel, 50, 80, 0, nullptr, false, channelConfig.Device);
+        BLEHubChannelController *controller = new BLEHubChannelController(config);
+        controller->CompileRawPwrTables([](int32_t pwr) { return (int16_t)(pwr >> SPEED_CURVE_FIXED_POINT_BITS); });
+        controller->ManualBrake(false);
+        channels.push_back({config, controller});
+    }
+
+    return channels;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_resolved_channels_match_mapped_channels()
+{
+    std::vector<TestChannel> channels = createChannels();
+
+    for (TestChannel &channel : channels) {
+        TEST_ASSERT_EQUAL(getMappedHubChannel(channel), getResolvedHubChannel(channel));
+    }
+
+    // Unknown channel names still fall back to channel A, as the map did.
+    TEST_ASSERT_EQUAL(bleHubChannelMap()["E"], parseBleHubChannel("E"));
+}
+
+void test_benchmark_resolved_vs_mapped_channels()
+{
+    // Every benchmark drives its own hub from the same state.
+    std::vector<TestChannel> mappedChannels = createChannels();
+    std::vector<TestChannel> resolvedChannels = createChannels();
+
+    MCChannel actionChannel(ChannelType::BleHubChannel, "C");
+    actionChannel.SetResolvedAddress(parseBleHubChannel("C"));
+
+    uint32_t mappedChecksum = 0;
+    auto mappedStartedAt = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        advanceMillis(10);
+        execute(mappedChannels, &actionChannel, i % 100, false);
+        mappedChecksum += drivePass(mappedChannels, getMappedHubChannel);
+    }
+    double mappedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - mappedStartedAt).count() / BENCHMARK_ITERATIONS;
+
+    uint32_t resolvedChecksum = 0;
+    auto resolvedStartedAt = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        advanceMillis(10);
+        execute(resolvedChannels, &actionChannel, i % 100, true);
+        resolvedChecksum += drivePass(resolvedChannels, getResolvedHubChannel);
+    }
+    double resolvedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - resolvedStartedAt).count() / BENCHMARK_ITERATIONS;
+
+    char result[160];
+    snprintf(result, sizeof(result), "Drive loop pass of %u channels (plus an action): string map %.0f ns, resolved channels %.0f ns.", (uint)resolvedChannels.size(), mappedNs, resolvedNs);
+    TEST_MESSAGE(result);
+
+    // Both passes drove the channels the same way.
+    TEST_ASSERT_EQUAL_UINT32(mappedChecksum, resolvedChecksum);
+    TEST_ASSERT_TRUE(resolvedNs < mappedNs);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_resolved_channels_match_mapped_channels);
+    RUN_TEST(test_benchmark_resolved_vs_mapped_channels);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,179 @@
+// Runs the speed controller closed-loop against a first-order model of a motor with encoder, using the gains of the example config.
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "../../../../../lib/MController/MCSpeedController.cpp"
+
+// Gains of the example config (kp 0.8, ki 2.0, in 1/256).
+#define KP 205
+#define KI 512
+
+// The hub's drive task updates the speed controller every 250 ms.
+#define UPDATE_INTERVAL_IN_MS 250
+
+// Time constant (in ms) of the motor and train, and the speed (in %) it reaches per % pwr, minus the speed it loses to friction.
+#define MOTOR_TIME_CONSTANT_IN_MS 400
+#define MOTOR_GAIN 0.8f
+#define MOTOR_FRICTION_PERC 5.0f
+
+// First-order motor model: the speed moves towards the speed the pwr can sustain with the given time constant.
+struct Motor {
+    float speedPerc = 0;
+
+    // Speed (in %) lost to the grade (positive uphill).
+    float gradePerc = 0;
+
+    // When stalled, the motor doesn't turn whatever the pwr.
+    bool stalled = false;
+
+    void run(int16_t pwrPerc, uint32_t durationInMs)
+    {
+        for (uint32_t ms = 0; ms < durationInMs; ms++) {
+            float drive = max(MOTOR_GAIN * abs(pwrPerc) - MOTOR_FRICTION_PERC, 0.0f);
+            float sustainedSpeed = (pwrPerc >= 0 ? drive : -drive) - gradePerc;
+            speedPerc += (sustainedSpeed - speedPerc) / MOTOR_TIME_CONSTANT_IN_MS;
+        }
+
+        if (stalled) {
+            speedPerc = 0;
+        }
+    }
+
+    // The encoder reports its speed in whole percentages.
+    int16_t measure()
+    {
+        return lroundf(speedPerc);
+    }
+};
+
+Motor motor;
+MCSpeedController *controller;
+
+// Lowest and highest output and speed seen while running.
+int16_t minOutput;
+int16_t maxOutput;
+float maxSpeed;
+
+// Runs the control loop for the given time, the way the hub's drive task does.
+void run(int16_t targetSpeedPerc, uint32_t durationInMs)
+{
+    for (uint32_t ms = 0; ms < durationInMs; ms += UPDATE_INTERVAL_IN_MS) {
+        int16_t pwrPerc = controller->Update(targetSpeedPerc, motor.measure(), UPDATE_INTERVAL_IN_MS);
+        minOutput = min(minOutput, pwrPerc);
+        maxOutput = max(maxOutput, pwrPerc);
+
+        motor.run(pwrPerc, UPDATE_INTERVAL_IN_MS);
+        maxSpeed = max(maxSpeed, motor.speedPerc);
+    }
+}
+
+void resetExtremes()
+{
+    minOutput = INT16_MAX;
+    maxOutput = INT16_MIN;
+    maxSpeed = -100;
+}
+
+void setUp()
+{
+    motor = Motor();
+    controller = new MCSpeedController(MCSpeedControlConfig{KP, KI});
+    resetExtremes();
+}
+
+void tearDown()
+{
+    delete controller;
+}
+
+void test_settles_at_target_speed()
+{
+    // Open loop, 50% pwr only makes 35% speed.
+    run(50, 4000);
+    TEST_ASSERT_INT_WITHIN(2, 50, motor.measure());
+
+    run(50, 6000);
+
+    TEST_ASSERT_INT_WITHIN(1, 50, motor.measure());
+    TEST_ASSERT_INT_WITHIN(1, 0, controller->GetError());
+
+    // Settled: no more oscillation.
+    resetExtremes();
+    run(50, 5000);
+    TEST_ASSERT_INT_WITHIN(2, minOutput, maxOutput);
+}
+
+void test_overshoot_is_limited()
+{
+    run(50, 10000);
+
+    // Overshoots by no more than 10%.
+    TEST_ASSERT_TRUE(maxSpeed <= 55.5f);
+}
+
+void test_holds_speed_uphill()
+{
+    run(50, 10000);
+    motor.gradePerc = 10;
+    run(50, 10000);
+
+    TEST_ASSERT_INT_WITHIN(1, 50, motor.measure());
+}
+
+void test_no_windup_when_saturated()
+{
+    // The motor can't reach 90% speed (it makes 75% at full pwr), so the output saturates.
+    run(90, 20000);
+    TEST_ASSERT_EQUAL_INT16(100, controller->GetOutput());
+
+    // Slowing down starts at once: the integral didn't wind up while saturated.
+    int16_t speedBefore = motor.measure();
+    run(40, UPDATE_INTERVAL_IN_MS);
+    TEST_ASSERT_TRUE(controller->GetOutput() < 100);
+
+    run(40, 2000);
+    TEST_ASSERT_TRUE(motor.measure() < speedBefore);
+
+    resetExtremes();
+    run(40, 10000);
+    TEST_ASSERT_INT_WITHIN(1, 40, motor.measure());
+    TEST_ASSERT_TRUE(maxOutput < 100);
+}
+
+void test_no_windup_when_stalled()
+{
+    // A stalled motor saturates the output, but releasing it doesn't make the train shoot away.
+    motor.stalled = true;
+    run(30, 20000);
+    TEST_ASSERT_EQUAL_INT16(100, controller->GetOutput());
+
+    motor.stalled = false;
+    resetExtremes();
+    run(30, 15000);
+
+    TEST_ASSERT_TRUE(maxSpeed <= 60);
+    TEST_ASSERT_INT_WITHIN(1, 30, motor.measure());
+}
+
+void test_never_reverses_motor()
+{
+    // Rolling downhill faster than the target speed stops the motor at most.
+    motor.gradePerc = -60;
+    run(20, 10000);
+
+    TEST_ASSERT_EQUAL_INT16(0, minOutput);
+    TEST_ASSERT_TRUE(motor.measure() > 20);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_settles_at_target_speed);
+    RUN_TEST(test_overshoot_is_limited);
+    RUN_TEST(test_holds_speed_uphill);
+    RUN_TEST(test_no_windup_when_saturated);
+    RUN_TEST(test_no_windup_when_stalled);
+    RUN_TEST(test_never_reverses_motor);
+    return UNITY_END();
+}
\ No newline at end of file
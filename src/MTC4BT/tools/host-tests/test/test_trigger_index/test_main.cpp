@@ -0,0 +1,189 @@
+// Tests and benchmarks the loco trigger index (MCTriggerIndex) of a loco with 32 function mappings, against walking all events and matching every trigger the way BLELocomotive::TriggerEvent did before.
+
+#include <chrono>
+#include <unity.h>
+#include <vector>
+
+#include "../../../../../lib/MController/MCChannel.cpp"
+#include "../../../../../lib/MController/MCLocoAction.cpp"
+#include "../../../../../lib/MController/MCLocoEvent.cpp"
+#include "../../../../../lib/MController/MCLocoTrigger.cpp"
+#include "../../../../../lib/MController/MCTriggerIndex.cpp"
+
+#define FUNCTION_COUNT 32
+#define BENCHMARK_ITERATIONS 20000
+
+// Trigger details of an event the loco receives.
+struct TestEvent {
+    MCTriggerSource Source;
+    std::string EventType;
+    std::string EventId;
+    std::string Value;
+};
+
+std::vector<MCChannel *> channels;
+std::vector<MCLocoEvent *> events;
+
+// Events dispatched by the tests: every function switched on and off, direction changes, and a few events the loco doesn't map.
+std::vector<TestEvent> testEvents;
+
+// Returns whether the given trigger matches the given trigger details (the removed MCLocoTrigger::Matches, taking its strings by value).
+bool matches(MCLocoTrigger *trigger, MCTriggerSource source, std::string eventType, std::string eventId, std::string value)
+{
+    return trigger->GetSource() == source && trigger->GetEventType() == eventType && trigger->GetEventId() == eventId && trigger->GetValue() == value;
+}
+
+// Returns whether one of the triggers of the given event matches the given trigger details (the removed MCLocoEvent::HasTrigger).
+bool hasTrigger(MCLocoEvent *event, MCTriggerSource source, std::string eventType, std::string eventId, std::string value)
+{
+    for (MCLocoTrigger *trigger : event->GetTriggers()) {
+        if (matches(trigger, source, eventType, eventId, value)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Returns the actions triggered by the given trigger details, walking all events the way BLELocomotive::TriggerEvent did before the trigger index.
+std::vector<MCLocoAction *> findLinear(MCTriggerSource source, std::string eventType, std::string eventId, std::string value)
+{
+    std::vector<MCLocoAction *> triggeredActions;
+
+    for (MCLocoEvent *event : events) {
+        if (hasTrigger(event, source, eventType, eventId, value)) {
+            // MCLocoEvent::GetActions returned a copy of its actions.
+            std::vector<MCLocoAction *> actions = event->GetActions();
+            for (MCLocoAction *action : actions) {
+                triggeredActions.push_back(action);
+            }
+        }
+    }
+
+    return triggeredActions;
+}
+
+// Creates the events of a loco with two hubs (4 channels each), mapping every function to switching a channel on and off.
+void createEvents()
+{
+    for (int hub = 0; hub < 2; hub++) {
+        for (const char *address : {"A", "B", "C", "D"}) {
+            MCChannel *channel = new MCChannel(ChannelType::BleHubChannel, address);
+            channel->SetParentAddress(hub == 0 ? "90:84:2b:00:00:01" : "90:84:2b:00:00:02");
+            channels.push_back(channel);
+        }
+    }
+
+    for (int fn = 1; fn <= FUNCTION_COUNT; fn++) {
+        std::string fnId = "f" + std::to_string(fn);
+        MCChannel *channel = channels[fn % channels.size()];
+
+        events.push_back(new MCLocoEvent({new MCLocoTrigger(MCTriggerSource::RocRail, "fnchanged", fnId, "on")}, {new MCLocoAction(channel, 100, HubLedColor::NONE)}));
+        events.push_back(new MCLocoEvent({new MCLocoTrigger(MCTriggerSource::RocRail, "fnchanged", fnId, "off")}, {new MCLocoAction(channel, 0, HubLedColor::NONE)}));
+
+        testEvents.push_back({MCTriggerSource::RocRail, "fnchanged", fnId, "on"});
+        testEvents.push_back({MCTriggerSource::RocRail, "fnchanged", fnId, "off"});
+    }
+
+    // Head and tail lights switching with the direction, each lighting up two channels at once.
+    events.push_back(new MCLocoEvent({new MCLocoTrigger(MCTriggerSource::Loco, "dirchanged", "", "forward")},
+                                     {new MCLocoAction(channels[0], 100, HubLedColor::NONE), new MCLocoAction(channels[4], 0, HubLedColor::GREEN)}));
+    events.push_back(new MCLocoEvent({new MCLocoTrigger(MCTriggerSource::Loco, "dirchanged", "", "backward")},
+                                     {new MCLocoAction(channels[0], 0, HubLedColor::NONE), new MCLocoAction(channels[4], 100, HubLedColor::RED)}));
+
+    // A second event on the same trigger (its actions follow the ones of the first event), and an event with two triggers.
+    events.push_back(new MCLocoEvent({new MCLocoTrigger(MCTriggerSource::Loco, "dirchanged", "", "forward")}, {new MCLocoAction(channels[1], 50, HubLedColor::NONE)}));
+    events.push_back(new MCLocoEvent({new MCLocoTrigger(MCTriggerSource::Loco, "dirchanged", "", "stopped"), new MCLocoTrigger(MCTriggerSource::RocRail, "fnchanged", "f0", "off")},
+                                     {new MCLocoAction(channels[0], 0, HubLedColor::NONE), new MCLocoAction(channels[4], 0, HubLedColor::BLACK)}));
+
+    testEvents.push_back({MCTriggerSource::Loco, "dirchanged", "", "forward"});
+    testEvents.push_back({MCTriggerSource::Loco, "dirchanged", "", "backward"});
+    testEvents.push_back({MCTriggerSource::Loco, "dirchanged", "", "stopped"});
+    testEvents.push_back({MCTriggerSource::RocRail, "fnchanged", "f0", "off"});
+
+    // Events the loco doesn't map: an unknown function, a known function from another source, and an unknown value.
+    testEvents.push_back({MCTriggerSource::RocRail, "fnchanged", "f33", "on"});
+    testEvents.push_back({MCTriggerSource::Loco, "fnchanged", "f1", "on"});
+    testEvents.push_back({MCTriggerSource::RocRail, "fnchanged", "f1", "toggle"});
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_index_finds_same_actions_as_linear_walk()
+{
+    MCTriggerIndex index(events);
+
+    // 64 function triggers, 3 direction triggers and the f0 trigger.
+    TEST_ASSERT_EQUAL_UINT32(2 * FUNCTION_COUNT + 4, index.Size());
+
+    for (TestEvent &event : testEvents) {
+        std::vector<MCLocoAction *> expected = findLinear(event.Source, event.EventType, event.EventId, event.Value);
+        MCLocoActionSpan actions = index.Find(event.Source, event.EventType.c_str(), event.EventId.c_str(), event.Value.c_str());
+
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.size(), actions.size(), (event.EventType + " " + event.EventId + " " + event.Value).c_str());
+        for (size_t i = 0; i < expected.size(); i++) {
+            TEST_ASSERT_TRUE(expected[i] == actions.Begin[i].Action);
+        }
+    }
+}
+
+void test_index_keeps_trigger_delay()
+{
+    MCLocoAction *action = new MCLocoAction(channels[0], 100, HubLedColor::NONE);
+    MCLocoEvent event({new MCLocoTrigger(MCTriggerSource::RocRail, "fnchanged", "f1", "on", 1500)}, {action});
+    MCTriggerIndex index({&event});
+
+    MCLocoActionSpan actions = index.Find(MCTriggerSource::RocRail, "fnchanged", "f1", "on");
+    TEST_ASSERT_EQUAL_UINT32(1, actions.size());
+    TEST_ASSERT_TRUE(action == actions.Begin->Action);
+    TEST_ASSERT_EQUAL_UINT32(1500, actions.Begin->DelayInMs);
+}
+
+void test_benchmark_index_vs_linear_walk()
+{
+    MCTriggerIndex index(events);
+    size_t linearActionCount = 0;
+    size_t indexActionCount = 0;
+
+    auto linearStartedAt = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        for (TestEvent &event : testEvents) {
+            // BLELocomotive::TriggerEvent took its strings by value, so every call copied them.
+            linearActionCount += findLinear(event.Source, event.EventType, event.EventId, event.Value).size();
+        }
+    }
+    double linearNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - linearStartedAt).count() / (BENCHMARK_ITERATIONS * testEvents.size());
+
+    auto indexStartedAt = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        for (TestEvent &event : testEvents) {
+            indexActionCount += index.Find(event.Source, event.EventType.c_str(), event.EventId.c_str(), event.Value.c_str()).size();
+        }
+    }
+    double indexNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - indexStartedAt).count() / (BENCHMARK_ITERATIONS * testEvents.size());
+
+    char result[160];
+    snprintf(result, sizeof(result), "%u events, %u triggers: linear walk %.0f ns per event, trigger index %.0f ns per event.",
+             (uint)events.size(), index.Size(), linearNs, indexNs);
+    TEST_MESSAGE(result);
+
+    TEST_ASSERT_EQUAL_UINT32(linearActionCount, indexActionCount);
+    TEST_ASSERT_TRUE(indexNs < linearNs);
+}
+
+int main(int argc, char **argv)
+{
+    createEvents();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_index_finds_same_actions_as_linear_walk);
+    RUN_TEST(test_index_keeps_trigger_delay);
+    RUN_TEST(test_benchmark_index_vs_linear_walk);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+// Host stand-ins for the parts of the Arduino API used by the controller's log code.
+
+#include <cctype>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+// Records are only decoded on the host, never logged, so there's no clock.
+unsigned long millis();
+
+// Only declared by the logger (log4MC::info), never used on the host.
+class String;
+
+template <typename A, typename B>
+typename std::common_type<A, B>::type min(A a, B b)
+{
+    return a < b ? a : b;
+}
+
+template <typename A, typename B>
+typename std::common_type<A, B>::type max(A a, B b)
+{
+    return a > b ? a : b;
+}
\ No newline at end of file
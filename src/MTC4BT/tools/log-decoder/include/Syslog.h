@@ -0,0 +1,17 @@
+#pragma once
+
+// Host stand-in for the Syslog library: the log levels and masks used by the controller's logger. The logger only declares the syslog client, the host never sends to syslog.
+
+#define LOG_EMERG 0
+#define LOG_ALERT 1
+#define LOG_CRIT 2
+#define LOG_ERR 3
+#define LOG_WARNING 4
+#define LOG_NOTICE 5
+#define LOG_INFO 6
+#define LOG_DEBUG 7
+
+#define LOG_MASK(pri) (1 << (pri))
+#define LOG_UPTO(pri) ((1 << ((pri) + 1)) - 1)
+
+class Syslog;
\ No newline at end of file
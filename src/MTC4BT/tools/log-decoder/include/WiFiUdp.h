@@ -0,0 +1,5 @@
+#pragma once
+
+// Host stand-in for the UDP client. The logger only declares it, the host never sends to syslog.
+
+class WiFiUDP;
\ No newline at end of file
@@ -0,0 +1,78 @@
+# PlatformIO post-build script that writes the format table of the binary log mode (log_formats.txt) next to firmware.elf.
+# Binary log records identify their format string by its address in the firmware, so the table lists every string in the
+# firmware's data sections with its address. The log decoder looks the format strings up in it.
+
+Import("env")
+
+import struct
+
+SHT_PROGBITS = 1
+SHF_WRITE = 0x1
+SHF_ALLOC = 0x2
+SHF_EXECINSTR = 0x4
+
+
+# Returns the (address, data) of the sections of the given 32-bit little-endian ELF file that hold constants and variables.
+def read_data_sections(elf_path):
+    with open(elf_path, "rb") as f:
+        elf = f.read()
+
+    if elf[:4] != b"\x7fELF" or elf[4] != 1 or elf[5] != 1:
+        raise ValueError("%s is not a 32-bit little-endian ELF file" % elf_path)
+
+    shoff, = struct.unpack_from("<I", elf, 0x20)
+    shentsize, shnum = struct.unpack_from("<HH", elf, 0x2E)
+
+    sections = []
+    for i in range(shnum):
+        _, sectionType, flags, addr, offset, size = struct.unpack_from("<IIIIII", elf, shoff + i * shentsize)
+        if sectionType == SHT_PROGBITS and flags & SHF_ALLOC and not flags & SHF_EXECINSTR:
+            sections.append((addr, elf[offset:offset + size]))
+
+    return sections
+
+
+# Returns the given string with backslashes, control characters and non-ASCII characters escaped.
+def escape(data):
+    escaped = []
+    for b in data:
+        if b == 0x5C:
+            escaped.append("\\\\")
+        elif b == 0x0A:
+            escaped.append("\\n")
+        elif b == 0x0D:
+            escaped.append("\\r")
+        elif b == 0x09:
+            escaped.append("\\t")
+        elif 0x20 <= b < 0x7F:
+            escaped.append(chr(b))
+        else:
+            escaped.append("\\x%02x" % b)
+    return "".join(escaped)
+
+
+def is_text(data):
+    return all(0x20 <= b < 0x7F or b in (0x09, 0x0A, 0x0D) or b >= 0x80 for b in data)
+
+
+def write_format_table(source, target, env):
+    elf_path = target[0].get_abspath()
+    table_path = env.subst("$BUILD_DIR/log_formats.txt")
+
+    count = 0
+    with open(table_path, "w") as table:
+        for addr, data in read_data_sections(elf_path):
+            start = 0
+            while start < len(data):
+                end = data.find(b"\0", start)
+                if end < 0:
+                    break
+                if end > start and is_text(data[start:end]):
+                    table.write("%08x\t%s\n" % (addr + start, escape(data[start:end])))
+                    count += 1
+                start = end + 1
+
+    print("Log format table: %d strings written to %s" % (count, table_path))
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", write_format_table)
@@ -0,0 +1,4 @@
+// Compiles the controller's log record code for the host, so the tool formats messages exactly the way the controller does.
+
+#include "../../../../lib/MCNetwork/MCLogBuffer.cpp"
+#include "../../../../lib/MCNetwork/MCLogPacket.cpp"
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include <Arduino.h>
+#include <arpa/inet.h>
+#include <fstream>
+#include <map>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+
+#include "MCLogPacket.h"
+
+// Keep in sync with the default syslog port of the controller (loadNetworkConfiguration.h).
+#define DEFAULT_PORT 514
+
+// Format strings of the firmware by address, read from the format table.
+std::map<uint32_t, std::string> formats;
+
+// Last sequence number received from each controller.
+std::map<std::string, uint16_t> lastSequences;
+
+unsigned long millis()
+{
+    return 0;
+}
+
+// Returns the given string with the escapes written by log_formats.py replaced by the characters they stand for.
+std::string unescape(const std::string &escaped)
+{
+    std::string result;
+
+    for (size_t i = 0; i < escaped.length(); i++) {
+        if (escaped[i] != '\\' || i + 1 == escaped.length()) {
+            result += escaped[i];
+            continue;
+        }
+
+        switch (escaped[++i]) {
+        case 'n':
+            result += '\n';
+            break;
+        case 'r':
+            result += '\r';
+            break;
+        case 't':
+            result += '\t';
+            break;
+        case 'x':
+            result += (char)strtol(escaped.substr(i + 1, 2).c_str(), nullptr, 16);
+            i += 2;
+            break;
+        default:
+            result += escaped[i];
+            break;
+        }
+    }
+
+    return result;
+}
+
+// Reads the format table (lines of "<hex address>\t<escaped string>"). Returns false if the file can't be read.
+bool readFormatTable(const char *path)
+{
+    std::ifstream table(path);
+    if (!table) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(table, line)) {
+        size_t tab = line.find('\t');
+        if (tab != std::string::npos) {
+            formats[strtoul(line.substr(0, tab).c_str(), nullptr, 16)] = unescape(line.substr(tab + 1));
+        }
+    }
+
+    return !formats.empty();
+}
+
+// Returns the format string with the given id (its address in the firmware), or nullptr if it's not in the table.
+const char *findFormat(uint32_t formatId)
+{
+    auto it = formats.upper_bound(formatId);
+    if (it == formats.begin()) {
+        return nullptr;
+    }
+    it--;
+
+    // The linker merges a string into a longer one that ends with it, so the id may point into the middle of a string.
+    uint32_t offset = formatId - it->first;
+    return offset < it->second.length() ? it->second.c_str() + offset : nullptr;
+}
+
+// Returns the name of the given syslog level.
+const char *getLevelName(uint8_t level)
+{
+    static const char *levelNames[] = {"EMERG", "ALERT", "CRIT", "ERROR", "WARN", "NOTICE", "INFO", "DEBUG"};
+    return level < 8 ? levelNames[level] : "?";
+}
+
+// Prints the records of a received packet.
+void printPacket(const char *sender, const uint8_t *data, size_t size)
+{
+    uint16_t sequence;
+    bool valid = MCLogPacket::Read(data, size, sequence, findFormat, [sender](uint32_t formatId, MCLogRecord &record) {
+        char message[1024];
+        if (record.Format) {
+            MCLogBuffer::Format(record, message, sizeof(message));
+        } else {
+            snprintf(message, sizeof(message), "<unknown format %08x, is the format table from the firmware running on the controller?>", formatId);
+        }
+
+        printf("%s %6u.%03u [%u] %-6s %s%s\n", sender, record.Timestamp / 1000, record.Timestamp % 1000, record.Core, getLevelName(record.Level), message, record.Truncated ? " (truncated)" : "");
+    });
+
+    if (!valid) {
+        fprintf(stderr, "%s: Invalid packet (%u bytes), not a binary log packet of version %u.\n", sender, (uint)size, LOG_PACKET_VERSION);
+        return;
+    }
+
+    auto last = lastSequences.find(sender);
+    if (last != lastSequences.end() && sequence != (uint16_t)(last->second + 1) && sequence != 0) {
+        fprintf(stderr, "%s: %u packets lost.\n", sender, (uint16_t)(sequence - last->second - 1));
+    }
+    lastSequences[sender] = sequence;
+
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "Usage: %s <log_formats.txt> [port]\n", argv[0]);
+        return 2;
+    }
+
+    if (!readFormatTable(argv[1])) {
+        fprintf(stderr, "error: Format table %s not found or empty.\n", argv[1]);
+        return 2;
+    }
+
+    int port = argc == 3 ? atoi(argv[2]) : DEFAULT_PORT;
+    int udpSocket = socket(AF_INET, SOCK_DGRAM, 0);
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (udpSocket < 0 || bind(udpSocket, (sockaddr *)&address, sizeof(address)) < 0) {
+        fprintf(stderr, "error: Can't listen on UDP port %d (ports below 1024 require root).\n", port);
+        return 1;
+    }
+
+    fprintf(stderr, "Listening on UDP port %d (%u format strings).\n", port, (uint)formats.size());
+
+    for (;;) {
+        uint8_t data[LOG_PACKET_MAX_SIZE];
+        sockaddr_in sender;
+        socklen_t senderSize = sizeof(sender);
+
+        ssize_t size = recvfrom(udpSocket, data, sizeof(data), 0, (sockaddr *)&sender, &senderSize);
+        if (size >= 0) {
+            printPacket(inet_ntoa(sender.sin_addr), data, size);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+// Tests and benchmarks the controller's log buffer (MCLogBuffer): pushing a log record against formatting the message with snprintf on the caller's task.
+
+#include <chrono>
+#include <string>
+#include <unity.h>
+
+#include "../../src/firmware.cpp"
+
+#define BENCHMARK_ITERATIONS 200000
+
+unsigned long millis()
+{
+    return 0;
+}
+
+// Pushes the given message into the given buffer.
+bool push(MCLogBuffer &buffer, uint8_t level, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    bool pushed = buffer.Push(level, format, args);
+    va_end(args);
+    return pushed;
+}
+
+// Formats the given message with snprintf, the way log4MC did before the log buffer.
+int format(char *message, size_t size, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(message, size, format, args);
+    va_end(args);
+    return length;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_popped_record_formats_like_snprintf()
+{
+    MCLogBuffer buffer;
+    char name[] = "loco 7";
+
+    TEST_ASSERT_TRUE(push(buffer, 6, "Loco '%s' (%u): pwr %d%%, rate %.2f, at %lu ms, %5s|%-4d|%x", name, 7u, -42, 0.25, 123456ul, "ab", 3, 255));
+
+    // The record holds a copy of the string argument.
+    strcpy(name, "xxxxxx");
+
+    MCLogRecord record;
+    TEST_ASSERT_TRUE(buffer.Pop(record));
+    TEST_ASSERT_EQUAL_UINT8(6, record.Level);
+    TEST_ASSERT_FALSE(record.Truncated);
+
+    char message[256];
+    MCLogBuffer::Format(record, message, sizeof(message));
+    TEST_ASSERT_EQUAL_STRING("Loco 'loco 7' (7): pwr -42%, rate 0.25, at 123456 ms,    ab|3   |ff", message);
+
+    TEST_ASSERT_FALSE(buffer.Pop(record));
+}
+
+void test_full_buffer_drops_records()
+{
+    MCLogBuffer buffer;
+
+    for (int i = 0; i < LOG_BUFFER_SLOT_COUNT; i++) {
+        TEST_ASSERT_TRUE(push(buffer, 6, "Record %d", i));
+    }
+    TEST_ASSERT_FALSE(push(buffer, 6, "Record %d", LOG_BUFFER_SLOT_COUNT));
+    TEST_ASSERT_EQUAL_UINT32(1, buffer.GetDroppedCount());
+
+    // Records come out in order, and a popped slot can be used again.
+    MCLogRecord record;
+    char message[256];
+    TEST_ASSERT_TRUE(buffer.Pop(record));
+    MCLogBuffer::Format(record, message, sizeof(message));
+    TEST_ASSERT_EQUAL_STRING("Record 0", message);
+    TEST_ASSERT_TRUE(push(buffer, 6, "Record %d", LOG_BUFFER_SLOT_COUNT + 1));
+}
+
+void test_long_string_is_cut_and_following_args_dropped()
+{
+    MCLogBuffer buffer;
+    std::string longString(LOG_RECORD_ARGS_SIZE * 2, 'x');
+
+    TEST_ASSERT_TRUE(push(buffer, 6, "%s%d", longString.c_str(), 1));
+
+    MCLogRecord record;
+    TEST_ASSERT_TRUE(buffer.Pop(record));
+    TEST_ASSERT_TRUE(record.Truncated);
+
+    // The string fills the arguments (minus its length byte), so the int doesn't fit anymore.
+    char message[512];
+    MCLogBuffer::Format(record, message, sizeof(message));
+    TEST_ASSERT_EQUAL_STRING(longString.substr(0, LOG_RECORD_ARGS_SIZE - 1).c_str(), std::string(message).substr(0, LOG_RECORD_ARGS_SIZE - 1).c_str());
+    TEST_ASSERT_EQUAL_UINT32(LOG_RECORD_ARGS_SIZE, record.ArgsSize);
+}
+
+void test_benchmark_push_vs_snprintf()
+{
+    MCLogBuffer buffer;
+    MCLogRecord record;
+    char message[256];
+    const char *name = "loco 7";
+
+    auto pushStartedAt = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        push(buffer, 6, "Ctrl: Loco '%s' (%u) pwr %d%% at %lu ms.", name, 7u, i % 100, (unsigned long)i);
+
+        // Keep the buffer from filling up (popping only moves the record, it doesn't format it).
+        buffer.Pop(record);
+    }
+    double pushNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - pushStartedAt).count() / BENCHMARK_ITERATIONS;
+
+    auto formatStartedAt = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        format(message, sizeof(message), "Ctrl: Loco '%s' (%u) pwr %d%% at %lu ms.", name, 7u, i % 100, (unsigned long)i);
+    }
+    double formatNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - formatStartedAt).count() / BENCHMARK_ITERATIONS;
+
+    char result[128];
+    snprintf(result, sizeof(result), "Push + pop: %.0f ns per record, snprintf: %.0f ns per message.", pushNs, formatNs);
+    TEST_MESSAGE(result);
+
+    TEST_ASSERT_EQUAL_UINT32(0, buffer.GetDroppedCount());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_popped_record_formats_like_snprintf);
+    RUN_TEST(test_full_buffer_drops_records);
+    RUN_TEST(test_long_string_is_cut_and_following_args_dropped);
+    RUN_TEST(test_benchmark_push_vs_snprintf);
+    return UNITY_END();
+}
\ No newline at end of file
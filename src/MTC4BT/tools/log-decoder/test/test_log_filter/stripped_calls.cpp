@@ -0,0 +1,15 @@
+// Log calls of a firmware built with -DMC_LOG_MIN_LEVEL=LOG_INFO. Compiled apart from the tests, as the minimum level applies to the whole file.
+
+#define MC_LOG_MIN_LEVEL LOG_INFO
+
+#include "log4MC.h"
+
+void logStrippedCalls(int value)
+{
+    // Below the minimum level: removed by the compiler, format strings included.
+    log4MC::vlogf(LOG_DEBUG, "Stripped debug message %d.", value);
+    log4MC::debug("Stripped debug helper message.");
+
+    // At the minimum level: compiled in as usual.
+    log4MC::vlogf(LOG_INFO, "Kept info message %d.", value);
+}
\ No newline at end of file
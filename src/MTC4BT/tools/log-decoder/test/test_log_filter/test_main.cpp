@@ -0,0 +1,138 @@
+// Tests and benchmarks the level filter of the controller's logger (log4MC): a debug message filtered by the log mask against an empty loop, and log calls below MC_LOG_MIN_LEVEL (stripped_calls.cpp) that must leave no trace in the binary.
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unity.h>
+
+#include "../../src/firmware.cpp"
+#include "log4MC.h"
+
+#ifndef __OPTIMIZE__
+#error "The log filter tests check what the compiler removes, so they must be built with optimization, like the firmware (see platformio.ini)."
+#endif
+
+#define BENCHMARK_ITERATIONS 10000000
+
+// Logs the messages of stripped_calls.cpp.
+void logStrippedCalls(int value);
+
+unsigned long millis()
+{
+    return 0;
+}
+
+// Messages that passed the filter.
+MCLogBuffer loggedMessages;
+
+// The logger members used by the inlined log calls: the log mask of a controller configured to log info (and more severe) messages, and pushing a message (into the test's buffer).
+uint8_t log4MC::_priMask = LOG_UPTO(LOG_INFO);
+
+void log4MC::push(uint8_t level, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    loggedMessages.Push(level, fmt, args);
+    va_end(args);
+}
+
+// Returns the messages logged since the last call, formatted and separated by newlines.
+std::string popMessages()
+{
+    std::string messages;
+    MCLogRecord record;
+    char message[256];
+
+    while (loggedMessages.Pop(record)) {
+        MCLogBuffer::Format(record, message, sizeof(message));
+        messages += message;
+        messages += "\n";
+    }
+
+    return messages;
+}
+
+// Returns whether this test's binary contains the given text, reversed. The texts are kept reversed, so looking for them doesn't put them in the binary.
+bool binaryContainsReversed(const char *reversedText)
+{
+    std::string text(reversedText);
+    text = std::string(text.rbegin(), text.rend());
+
+    std::ifstream file("/proc/self/exe", std::ios::binary);
+    std::string binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    TEST_ASSERT_FALSE(binary.empty());
+
+    return binary.find(text) != std::string::npos;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_filtered_message_is_not_logged()
+{
+    log4MC::vlogf(LOG_DEBUG, "Filtered debug message %d.", 1);
+    log4MC::debug("Filtered debug helper message.");
+    log4MC::vlogf(LOG_INFO, "Logged info message %d.", 2);
+
+    TEST_ASSERT_EQUAL_STRING("Logged info message 2.\n", popMessages().c_str());
+}
+
+void test_call_below_min_level_compiles_to_nothing()
+{
+    logStrippedCalls(3);
+    TEST_ASSERT_EQUAL_STRING("Kept info message 3.\n", popMessages().c_str());
+
+    // The format string of the kept call is in the binary, the ones of the stripped calls aren't.
+    TEST_ASSERT_TRUE(binaryContainsReversed(".d% egassem ofni tpeK"));
+    TEST_ASSERT_FALSE(binaryContainsReversed(".d% egassem gubed deppirtS"));
+    TEST_ASSERT_FALSE(binaryContainsReversed(".egassem repleh gubed deppirtS"));
+}
+
+void test_benchmark_filtered_message_vs_empty_loop()
+{
+    auto emptyStartedAt = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        // Keeps the compiler from removing the loop, or from reading the log mask once for all iterations (it can't in the firmware, where the mask changes with the config).
+        asm volatile("" ::: "memory");
+    }
+    double emptyNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - emptyStartedAt).count() / BENCHMARK_ITERATIONS;
+
+    auto filteredStartedAt = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        asm volatile("" ::: "memory");
+        log4MC::vlogf(LOG_DEBUG, "Ctrl: Loco '%s' (%u) pwr %d%% at %lu ms.", "loco 7", 7u, i % 100, (unsigned long)i);
+    }
+    double filteredNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - filteredStartedAt).count() / BENCHMARK_ITERATIONS;
+
+    // For comparison: the same message when it passes the filter (pushed, and popped to keep the buffer from filling up).
+    MCLogRecord record;
+    auto loggedStartedAt = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        log4MC::vlogf(LOG_INFO, "Ctrl: Loco '%s' (%u) pwr %d%% at %lu ms.", "loco 7", 7u, i % 100, (unsigned long)i);
+        loggedMessages.Pop(record);
+    }
+    double loggedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - loggedStartedAt).count() / BENCHMARK_ITERATIONS;
+
+    char result[160];
+    snprintf(result, sizeof(result), "Empty loop: %.2f ns, filtered debug message: %.2f ns (%.2f ns per call), logged message: %.0f ns per iteration.",
+             emptyNs, filteredNs, filteredNs - emptyNs, loggedNs);
+    TEST_MESSAGE(result);
+
+    TEST_ASSERT_EQUAL_UINT32(0, loggedMessages.GetDroppedCount());
+    TEST_ASSERT_TRUE(filteredNs < loggedNs);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_filtered_message_is_not_logged);
+    RUN_TEST(test_call_below_min_level_compiles_to_nothing);
+    RUN_TEST(test_benchmark_filtered_message_vs_empty_loop);
+    return UNITY_END();
+}
\ No newline at end of file
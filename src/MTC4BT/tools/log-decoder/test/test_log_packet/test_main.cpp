@@ -0,0 +1,229 @@
+// Tests the binary log packets (MCLogPacket): records come out of a packet the way they went in, and typical messages take less space than syslog lines.
+
+#include <map>
+#include <string>
+#include <syslog.h>
+#include <unity.h>
+
+#include "../../src/firmware.cpp"
+
+// Number of records logged by a simulated controller.
+#define SIMULATED_RECORD_COUNT 60
+
+// Approximate size of the syslog header (IETF format) and line prefix sent with every message in text mode.
+#define SYSLOG_LINE_OVERHEAD (sizeof("<134>1 - mtc4bt-0a1b2c MTC4BT - - - \xEF\xBB\xBF") - 1 + sizeof("[0042] [1] ") - 1)
+
+unsigned long now = 0;
+
+unsigned long millis()
+{
+    return now;
+}
+
+// Format strings by id, the way the decoder reads them from the format table.
+std::map<uint32_t, const char *> formats;
+
+const char *findFormat(uint32_t formatId)
+{
+    auto format = formats.find(formatId);
+    return format != formats.end() ? format->second : nullptr;
+}
+
+// Captures the given message into the given record.
+void capture(MCLogRecord &record, uint8_t level, const char *format, ...)
+{
+    MCLogBuffer buffer;
+    va_list args;
+    va_start(args, format);
+    buffer.Push(level, format, args);
+    va_end(args);
+    buffer.Pop(record);
+
+    formats[(uint32_t)(uintptr_t)format] = format;
+}
+
+// Returns the given record formatted as text.
+std::string format(const MCLogRecord &record)
+{
+    char message[512];
+    MCLogBuffer::Format(record, message, sizeof(message));
+    return message;
+}
+
+// Captures the i-th message of a simulated controller connecting to its hubs.
+void captureSimulatedRecord(MCLogRecord &record, int i)
+{
+    char hubAddress[18];
+    snprintf(hubAddress, sizeof(hubAddress), "90:84:2b:01:20:%02x", 0x70 + i % 4);
+    now = 1200 + i * 5;
+
+    switch (i % 7) {
+    case 0:
+        capture(record, LOG_INFO, "BLE : Connecting to hub '%s'...", hubAddress);
+        break;
+    case 1:
+        capture(record, LOG_INFO, "BLE : Connected to hub '%s'.", hubAddress);
+        break;
+    case 2:
+        capture(record, LOG_INFO, "BLE : Watchdog timeout successfully set to s/10: %u", 3);
+        break;
+    case 3:
+        capture(record, LOG_INFO, "PU  : %s at port %x, running it %s.", "Found motor with encoder", i % 2, "closed-loop");
+        break;
+    case 4:
+        capture(record, LOG_INFO, "BLE : Reconnecting to hub '%s' (attempt %u of %u)...", hubAddress, i % 5 + 1, 5);
+        break;
+    case 5:
+        capture(record, LOG_INFO, "BLE : Recovered hub '%s' in %lu ms (dropouts: %u, fallback scans: %u).", hubAddress, 812ul + i, i / 7, 0);
+        break;
+    default:
+        capture(record, LOG_DEBUG, "MQTT: Received and ignored 'lc' command, because speed (%u) was below V_min (%u).", i % 10, 10);
+        break;
+    }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_records_round_trip()
+{
+    MCLogPacket packet;
+    MCLogRecord records[4];
+    capture(records[0], LOG_INFO, "Loco '%s' at %d%% (%ld, %lld, %p, %.3f, %*d)", "loco 7", -42, -100000l, 1ll << 40, (void *)0x3ffb1234, -1.5, 5, 7);
+    capture(records[1], LOG_ERR, "No arguments");
+    capture(records[2], LOG_WARNING, "Same string '%s', short '%s' and '%s'", "loco 7", "a", "");
+    capture(records[3], LOG_DEBUG, "%s%s%s", std::string(150, 'x').c_str(), std::string(150, 'y').c_str(), "z");
+    records[1].Core = 1;
+    records[1].Timestamp = records[0].Timestamp - 3;
+
+    for (MCLogRecord &record : records) {
+        TEST_ASSERT_TRUE(packet.Append(record));
+    }
+
+    int count = 0;
+    uint16_t sequence;
+    TEST_ASSERT_TRUE(MCLogPacket::Read(packet.GetData(), packet.GetSize(), sequence, findFormat, [&](uint32_t formatId, MCLogRecord &record) {
+        const MCLogRecord &original = records[count++];
+        TEST_ASSERT_TRUE(original.Format == record.Format);
+        TEST_ASSERT_EQUAL_UINT32(original.Timestamp, record.Timestamp);
+        TEST_ASSERT_EQUAL_UINT8(original.Level, record.Level);
+        TEST_ASSERT_EQUAL_UINT8(original.Core, record.Core);
+        TEST_ASSERT_EQUAL(original.Truncated, record.Truncated);
+        TEST_ASSERT_EQUAL_UINT8(original.ArgsSize, record.ArgsSize);
+        TEST_ASSERT_EQUAL_STRING(format(original).c_str(), format(record).c_str());
+    }));
+    TEST_ASSERT_EQUAL(4, count);
+    TEST_ASSERT_TRUE(records[3].Truncated);
+}
+
+void test_unknown_format_is_skipped()
+{
+    MCLogPacket packet;
+    MCLogRecord known;
+    MCLogRecord unknown;
+    capture(unknown, LOG_INFO, "Unknown %s %d", "hub", 1);
+    capture(known, LOG_INFO, "Known %s %d", "hub", 2);
+    formats.erase((uint32_t)(uintptr_t)unknown.Format);
+
+    TEST_ASSERT_TRUE(packet.Append(unknown));
+    TEST_ASSERT_TRUE(packet.Append(known));
+
+    std::string messages;
+    uint16_t sequence;
+    TEST_ASSERT_TRUE(MCLogPacket::Read(packet.GetData(), packet.GetSize(), sequence, findFormat, [&](uint32_t formatId, MCLogRecord &record) {
+        messages += record.Format ? format(record) : "?";
+        messages += ";";
+    }));
+
+    // The known record refers to the string of the unknown record, which the decoder can still read.
+    TEST_ASSERT_EQUAL_STRING("?;Known hub 2;", messages.c_str());
+}
+
+void test_full_packet_and_sequence()
+{
+    MCLogPacket packet;
+    MCLogRecord record;
+    capture(record, LOG_INFO, "%s", std::string(150, 'x').c_str());
+
+    int appended = 0;
+    while (packet.Append(record)) {
+        appended++;
+    }
+    TEST_ASSERT_TRUE(appended > 1);
+    TEST_ASSERT_TRUE(packet.GetSize() <= LOG_PACKET_MAX_SIZE);
+
+    packet.Clear();
+    TEST_ASSERT_TRUE(packet.IsEmpty());
+    TEST_ASSERT_TRUE(packet.Append(record));
+
+    uint16_t sequence;
+    TEST_ASSERT_TRUE(MCLogPacket::Read(packet.GetData(), packet.GetSize(), sequence, findFormat, [](uint32_t formatId, MCLogRecord &record) {}));
+    TEST_ASSERT_EQUAL_UINT32(1, sequence);
+
+    // Packets of another version are rejected.
+    uint8_t data[LOG_PACKET_MAX_SIZE];
+    memcpy(data, packet.GetData(), packet.GetSize());
+    data[2] = LOG_PACKET_VERSION - 1;
+    TEST_ASSERT_FALSE(MCLogPacket::Read(data, packet.GetSize(), sequence, findFormat, [](uint32_t formatId, MCLogRecord &record) {}));
+}
+
+void test_packet_size_of_simulated_controller()
+{
+    MCLogPacket packet;
+    size_t packetCount = 0;
+    size_t binarySize = 0;
+    // Size of the same records in the first binary layout (a 12 byte header and the captured arguments per record).
+    size_t uncompressedSize = 0;
+    size_t syslogSize = 0;
+    int decodedCount = 0;
+
+    auto send = [&]() {
+        uint16_t sequence;
+        TEST_ASSERT_TRUE(MCLogPacket::Read(packet.GetData(), packet.GetSize(), sequence, findFormat, [&](uint32_t formatId, MCLogRecord &record) {
+            MCLogRecord original;
+            captureSimulatedRecord(original, decodedCount++);
+            TEST_ASSERT_EQUAL_STRING(format(original).c_str(), format(record).c_str());
+        }));
+        packetCount++;
+        binarySize += packet.GetSize();
+        packet.Clear();
+    };
+
+    for (int i = 0; i < SIMULATED_RECORD_COUNT; i++) {
+        MCLogRecord record;
+        captureSimulatedRecord(record, i);
+
+        if (!packet.Append(record)) {
+            send();
+            packet.Append(record);
+        }
+
+        uncompressedSize += 12 + record.ArgsSize;
+        syslogSize += SYSLOG_LINE_OVERHEAD + format(record).length();
+    }
+    send();
+    uncompressedSize += packetCount * LOG_PACKET_HEADER_SIZE;
+
+    char result[192];
+    snprintf(result, sizeof(result), "%u records: %u packet(s) of %u bytes in total (%u bytes uncompressed), syslog: %u packets of %u bytes in total.",
+             SIMULATED_RECORD_COUNT, (uint)packetCount, (uint)binarySize, (uint)uncompressedSize, SIMULATED_RECORD_COUNT, (uint)syslogSize);
+    TEST_MESSAGE(result);
+
+    TEST_ASSERT_EQUAL(SIMULATED_RECORD_COUNT, decodedCount);
+    TEST_ASSERT_TRUE(binarySize < uncompressedSize);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_records_round_trip);
+    RUN_TEST(test_unknown_format_is_skipped);
+    RUN_TEST(test_full_packet_and_sequence);
+    RUN_TEST(test_packet_size_of_simulated_controller);
+    return UNITY_END();
+}
\ No newline at end of file
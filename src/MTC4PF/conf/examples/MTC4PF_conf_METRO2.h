@@ -34,6 +34,7 @@ const int NUM_LOCOS = 1;
 // - accelerationInterval: time interval for acceleration / braking (default: 100 ms)
 // - accelerateStep: power increment for each acceleration step
 // - brakeStep: : power decrement for each braking step
+// - speedCurveKneeSpeedPerc, speedCurveKneePowerPerc (optional): knee point of the speed curve, e.g. 30 and 50 to reach 50% power at 30% speed for smooth low-speed control (default: linear)
 MattzoLocoConfiguration *getMattzoLocoConfiguration()
 {
     static MattzoLocoConfiguration locoConf[NUM_LOCOS];
@@ -29,6 +29,9 @@ enum struct MotorShieldType {
 const int MIN_ARDUINO_POWER = 0;  // default minimum useful arduino power. May be overwritten in motor shield configuration
 const int MAX_ARDUINO_POWER = 1023; // default maximum arduino power. May be overwritten in motor shield configuration
 
+// Number of entries in the speed curve of a motor shield (one for every speed percentage from 0% to 100%)
+const int SPEED_CURVE_TABLE_SIZE = 101;
+
 // Train light types
 enum struct TrainLightType {
     ESP_OUTPUT_PIN,  // light is wired to a pin of the ESP-8266
@@ -58,6 +61,8 @@ struct MattzoLocoConfiguration {
     int accelerationInterval;
     int accelerateStep;
     int brakeStep;
+    int speedCurveKneeSpeedPerc; // optional: speed percentage of the knee point of the speed curve (0 = linear speed curve)
+    int speedCurveKneePowerPerc; // optional: power percentage (between min and max arduino power) at the knee point of the speed curve
 };
 
 // Motorshield configuration structure
@@ -94,6 +99,10 @@ class MattzoLoco
     int _accelerateStep = 1;                   // acceleration increment for a single acceleration step
     int _brakeStep = 2;                        // brake decrement for a single braking step
 
+    // Speed curve parameters
+    int _speedCurveKneeSpeedPerc = 0; // speed percentage of the knee point of the speed curve (0 = linear speed curve)
+    int _speedCurveKneePowerPerc = 0; // power percentage (between min and max arduino power) at the knee point of the speed curve
+
     // Methods
     void initMattzoLoco(MattzoLocoConfiguration c)
     {
@@ -102,6 +111,8 @@ class MattzoLoco
         _accelerationInterval = c.accelerationInterval;
         _accelerateStep = c.accelerateStep;
         _brakeStep = c.brakeStep;
+        _speedCurveKneeSpeedPerc = c.speedCurveKneeSpeedPerc;
+        _speedCurveKneePowerPerc = c.speedCurveKneePowerPerc;
     };
 
     String getNiceName()
@@ -135,6 +146,7 @@ class MattzoMotorShield
     int _configMotorA = 0;                    // 1 = forward, 0 not installed, -1 = reverse
     int _configMotorB = 0;
     int _irChannel = -1; // IR channel. May be 0, 1, 2 or 3. -1 = not installed
+    int _powerTable[SPEED_CURVE_TABLE_SIZE]; // arduino power for every speed percentage, compiled from the speed curve of the loco
     MattzoPowerFunctionsPwm pfPowerLevelRed;
     MattzoPowerFunctionsPwm pfPowerLevelBlue;
 
@@ -156,6 +168,30 @@ class MattzoMotorShield
         _irChannel = c.irChannel;
     }
 
+    // compiles the speed curve of the given loco into the power table of this motor shield
+    // the curve runs from the min arduino power at 0% through the optional knee point to the max arduino power at 100%
+    void compilePowerTable(MattzoLoco &loco)
+    {
+        int kneeSpeedPerc = loco._speedCurveKneeSpeedPerc;
+        int kneePower = _minArduinoPower + (_maxArduinoPower - _minArduinoPower) * loco._speedCurveKneePowerPerc / 100;
+
+        if (kneeSpeedPerc <= 0 || kneeSpeedPerc >= 100) {
+            // no knee point: linear speed curve
+            kneeSpeedPerc = 100;
+            kneePower = _maxArduinoPower;
+        }
+
+        // a speed of 0% always means stop
+        _powerTable[0] = 0;
+        for (int speedPerc = 1; speedPerc < SPEED_CURVE_TABLE_SIZE; speedPerc++) {
+            if (speedPerc <= kneeSpeedPerc) {
+                _powerTable[speedPerc] = _minArduinoPower + (kneePower - _minArduinoPower) * speedPerc / kneeSpeedPerc;
+            } else {
+                _powerTable[speedPerc] = kneePower + (_maxArduinoPower - kneePower) * (speedPerc - kneeSpeedPerc) / (100 - kneeSpeedPerc);
+            }
+        }
+    }
+
     bool checkLocoAddress(int locoAddress)
     {
         return (locoAddress == 0 || locoAddress == _locoAddress);
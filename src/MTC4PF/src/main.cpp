@@ -80,6 +80,14 @@ void setup()
             break;
         default:;
         }
+
+        // compile the speed curve of the loco the motor shield is built into (motor shields for all locos use the curve of the first loco)
+        for (int l = 0; l < NUM_LOCOS; l++) {
+            if (myMattzoMotorShields[i].checkLocoAddress(myLocos[l]._locoAddress)) {
+                myMattzoMotorShields[i].compilePowerTable(myLocos[l]);
+                break;
+            }
+        }
     }
 
     // stop all locos
@@ -306,8 +314,10 @@ void setTrainSpeed(int newTrainSpeed, int locoIndex)
     for (int motorShieldIndex = 0; motorShieldIndex < NUM_MOTORSHIELDS; motorShieldIndex++) {
         if (myMattzoMotorShields[motorShieldIndex].checkLocoAddress(loco._locoAddress)) {
             // Calculate desired power level for motor shield ports
-            if (newTrainSpeed != 0) {
-                desiredPowerLevel = map(abs(newTrainSpeed), 0, loco._maxTrainSpeed, myMattzoMotorShields[motorShieldIndex]._minArduinoPower, myMattzoMotorShields[motorShieldIndex]._maxArduinoPower);
+            if (newTrainSpeed != 0 && loco._maxTrainSpeed > 0) {
+                // look up the power level for the speed percentage in the compiled speed curve of the motor shield
+                int speedPerc = min(abs(newTrainSpeed) * 100 / loco._maxTrainSpeed, 100);
+                desiredPowerLevel = myMattzoMotorShields[motorShieldIndex]._powerTable[speedPerc];
             } else {
                 desiredPowerLevel = 0;
             }
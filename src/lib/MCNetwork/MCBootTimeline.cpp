@@ -0,0 +1,45 @@
+#include "MCBootTimeline.h"
+
+void MCBootTimeline::Mark(const char *milestone)
+{
+    // Milestones can be marked from any task, so claim a slot atomically.
+    uint8_t index = _count.fetch_add(1);
+    if (index >= BOOT_TIMELINE_MAX_MILESTONES) {
+        _count = BOOT_TIMELINE_MAX_MILESTONES;
+        return;
+    }
+
+    _milestones[index].timestamp = millis();
+    _milestones[index].name = milestone;
+}
+
+void MCBootTimeline::Format(char *buffer, size_t size)
+{
+    uint8_t count = min((uint8_t)_count, (uint8_t)BOOT_TIMELINE_MAX_MILESTONES);
+    size_t len = 0;
+
+    buffer[0] = '\0';
+    for (uint8_t i = 0; i < count && len < size; i++) {
+        if (_milestones[i].name == nullptr) {
+            // Slot claimed, but not filled yet.
+            continue;
+        }
+
+        len += snprintf(buffer + len, size - len, "%s%s=%lu", len ? " " : "", _milestones[i].name, _milestones[i].timestamp);
+    }
+}
+
+bool MCBootTimeline::IsPublished()
+{
+    return _published;
+}
+
+void MCBootTimeline::SetPublished()
+{
+    _published = true;
+}
+
+// Initialize private static members.
+MCBootTimeline::Milestone MCBootTimeline::_milestones[BOOT_TIMELINE_MAX_MILESTONES];
+std::atomic<uint8_t> MCBootTimeline::_count(0);
+bool MCBootTimeline::_published = false;
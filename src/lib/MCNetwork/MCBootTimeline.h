@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+// The maximum number of milestones the boot timeline can hold. Later milestones are dropped.
+#define BOOT_TIMELINE_MAX_MILESTONES 16
+
+// Records milestone timestamps from setup() onwards, so we can see where the cold start time goes.
+class MCBootTimeline
+{
+  public:
+    // Records the given milestone with the current uptime in milliseconds (the name must be a string literal).
+    static void Mark(const char *milestone);
+
+    // Writes the timeline to the given buffer as space separated "milestone=ms" pairs.
+    static void Format(char *buffer, size_t size);
+
+    // Returns a boolean value indicating whether the timeline has been published.
+    static bool IsPublished();
+
+    // Marks the timeline as published.
+    static void SetPublished();
+
+  private:
+    struct Milestone {
+        const char *name;
+        unsigned long timestamp;
+    };
+
+    static Milestone _milestones[BOOT_TIMELINE_MAX_MILESTONES];
+    static std::atomic<uint8_t> _count;
+    static bool _published;
+};
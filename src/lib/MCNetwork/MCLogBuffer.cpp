@@ -0,0 +1,426 @@
+#include "MCLogBuffer.h"
+
+// Appends the given value to the arguments of a record. Returns false if it doesn't fit.
+static bool putArg(uint8_t *&out, const uint8_t *end, const void *value, size_t size)
+{
+    if (out + size > end) {
+        return false;
+    }
+
+    memcpy(out, value, size);
+    out += size;
+    return true;
+}
+
+// Reads the next value from the arguments of a record. Returns false if there are no arguments left.
+static bool getArg(const uint8_t *&in, const uint8_t *end, void *value, size_t size)
+{
+    if (in + size > end) {
+        return false;
+    }
+
+    memcpy(value, in, size);
+    in += size;
+    return true;
+}
+
+// Formats a single argument with the given conversion specification and its '*' width and precision arguments.
+template <typename T>
+static int formatArg(char *buffer, size_t size, const char *spec, const int *stars, uint8_t starCount, T value)
+{
+    switch (starCount) {
+    case 0:
+        return snprintf(buffer, size, spec, value);
+    case 1:
+        return snprintf(buffer, size, spec, stars[0], value);
+    default:
+        return snprintf(buffer, size, spec, stars[0], stars[1], value);
+    }
+}
+
+MCLogBuffer::MCLogBuffer()
+{
+    // A slot is free for the producer claiming position pos, when its sequence equals pos.
+    for (uint32_t i = 0; i < LOG_BUFFER_SLOT_COUNT; i++) {
+        _slots[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+
+    _enqueuePos.store(0, std::memory_order_relaxed);
+    _dequeuePos = 0;
+    _droppedCount.store(0, std::memory_order_relaxed);
+}
+
+bool MCLogBuffer::Push(uint8_t level, const char *format, va_list args)
+{
+    // Claim a position (bounded multi-producer queue, as described by Dmitry Vyukov).
+    uint32_t pos = _enqueuePos.load(std::memory_order_relaxed);
+    Slot *slot;
+    for (;;) {
+        slot = &_slots[pos & (LOG_BUFFER_SLOT_COUNT - 1)];
+        int32_t diff = (int32_t)(slot->Sequence.load(std::memory_order_acquire) - pos);
+
+        if (diff == 0) {
+            if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The log task hasn't emptied this slot yet, so the buffer is full.
+            _droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            // Another task claimed this position first.
+            pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    MCLogRecord &record = slot->Record;
+    record.Format = format;
+    record.Timestamp = millis();
+    record.Level = level;
+#ifdef ESP32
+    record.Core = xPortGetCoreID();
+#else
+    record.Core = 0;
+#endif
+    captureArgs(record, args);
+
+    // Hand the record over to the log task.
+    slot->Sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool MCLogBuffer::Pop(MCLogRecord &record)
+{
+    Slot &slot = _slots[_dequeuePos & (LOG_BUFFER_SLOT_COUNT - 1)];
+    if ((int32_t)(slot.Sequence.load(std::memory_order_acquire) - (_dequeuePos + 1)) < 0) {
+        // Empty, or the producer of the oldest record is still copying its arguments.
+        return false;
+    }
+
+    record = slot.Record;
+
+    // Free the slot for the producer that wraps around to it.
+    slot.Sequence.store(_dequeuePos + LOG_BUFFER_SLOT_COUNT, std::memory_order_release);
+    _dequeuePos++;
+    return true;
+}
+
+uint32_t MCLogBuffer::GetDroppedCount()
+{
+    return _droppedCount.load(std::memory_order_relaxed);
+}
+
+void MCLogBuffer::ForEachArg(const char *format, std::function<bool(ArgLayout layout)> callback)
+{
+    // Visits the arguments the same way captureArgs stores them.
+    for (const char *p = format; *p; p++) {
+        if (*p != '%') {
+            continue;
+        }
+
+        Spec spec;
+        p = parseSpec(p + 1, spec);
+        if (!*p) {
+            return;
+        }
+
+        for (uint8_t i = 0; i < spec.StarCount; i++) {
+            if (!callback(Int32Arg)) {
+                return;
+            }
+        }
+
+        bool next = true;
+        switch (spec.Type) {
+        case Int:
+            next = callback(Int32Arg);
+            break;
+        case Long:
+        case LongLong:
+        case Pointer:
+            next = callback(Int64Arg);
+            break;
+        case Double:
+        case LongDouble:
+            next = callback(DoubleArg);
+            break;
+        case String:
+            next = callback(StringArg);
+            break;
+        case None:
+            break;
+        }
+
+        if (!next) {
+            return;
+        }
+    }
+}
+
+const char *MCLogBuffer::parseSpec(const char *spec, Spec &result)
+{
+    const char *p = spec;
+    uint8_t longCount = 0;
+    bool longDouble = false;
+
+    result.StarCount = 0;
+    result.Type = None;
+
+    // Flags.
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') {
+        p++;
+    }
+
+    // Width.
+    if (*p == '*') {
+        result.StarCount++;
+        p++;
+    } else {
+        while (isdigit(*p)) {
+            p++;
+        }
+    }
+
+    // Precision.
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            result.StarCount++;
+            p++;
+        } else {
+            while (isdigit(*p)) {
+                p++;
+            }
+        }
+    }
+
+    // Length modifier.
+    while (*p == 'h' || *p == 'l' || *p == 'j' || *p == 'z' || *p == 't' || *p == 'L') {
+        if (*p == 'l') {
+            longCount++;
+        } else if (*p == 'j') {
+            longCount = 2;
+        } else if (*p == 'z' || *p == 't') {
+            longCount = 1;
+        } else if (*p == 'L') {
+            longDouble = true;
+        }
+        p++;
+    }
+
+    switch (*p) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+    case 'c':
+        result.Type = longCount >= 2 ? LongLong : longCount == 1 ? Long : Int;
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        result.Type = longDouble ? LongDouble : Double;
+        break;
+    case 's':
+        result.Type = String;
+        break;
+    case 'p':
+    case 'n':
+        result.Type = Pointer;
+        break;
+    }
+
+    return p;
+}
+
+void MCLogBuffer::captureArgs(MCLogRecord &record, va_list args)
+{
+    uint8_t *out = record.Args;
+    const uint8_t *end = record.Args + LOG_RECORD_ARGS_SIZE;
+    bool fits = true;
+
+    for (const char *p = record.Format; *p && fits; p++) {
+        if (*p != '%') {
+            continue;
+        }
+
+        Spec spec;
+        p = parseSpec(p + 1, spec);
+        if (!*p) {
+            break;
+        }
+
+        for (uint8_t i = 0; i < spec.StarCount && fits; i++) {
+            int star = va_arg(args, int);
+            fits = putArg(out, end, &star, sizeof(star));
+        }
+
+        switch (spec.Type) {
+        case Int: {
+            int value = va_arg(args, int);
+            fits = fits && putArg(out, end, &value, sizeof(value));
+            break;
+        }
+        case Long: {
+            // Stored as 8 bytes, so the layout of the arguments doesn't depend on the platform (see Format).
+            int64_t value = va_arg(args, long);
+            fits = fits && putArg(out, end, &value, sizeof(value));
+            break;
+        }
+        case LongLong: {
+            long long value = va_arg(args, long long);
+            fits = fits && putArg(out, end, &value, sizeof(value));
+            break;
+        }
+        case Double: {
+            double value = va_arg(args, double);
+            fits = fits && putArg(out, end, &value, sizeof(value));
+            break;
+        }
+        case LongDouble: {
+            // Stored as a double, to save space.
+            double value = va_arg(args, long double);
+            fits = fits && putArg(out, end, &value, sizeof(value));
+            break;
+        }
+        case Pointer: {
+            uint64_t value = (uintptr_t)va_arg(args, void *);
+            fits = fits && putArg(out, end, &value, sizeof(value));
+            break;
+        }
+        case String: {
+            const char *value = va_arg(args, const char *);
+            if (!value) {
+                value = "(null)";
+            }
+
+            // Copy as much of the string as fits (the caller's string may be gone by the time the record is formatted).
+            size_t available = end - out;
+            if (!fits || available < 1) {
+                fits = false;
+                break;
+            }
+            uint8_t length = min(strlen(value), min(available - 1, (size_t)UINT8_MAX));
+            *out++ = length;
+            memcpy(out, value, length);
+            out += length;
+            break;
+        }
+        case None:
+            break;
+        }
+    }
+
+    record.ArgsSize = out - record.Args;
+    record.Truncated = !fits;
+}
+
+size_t MCLogBuffer::Format(const MCLogRecord &record, char *buffer, size_t size)
+{
+    const uint8_t *in = record.Args;
+    const uint8_t *end = record.Args + record.ArgsSize;
+    size_t len = 0;
+
+    for (const char *p = record.Format; *p && len + 1 < size; p++) {
+        if (*p != '%') {
+            buffer[len++] = *p;
+            continue;
+        }
+
+        const char *start = p;
+        Spec spec;
+        p = parseSpec(p + 1, spec);
+        if (!*p) {
+            break;
+        }
+
+        if (spec.Type == None) {
+            if (*p == '%') {
+                buffer[len++] = '%';
+            }
+            continue;
+        }
+
+        // Copy the conversion specification, so we can format the argument with it.
+        char specFormat[16];
+        size_t specLength = min((size_t)(p - start + 1), sizeof(specFormat) - 1);
+        memcpy(specFormat, start, specLength);
+        specFormat[specLength] = '\0';
+
+        int stars[2] = {0, 0};
+        bool available = true;
+        for (uint8_t i = 0; i < spec.StarCount; i++) {
+            available = available && getArg(in, end, &stars[i], sizeof(int));
+        }
+
+        int written = 0;
+        switch (spec.Type) {
+        case Int: {
+            int value;
+            available = available && getArg(in, end, &value, sizeof(value));
+            written = available ? formatArg(buffer + len, size - len, specFormat, stars, spec.StarCount, value) : 0;
+            break;
+        }
+        case Long: {
+            int64_t value;
+            available = available && getArg(in, end, &value, sizeof(value));
+            written = available ? formatArg(buffer + len, size - len, specFormat, stars, spec.StarCount, (long)value) : 0;
+            break;
+        }
+        case LongLong: {
+            long long value;
+            available = available && getArg(in, end, &value, sizeof(value));
+            written = available ? formatArg(buffer + len, size - len, specFormat, stars, spec.StarCount, value) : 0;
+            break;
+        }
+        case Double: {
+            double value;
+            available = available && getArg(in, end, &value, sizeof(value));
+            written = available ? formatArg(buffer + len, size - len, specFormat, stars, spec.StarCount, value) : 0;
+            break;
+        }
+        case LongDouble: {
+            double value;
+            available = available && getArg(in, end, &value, sizeof(value));
+            written = available ? formatArg(buffer + len, size - len, specFormat, stars, spec.StarCount, (long double)value) : 0;
+            break;
+        }
+        case Pointer: {
+            uint64_t value;
+            available = available && getArg(in, end, &value, sizeof(value));
+            // Never write through a captured pointer (%n).
+            written = available && *p != 'n' ? formatArg(buffer + len, size - len, specFormat, stars, spec.StarCount, (void *)(uintptr_t)value) : 0;
+            break;
+        }
+        case String: {
+            char value[UINT8_MAX + 1];
+            uint8_t length = 0;
+            available = available && getArg(in, end, &length, sizeof(length)) && getArg(in, end, value, length);
+            value[available ? length : 0] = '\0';
+            written = available ? formatArg(buffer + len, size - len, specFormat, stars, spec.StarCount, (const char *)value) : 0;
+            break;
+        }
+        case None:
+            break;
+        }
+
+        if (!available) {
+            // The remaining arguments didn't fit into the record.
+            len += snprintf(buffer + len, size - len, "...");
+            break;
+        }
+
+        len += max(written, 0);
+    }
+
+    len = min(len, size - 1);
+    buffer[len] = '\0';
+    return len;
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+
+// Number of records the log buffer can hold (must be a power of two).
+#define LOG_BUFFER_SLOT_COUNT 64
+
+// Number of bytes available for the arguments of a single log record. Longer string arguments are truncated.
+#define LOG_RECORD_ARGS_SIZE 200
+
+// Log message, with its arguments copied into the record, so it can be formatted later on another task.
+struct MCLogRecord {
+    // printf-style format string (must live forever, e.g. a string literal).
+    const char *Format;
+
+    // Time the message was logged (in ms since boot).
+    uint32_t Timestamp;
+
+    // Syslog level of the message.
+    uint8_t Level;
+
+    // Core the message was logged on.
+    uint8_t Core;
+
+    // Number of bytes used in Args.
+    uint8_t ArgsSize;
+
+    // Boolean value indicating whether arguments were dropped, because they didn't fit.
+    bool Truncated;
+
+    // The arguments, in the order of the format string: ints (4 bytes), longs, long longs, pointers and doubles (8 bytes), strings (length byte + chars).
+    // The layout is the same on every (little-endian) platform, so binary log records can be formatted on a PC (see MCLogPacket.h).
+    uint8_t Args[LOG_RECORD_ARGS_SIZE];
+};
+
+// Lock-free ring buffer of log records, filled by any number of tasks (on both cores) and drained by a single task.
+// Logging only copies the arguments into a free slot, so it never blocks, allocates or formats on the caller's task.
+// If the buffer is full, the record is dropped and counted.
+class MCLogBuffer
+{
+  public:
+    MCLogBuffer();
+
+    // Copies the given message into a free slot. Returns false (and counts the record as dropped) if the buffer is full.
+    bool Push(uint8_t level, const char *format, va_list args);
+
+    // Moves the oldest record into the given record. Returns false if the buffer is empty. Must only be called from a single task.
+    bool Pop(MCLogRecord &record);
+
+    // Returns the number of records dropped since startup, because the buffer was full.
+    uint32_t GetDroppedCount();
+
+    // Formats the given record into the given buffer. Returns the length of the message.
+    static size_t Format(const MCLogRecord &record, char *buffer, size_t size);
+
+    // Layout of a captured argument in the arguments of a record.
+    enum ArgLayout {
+        // 4 bytes (ints and '*' widths and precisions).
+        Int32Arg,
+        // 8 bytes (longs, long longs and pointers).
+        Int64Arg,
+        // 8 bytes (doubles and long doubles).
+        DoubleArg,
+        // Length byte + chars.
+        StringArg
+    };
+
+    // Calls the callback with the layout of every argument captured for the given format, in the order the arguments are stored in a record.
+    // Stops as soon as the callback returns false.
+    static void ForEachArg(const char *format, std::function<bool(ArgLayout layout)> callback);
+
+  private:
+    // Type of the argument of a conversion specification.
+    enum ArgType {
+        None,
+        Int,
+        Long,
+        LongLong,
+        Double,
+        LongDouble,
+        Pointer,
+        String
+    };
+
+    // Conversion specification in a format string.
+    struct Spec {
+        // Number of '*' width and precision arguments (passed as ints before the argument itself).
+        uint8_t StarCount;
+        ArgType Type;
+    };
+
+    struct Slot {
+        std::atomic<uint32_t> Sequence;
+        MCLogRecord Record;
+    };
+
+    // Parses the conversion specification after the '%' at the given position. Returns the position of the conversion character.
+    static const char *parseSpec(const char *spec, Spec &result);
+
+    // Copies the given arguments into the given record.
+    static void captureArgs(MCLogRecord &record, va_list args);
+
+    Slot _slots[LOG_BUFFER_SLOT_COUNT];
+    std::atomic<uint32_t> _enqueuePos;
+    uint32_t _dequeuePos;
+    std::atomic<uint32_t> _droppedCount;
+};
\ No newline at end of file
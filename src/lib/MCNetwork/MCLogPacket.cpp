@@ -0,0 +1,328 @@
+#include "MCLogPacket.h"
+
+// Record flags (in the info byte).
+#define LOG_PACKET_INFO_TRUNCATED 0x20
+
+// Max. size of the encoded arguments of a record (a varint may take a byte more than the captured value).
+#define LOG_PACKET_ARGS_MAX_SIZE (2 * LOG_RECORD_ARGS_SIZE)
+
+// Max. size of the header of a record.
+#define LOG_PACKET_RECORD_HEADER_MAX_SIZE 13
+
+// Strings shorter than this are repeated, as referring to them takes as many bytes.
+#define LOG_PACKET_MIN_SHARED_STRING_LENGTH 2
+
+// Writes the given value as a varint. Returns the number of bytes written.
+static size_t putVarint(uint8_t *out, uint64_t value)
+{
+    size_t size = 0;
+    while (value >= 0x80) {
+        out[size++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    out[size++] = value;
+    return size;
+}
+
+// Reads a varint at the given position. Returns false if it doesn't end before the given end.
+static bool getVarint(const uint8_t *data, size_t end, size_t &pos, uint64_t &value)
+{
+    value = 0;
+    for (uint8_t shift = 0; pos < end && shift < 64; shift += 7) {
+        uint8_t byte = data[pos++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Maps signed values to unsigned ones, so small negative values make small varints too (0, -1, 1, -2... become 0, 1, 2, 3...).
+static uint64_t zigzag(int64_t value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+MCLogPacket::MCLogPacket()
+{
+    _size = 0;
+    _sequence = 0;
+    Clear();
+}
+
+bool MCLogPacket::Append(const MCLogRecord &record)
+{
+    if (_recordCount == UINT8_MAX) {
+        return false;
+    }
+
+    // Format strings live in flash (or RAM) for the lifetime of the firmware, so their address identifies them.
+    uint32_t formatId = (uint32_t)(uintptr_t)record.Format;
+
+    uint8_t args[LOG_PACKET_ARGS_MAX_SIZE];
+    uint16_t stringOffsets[LOG_PACKET_MAX_STRINGS];
+    uint8_t stringCount;
+    size_t argsSize = encodeArgs(record, args, stringOffsets, stringCount);
+
+    uint8_t header[LOG_PACKET_RECORD_HEADER_MAX_SIZE];
+    size_t headerSize = 0;
+    headerSize += putVarint(header + headerSize, zigzag((int32_t)(formatId - _lastFormatId)));
+    headerSize += putVarint(header + headerSize, zigzag((int32_t)(record.Timestamp - _lastTimestamp)));
+    header[headerSize++] = (record.Level & 0x07) | (record.Core & 0x03) << 3 | (record.Truncated ? LOG_PACKET_INFO_TRUNCATED : 0);
+    headerSize += putVarint(header + headerSize, argsSize);
+
+    if (_size + headerSize + argsSize > LOG_PACKET_MAX_SIZE) {
+        return false;
+    }
+
+    memcpy(_data + _size, header, headerSize);
+    memcpy(_data + _size + headerSize, args, argsSize);
+
+    // Later records can refer to the new strings of this record.
+    for (uint8_t i = 0; i < stringCount && _stringCount < LOG_PACKET_MAX_STRINGS; i++) {
+        _strings[_stringCount++] = _size + headerSize + stringOffsets[i];
+    }
+
+    _size += headerSize + argsSize;
+    _lastFormatId = formatId;
+    _lastTimestamp = record.Timestamp;
+
+    _data[3] = ++_recordCount;
+    return true;
+}
+
+void MCLogPacket::Clear()
+{
+    if (_size > LOG_PACKET_HEADER_SIZE) {
+        // A gap in the sequence numbers tells the decoder that packets were lost.
+        _sequence++;
+    }
+
+    _data[0] = 'M';
+    _data[1] = 'L';
+    _data[2] = LOG_PACKET_VERSION;
+    _data[3] = 0;
+    memcpy(_data + 4, &_sequence, sizeof(_sequence));
+    _size = LOG_PACKET_HEADER_SIZE;
+    _recordCount = 0;
+    _lastFormatId = 0;
+    _lastTimestamp = 0;
+    _stringCount = 0;
+}
+
+bool MCLogPacket::IsEmpty()
+{
+    return _recordCount == 0;
+}
+
+const uint8_t *MCLogPacket::GetData()
+{
+    return _data;
+}
+
+size_t MCLogPacket::GetSize()
+{
+    return _size;
+}
+
+bool MCLogPacket::Read(const uint8_t *data, size_t size, uint16_t &sequence, std::function<const char *(uint32_t formatId)> findFormat, std::function<void(uint32_t formatId, MCLogRecord &record)> callback)
+{
+    if (size < LOG_PACKET_HEADER_SIZE || data[0] != 'M' || data[1] != 'L' || data[2] != LOG_PACKET_VERSION) {
+        return false;
+    }
+
+    uint8_t recordCount = data[3];
+    memcpy(&sequence, data + 4, sizeof(sequence));
+
+    size_t pos = LOG_PACKET_HEADER_SIZE;
+    uint32_t formatId = 0;
+    uint32_t timestamp = 0;
+    for (uint8_t i = 0; i < recordCount; i++) {
+        uint64_t formatIdDelta;
+        uint64_t timestampDelta;
+        uint64_t argsSize;
+        if (!getVarint(data, size, pos, formatIdDelta) || !getVarint(data, size, pos, timestampDelta) || pos >= size) {
+            return false;
+        }
+        uint8_t info = data[pos++];
+        if (!getVarint(data, size, pos, argsSize) || argsSize > size - pos) {
+            return false;
+        }
+
+        formatId += (uint32_t)unzigzag(formatIdDelta);
+        timestamp += (uint32_t)unzigzag(timestampDelta);
+
+        MCLogRecord record;
+        record.Format = findFormat(formatId);
+        record.Timestamp = timestamp;
+        record.Level = info & 0x07;
+        record.Core = (info >> 3) & 0x03;
+        record.Truncated = info & LOG_PACKET_INFO_TRUNCATED;
+        record.ArgsSize = 0;
+        if (record.Format && !decodeArgs(data, pos, pos + argsSize, record)) {
+            // The arguments don't match the format, so it's not the format the record was logged with.
+            record.Format = nullptr;
+            record.ArgsSize = 0;
+        }
+        pos += argsSize;
+
+        callback(formatId, record);
+    }
+
+    return true;
+}
+
+size_t MCLogPacket::encodeArgs(const MCLogRecord &record, uint8_t *out, uint16_t *stringOffsets, uint8_t &stringCount)
+{
+    const uint8_t *in = record.Args;
+    const uint8_t *end = record.Args + record.ArgsSize;
+    size_t size = 0;
+    stringCount = 0;
+
+    // The arguments end early when they didn't fit into the record.
+    MCLogBuffer::ForEachArg(record.Format, [&](MCLogBuffer::ArgLayout layout) -> bool {
+        switch (layout) {
+        case MCLogBuffer::Int32Arg: {
+            int32_t value;
+            if (in + sizeof(value) > end) {
+                return false;
+            }
+            memcpy(&value, in, sizeof(value));
+            in += sizeof(value);
+            size += putVarint(out + size, zigzag(value));
+            return true;
+        }
+        case MCLogBuffer::Int64Arg: {
+            int64_t value;
+            if (in + sizeof(value) > end) {
+                return false;
+            }
+            memcpy(&value, in, sizeof(value));
+            in += sizeof(value);
+            size += putVarint(out + size, zigzag(value));
+            return true;
+        }
+        case MCLogBuffer::DoubleArg: {
+            if (in + sizeof(double) > end) {
+                return false;
+            }
+            memcpy(out + size, in, sizeof(double));
+            in += sizeof(double);
+            size += sizeof(double);
+            return true;
+        }
+        case MCLogBuffer::StringArg: {
+            if (in + 1 > end || in + 1 + in[0] > end) {
+                return false;
+            }
+            uint8_t length = in[0];
+            const uint8_t *chars = in + 1;
+            in += 1 + length;
+
+            if (length >= LOG_PACKET_MIN_SHARED_STRING_LENGTH) {
+                // Refer to the same string earlier in the packet (hub addresses, loco names...), if there is one.
+                for (uint8_t i = 0; i < _stringCount; i++) {
+                    size_t pos = _strings[i];
+                    uint64_t entry;
+                    getVarint(_data, _size, pos, entry);
+                    if ((entry >> 1) == length && memcmp(_data + pos, chars, length) == 0) {
+                        size += putVarint(out + size, (uint64_t)_strings[i] << 1 | 1);
+                        return true;
+                    }
+                }
+
+                if (stringCount < LOG_PACKET_MAX_STRINGS) {
+                    stringOffsets[stringCount++] = size;
+                }
+            }
+
+            size += putVarint(out + size, (uint64_t)length << 1);
+            memcpy(out + size, chars, length);
+            size += length;
+            return true;
+        }
+        }
+        return false;
+    });
+
+    return size;
+}
+
+bool MCLogPacket::decodeArgs(const uint8_t *data, size_t pos, size_t end, MCLogRecord &record)
+{
+    uint8_t *out = record.Args;
+    const uint8_t *outEnd = record.Args + LOG_RECORD_ARGS_SIZE;
+    bool valid = true;
+
+    MCLogBuffer::ForEachArg(record.Format, [&](MCLogBuffer::ArgLayout layout) -> bool {
+        if (pos == end) {
+            // The remaining arguments didn't fit into the record.
+            return false;
+        }
+
+        uint64_t value;
+        switch (layout) {
+        case MCLogBuffer::Int32Arg: {
+            valid = getVarint(data, end, pos, value) && out + sizeof(int32_t) <= outEnd;
+            if (valid) {
+                int32_t arg = unzigzag(value);
+                memcpy(out, &arg, sizeof(arg));
+                out += sizeof(arg);
+            }
+            break;
+        }
+        case MCLogBuffer::Int64Arg: {
+            valid = getVarint(data, end, pos, value) && out + sizeof(int64_t) <= outEnd;
+            if (valid) {
+                int64_t arg = unzigzag(value);
+                memcpy(out, &arg, sizeof(arg));
+                out += sizeof(arg);
+            }
+            break;
+        }
+        case MCLogBuffer::DoubleArg: {
+            valid = pos + sizeof(double) <= end && out + sizeof(double) <= outEnd;
+            if (valid) {
+                memcpy(out, data + pos, sizeof(double));
+                pos += sizeof(double);
+                out += sizeof(double);
+            }
+            break;
+        }
+        case MCLogBuffer::StringArg: {
+            valid = getVarint(data, end, pos, value);
+            size_t stringPos = pos;
+            size_t stringEnd = end;
+            bool reference = value & 1;
+            if (valid && reference) {
+                // Refers to a string earlier in the packet.
+                stringPos = value >> 1;
+                stringEnd = pos;
+                valid = stringPos < stringEnd && getVarint(data, stringEnd, stringPos, value) && !(value & 1);
+            }
+
+            size_t length = value >> 1;
+            valid = valid && length <= UINT8_MAX && length <= stringEnd - stringPos && out + 1 + length <= outEnd;
+            if (valid) {
+                *out++ = length;
+                memcpy(out, data + stringPos, length);
+                out += length;
+                if (!reference) {
+                    pos += length;
+                }
+            }
+            break;
+        }
+        }
+        return valid;
+    });
+
+    record.ArgsSize = out - record.Args;
+    return valid && pos == end;
+}
\ No newline at end of file
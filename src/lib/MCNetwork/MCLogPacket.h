@@ -0,0 +1,73 @@
+#pragma once
+
+#include <functional>
+
+#include "MCLogBuffer.h"
+
+// Max. size of a binary log packet (fits into a single WiFi frame).
+#define LOG_PACKET_MAX_SIZE 1400
+
+// Version of the binary log packet layout. Increase when changing the layout below.
+#define LOG_PACKET_VERSION 2
+
+#define LOG_PACKET_HEADER_SIZE 6
+
+// Max. number of strings per packet that later records can refer to, instead of repeating them.
+#define LOG_PACKET_MAX_STRINGS 32
+
+// UDP packet of log records in binary form, sent instead of syslog lines when the syslog format is "binary".
+// Format strings are sent as their address in the firmware, which tools/log-decoder looks up in the format table
+// generated from the firmware at build time. All values are little-endian, varints are LEB128 (7 bits per byte).
+//
+//   Header: 'M' 'L' version(1) recordCount(1) sequence(2)
+//   Record: formatIdDelta(zigzag varint) timestampDelta(zigzag varint) info(1) argsSize(varint) args(argsSize)
+//
+// The format id and timestamp are relative to those of the previous record in the packet (or to 0 for the first record).
+// Info holds the level (bits 0-2), the core (bits 3-4) and the truncated flag (bit 5).
+// The arguments are re-encoded in the order of the format string: ints, longs and pointers as zigzag varints,
+// doubles as 8 bytes and strings as varint (length << 1) + chars. A string that's already in the packet is sent
+// as varint (offset << 1 | 1) instead, the offset being the position of the earlier string in the packet.
+// The args size allows skipping records with formats that aren't in the format table.
+class MCLogPacket
+{
+  public:
+    MCLogPacket();
+
+    // Appends the given record. Returns false if it doesn't fit, in which case the packet should be sent first.
+    bool Append(const MCLogRecord &record);
+
+    // Empties the packet and moves on to the next sequence number, once it has been sent.
+    void Clear();
+
+    // Returns a boolean value indicating whether the packet contains any records.
+    bool IsEmpty();
+
+    const uint8_t *GetData();
+    size_t GetSize();
+
+    // Reads the records of a received packet and calls the callback for each record with its format id.
+    // The format of a record is looked up with findFormat. If it isn't found, the record's format is nullptr and it has no arguments.
+    // Returns false if the packet is not a valid binary log packet.
+    static bool Read(const uint8_t *data, size_t size, uint16_t &sequence, std::function<const char *(uint32_t formatId)> findFormat, std::function<void(uint32_t formatId, MCLogRecord &record)> callback);
+
+  private:
+    // Encodes the arguments of the given record. Returns the size of the encoded arguments.
+    // Sets the offsets (in the encoded arguments) of the strings that later records can refer to.
+    size_t encodeArgs(const MCLogRecord &record, uint8_t *out, uint16_t *stringOffsets, uint8_t &stringCount);
+
+    // Decodes the encoded arguments of a record (from pos up to end in the packet) into the given record. Returns false if they're invalid.
+    static bool decodeArgs(const uint8_t *data, size_t pos, size_t end, MCLogRecord &record);
+
+    uint8_t _data[LOG_PACKET_MAX_SIZE];
+    size_t _size;
+    uint8_t _recordCount;
+    uint16_t _sequence;
+
+    // Format id and timestamp of the last record in the packet.
+    uint32_t _lastFormatId;
+    uint32_t _lastTimestamp;
+
+    // Positions of the strings in the packet that later records can refer to.
+    uint16_t _strings[LOG_PACKET_MAX_STRINGS];
+    uint8_t _stringCount;
+};
\ No newline at end of file
@@ -7,5 +7,7 @@ struct MCLoggingSyslogConfiguration {
     std::string ServerAddress;
     uint16_t ServerPort;
     std::string AppName;
+    // Send binary log packets (decoded by tools/log-decoder) instead of syslog lines.
+    bool Binary;
     int mask;
 };
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include "MCBootTimeline.h"
 #include "MattzoMQTTSubscriber.h"
 #include "MattzoWifiClient.h"
 #include "log4MC.h"
@@ -22,7 +23,7 @@ void MattzoMQTTSubscriber::Setup(MCMQTTConfiguration *config, void (*handleMQTTM
     // Setup a queue with a fixed length that will hold pointers to incoming MQTT messages.
     IncomingQueue = xQueueCreate(MQTT_INCOMING_QUEUE_LENGTH, sizeof(char *));
 
-    // Setup MQTT client.
+    // Setup MQTT client (the task loop connects as soon as WiFi is up).
     log4MC::vlogf(LOG_INFO, "MQTT: Connecting to %s:%u...", _config->ServerAddress.c_str(), _config->ServerPort);
     mqttSubscriberClient.setServer(_config->ServerAddress.c_str(), _config->ServerPort);
     mqttSubscriberClient.setKeepAlive(_config->KeepAlive);
@@ -33,6 +34,9 @@ void MattzoMQTTSubscriber::Setup(MCMQTTConfiguration *config, void (*handleMQTTM
     strcpy(_subscriberName, _config->SubscriberName);
     strcat(_subscriberName, "Subscriber");
 
+    // Construct config topic.
+    snprintf(_configTopic, sizeof(_configTopic), "%s%s", MQTT_CONFIG_TOPIC_PREFIX, _config->SubscriberName);
+
     // Start MQTT task loop to handle queued messages.
     xTaskCreatePinnedToCore(handleMQTTMessageLoop, "MQTTHandler", MQTT_TASK_STACK_DEPTH, NULL, MQTT_TASK_PRIORITY, NULL, MQTT_HANDLE_MESSAGE_TASK_COREID);
 
@@ -50,11 +54,14 @@ int MattzoMQTTSubscriber::GetStatus()
 
 void MattzoMQTTSubscriber::mqttCallback(char *topic, byte *payload, unsigned int length)
 {
+    // Config changes are JSON, so they don't pass the filter for Rocrail commands below.
+    bool isConfigMessage = strcmp(topic, _configTopic) == 0;
+
     // Allocate memory to hold the message.
     char *message = (char *)malloc(length + 1);
     for (int i = 0; i < length; i++) {
         message[i] = (char)payload[i];
-        if (i == 4) {
+        if (i == 4 && !isConfigMessage) {
             // Check if this is a message we should ignore.
             if ((strstr(message, "<sys ")) == nullptr &&
                 (strstr(message, "<lc ")) == nullptr &&
@@ -88,41 +95,62 @@ void MattzoMQTTSubscriber::sendMessage(char *topic, const char *message)
 }
 
 /// <summary>
-/// Reconnects the MQTT client to the broker (blocking).
+/// Makes a single attempt to connect the MQTT client to the broker.
 /// </summary>
-void MattzoMQTTSubscriber::reconnect()
+bool MattzoMQTTSubscriber::tryConnect()
 {
-    while (!mqttSubscriberClient.connected()) {
-        // Wait for connection to Wifi (because we need it to connect to the broker).
-        MattzoWifiClient::Assert();
+    _lastConnectAttempt = millis();
 
-        log4MC::info("MQTT: Subscriber configuring last will...");
+    log4MC::info("MQTT: Subscriber configuring last will...");
 
-        String lastWillMessage;
-        // if (_config->EbrakeOnDisconnect)
-        {
-            lastWillMessage = "<sys cmd=\"ebreak\" source=\"lastwill\" mc=\"" + String(_config->SubscriberName) + "\"/>";
-        }
-        // else
-        // {
-        //   lastWillMessage = "<info msg=\"mc_disconnected\" source=\"lastwill\" mc=\"" + String(_config->SubscriberName) + "\"/>";
-        // }
-        char lastWillMessage_char[lastWillMessage.length() + 1];
-        lastWillMessage.toCharArray(lastWillMessage_char, lastWillMessage.length() + 1);
-
-        log4MC::info("MQTT: Subscriber attempting to connect...");
-
-        if (mqttSubscriberClient.connect(_subscriberName, _config->Topic, 0, false, lastWillMessage_char)) {
-            log4MC::info("MQTT: Subscriber connected");
-            mqttSubscriberClient.subscribe(_config->Topic);
-            log4MC::vlogf(LOG_INFO, "MQTT: Subscriber subscribed to topic '%s'", _config->Topic);
-        } else {
-            log4MC::vlogf(LOG_WARNING, "MQTT: Subscriber connect failed, rc=%u. Try again in a few seconds...", mqttSubscriberClient.state());
-
-            // Wait a litte while before retrying.
-            vTaskDelay(ReconnectDelayInMilliseconds / portTICK_PERIOD_MS);
-        }
+    String lastWillMessage;
+    // if (_config->EbrakeOnDisconnect)
+    {
+        lastWillMessage = "<sys cmd=\"ebreak\" source=\"lastwill\" mc=\"" + String(_config->SubscriberName) + "\"/>";
+    }
+    // else
+    // {
+    //   lastWillMessage = "<info msg=\"mc_disconnected\" source=\"lastwill\" mc=\"" + String(_config->SubscriberName) + "\"/>";
+    // }
+    char lastWillMessage_char[lastWillMessage.length() + 1];
+    lastWillMessage.toCharArray(lastWillMessage_char, lastWillMessage.length() + 1);
+
+    log4MC::info("MQTT: Subscriber attempting to connect...");
+
+    if (!mqttSubscriberClient.connect(_subscriberName, _config->Topic, 0, false, lastWillMessage_char)) {
+        log4MC::vlogf(LOG_WARNING, "MQTT: Subscriber connect failed, rc=%u. Try again in a few seconds...", mqttSubscriberClient.state());
+        return false;
     }
+
+    log4MC::info("MQTT: Subscriber connected");
+    mqttSubscriberClient.subscribe(_config->Topic);
+    log4MC::vlogf(LOG_INFO, "MQTT: Subscriber subscribed to topic '%s'", _config->Topic);
+    mqttSubscriberClient.subscribe(_configTopic);
+    log4MC::vlogf(LOG_INFO, "MQTT: Subscriber subscribed to topic '%s'", _configTopic);
+
+    if (!MCBootTimeline::IsPublished()) {
+        MCBootTimeline::Mark("mqtt_connected");
+        publishBootTimeline();
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Publishes the boot timeline (once), so we can see where the cold start time goes.
+/// </summary>
+void MattzoMQTTSubscriber::publishBootTimeline()
+{
+    // Static, as this runs on the (small) stack of the subscriber task, inside the connect calls. Format the timeline right behind the subscriber name.
+    static char message[BOOT_TIMELINE_MESSAGE_SIZE + 64];
+    int prefixLength = snprintf(message, sizeof(message), "%s ", _subscriberName);
+    prefixLength = min(prefixLength, (int)sizeof(message) - 1);
+    char *timeline = message + prefixLength;
+    MCBootTimeline::Format(timeline, sizeof(message) - prefixLength);
+    MCBootTimeline::SetPublished();
+
+    log4MC::vlogf(LOG_INFO, "Boot: %s", timeline);
+    sendMessage("roc2bricks/boot", message);
 }
 
 /// <summary>
@@ -141,9 +169,20 @@ void MattzoMQTTSubscriber::taskLoop(void *parm)
 
         // Loop forever.
         for (;;) {
-            // Wait for connection to MQTT (because we need it to send messages to the broker).
+            // Wait for connection to WiFi (because we need it to connect to the broker), without blocking.
+            if (!MattzoWifiClient::Loop()) {
+                vTaskDelay(HandleMessageDelayInMilliseconds / portTICK_PERIOD_MS);
+                continue;
+            }
+
+            // Wait for connection to MQTT (because we need it to send messages to the broker), retrying every so often.
             if (!mqttSubscriberClient.connected()) {
-                reconnect();
+                if (_lastConnectAttempt == 0 || millis() - _lastConnectAttempt >= ReconnectDelayInMilliseconds) {
+                    tryConnect();
+                }
+
+                vTaskDelay(HandleMessageDelayInMilliseconds / portTICK_PERIOD_MS);
+                continue;
             }
 
             if (_config->Ping > 0 && millis() - lastPing >= _config->Ping * 1000) {
@@ -173,9 +212,11 @@ int MattzoMQTTSubscriber::HandleMessageDelayInMilliseconds = 10;
 uint8_t MattzoMQTTSubscriber::TaskPriority = 2;
 int8_t MattzoMQTTSubscriber::CoreID = 0;
 uint32_t MattzoMQTTSubscriber::StackDepth = 2048;
-uint16_t MattzoMQTTSubscriber::MaxBufferSize = 1024;
+uint16_t MattzoMQTTSubscriber::MaxBufferSize = 4096;
 
 bool MattzoMQTTSubscriber::_setupCompleted = false;
 unsigned long MattzoMQTTSubscriber::lastPing = millis();
+unsigned long MattzoMQTTSubscriber::_lastConnectAttempt = 0;
 char MattzoMQTTSubscriber::_subscriberName[60] = "Unknown";
+char MattzoMQTTSubscriber::_configTopic[80] = "";
 MCMQTTConfiguration *MattzoMQTTSubscriber::_config = nullptr;
\ No newline at end of file
@@ -30,6 +30,12 @@
 
 #define MQTT_UNINITIALIZED -10
 
+// Prefix of the topic on which the controller receives config changes (followed by the controller name).
+#define MQTT_CONFIG_TOPIC_PREFIX "roc2bricks/config/"
+
+// The maximum size of the boot timeline message published once the controller is connected.
+#define BOOT_TIMELINE_MESSAGE_SIZE 384
+
 extern WiFiClient wifiSubscriberClient;
 extern PubSubClient mqttSubscriberClient;
 
@@ -75,7 +81,7 @@ class MattzoMQTTSubscriber
 
     /// <summary>
     /// The maximum message size, including header, specified as the number of bytes.
-    /// Messages larger than this are ignored!
+    /// Messages larger than this are ignored (this includes config changes, which contain a complete loco config)!
     /// </summary>
     static uint16_t MaxBufferSize;
 
@@ -92,11 +98,15 @@ class MattzoMQTTSubscriber
   private:
     static MCMQTTConfiguration *_config;
     static char _subscriberName[60];
+    static char _configTopic[80];
     static bool _setupCompleted;
 
     // Time of the last sent ping.
     static unsigned long lastPing;
 
+    // Time of the last connect attempt.
+    static unsigned long _lastConnectAttempt;
+
     // Callback used to put received message on a queue.
     static void mqttCallback(char *topic, byte *payload, unsigned int length);
 
@@ -107,9 +117,14 @@ class MattzoMQTTSubscriber
     static void sendMessage(char *topic, const char *message);
 
     /// <summary>
-    /// Reconnects the MQTT client to the broker (blocking).
+    /// Makes a single attempt to connect the MQTT client to the broker.
+    /// </summary>
+    static bool tryConnect();
+
+    /// <summary>
+    /// Publishes the boot timeline (once), so we can see where the cold start time goes.
     /// </summary>
-    static void reconnect();
+    static void publishBootTimeline();
 
     /// <summary>
     /// The main (endless) task loop.
@@ -6,6 +6,7 @@
 #endif
 #include <WiFiUdp.h>
 
+#include "MCBootTimeline.h"
 #include "MCFS.h"
 #include "MattzoWifiClient.h"
 #include "log4MC.h"
@@ -41,17 +42,11 @@ void MattzoWifiClient::Setup(MCWiFiConfiguration *config)
     WiFi.setHostname(_config->hostname.c_str());
 #endif
 
-    Serial.print("[" + String(xPortGetCoreID()) + "] Wifi: Connecting to " + _config->SSID.c_str() + ".");
+    Serial.println("[" + String(xPortGetCoreID()) + "] Wifi: Connecting to " + _config->SSID.c_str() + "...");
 
+    // Start connecting in the background. Loop() picks up the connection once it is established.
     WiFi.begin(_config->SSID.c_str(), config->password.c_str());
-
-    // Loop until we actually connect.
-    while (WiFi.status() != WL_CONNECTED) {
-        delay(_config->DailyBetweenConnectAttempsInMs);
-        Serial.print(".");
-    }
-
-    Serial.println();
+    MCBootTimeline::Mark("wifi_begin");
 
     // Setup completed.
     _setupCompleted = true;
@@ -68,46 +63,40 @@ int MattzoWifiClient::GetStatus()
     }
 }
 
-// Blocking call waiting for a WiFi connection. It also handles OTA updates.
-void MattzoWifiClient::Assert()
+// Non-blocking WiFi state machine step. Returns a boolean value indicating whether WiFi is connected. It also handles OTA updates.
+bool MattzoWifiClient::Loop()
 {
     if (!_setupCompleted) {
-        log4MC::error("Wifi: Setup not completed. Execute .Setup() first.");
-        return;
+        return false;
     }
 
     if (WiFi.status() == WL_CONNECTED) {
-        log4MC::wifiIsConnected(true);
-        _wasConnected = true;
+        if (!_wasConnected) {
+            _wasConnected = true;
+            log4MC::wifiIsConnected(true);
+            log4MC::vlogf(LOG_INFO, "Wifi: Connected (IPv4: %s).", WiFi.localIP().toString().c_str());
+            MCBootTimeline::Mark("wifi_connected");
+
+            // Start OTA listener.
+            if (!_otaStarted) {
+                _otaStarted = true;
+                startOTA();
+            }
+        }
 
         // Handle any OTA updates.
         ArduinoOTA.handle();
-        return;
+        return true;
     }
 
-    log4MC::wifiIsConnected(false);
-    
-    // Loop until we reconnect.
-    while (WiFi.status() != WL_CONNECTED) {
-        if (_wasConnected) {
-            _wasConnected = false;
-            log4MC::vlogf(LOG_WARNING, "Wifi: Connection to %s lost. Reconnecting...", _config->SSID.c_str());
-            WiFi.reconnect();
-        }
-
-        // Re-test connection after a small delay.
-        delay(_config->DailyBetweenConnectAttempsInMs);
+    if (_wasConnected) {
+        _wasConnected = false;
+        log4MC::wifiIsConnected(false);
+        log4MC::vlogf(LOG_WARNING, "Wifi: Connection to %s lost. Reconnecting...", _config->SSID.c_str());
+        WiFi.reconnect();
     }
 
-    log4MC::wifiIsConnected(true);
-
-    if (!_wasConnected) {
-        _wasConnected = true;
-        log4MC::vlogf(LOG_INFO, "Wifi: Connected (IPv4: %s).", WiFi.localIP().toString().c_str());
-
-        // Start OTA listener.
-        startOTA();
-    }
+    return false;
 }
 
 void MattzoWifiClient::startOTA()
@@ -161,3 +150,4 @@ MCWiFiConfiguration *MattzoWifiClient::_config;
 bool MattzoWifiClient::_setupInitiated = false;
 bool MattzoWifiClient::_setupCompleted = false;
 bool MattzoWifiClient::_wasConnected = false;
+bool MattzoWifiClient::_otaStarted = false;
@@ -9,14 +9,15 @@
 class MattzoWifiClient
 {
   public:
-    // Setup the WiFi client.
+    // Setup the WiFi client and start connecting in the background (non-blocking).
     static void Setup(MCWiFiConfiguration *config);
 
     // Returns the current WiFi connection status.
     static int GetStatus();
 
-    // Blocking call waiting for a WiFi connection. It also handles OTA updates.
-    static void Assert();
+    // Non-blocking WiFi state machine step (to be used in a loop).
+    // Returns a boolean value indicating whether WiFi is connected. It also handles OTA updates.
+    static bool Loop();
 
   private:
     static void startOTA();
@@ -26,4 +27,5 @@ class MattzoWifiClient
     static bool _setupInitiated;
     static bool _setupCompleted;
     static bool _wasConnected;
+    static bool _otaStarted;
 };
\ No newline at end of file
@@ -35,6 +35,7 @@ MCNetworkConfiguration *loadNetworkConfiguration(const char *configFilePath)
         logging->SysLog->ServerAddress = syslogConfig["server"].as<std::string>();
         logging->SysLog->ServerPort = syslogConfig["port"] | 514;
         logging->SysLog->AppName = syslogConfig["appname"].as<std::string>();
+        logging->SysLog->Binary = strcmp(syslogConfig["format"] | "text", "binary") == 0;
 
         const char *minLevel = loggingConfig["min_level"];
         if (minLevel) {
@@ -16,6 +16,9 @@ void log4MC::Setup(const char *hostName, MCLoggingConfiguration *config)
         Serial.print("Syslog: Appname: ");
         Serial.println(config->SysLog->AppName.c_str());
 
+        Serial.print("Syslog: Format: ");
+        Serial.println(config->SysLog->Binary ? "binary" : "text");
+
         syslog.server(config->SysLog->ServerAddress.c_str(), config->SysLog->ServerPort)
             .deviceHostname(hostName)
             .appName(config->SysLog->AppName.c_str())
@@ -25,9 +28,85 @@ void log4MC::Setup(const char *hostName, MCLoggingConfiguration *config)
         _priMask = config->SysLog->mask;
     }
 
+    // Start writing the messages logged so far (and from now on).
+    xTaskCreatePinnedToCore(taskLoop, "LogWriter", LOG_TASK_STACK_DEPTH, NULL, LOG_TASK_PRIORITY, NULL, 1);
+
     info("Logging: Configured.");
 }
 
+void log4MC::taskLoop(void *parm)
+{
+    MCLogRecord record;
+
+    for (;;) {
+        while (_buffer.Pop(record)) {
+            writeRecord(record);
+        }
+
+        // Send the records collected in this pass in as few packets as possible.
+        if (!_packet.IsEmpty()) {
+            sendPacket();
+        }
+
+        uint32_t droppedCount = _buffer.GetDroppedCount();
+        if (droppedCount != _reportedDroppedCount) {
+            // The buffer has just been emptied, so there's room for the warning (written in the next pass).
+            vlogf(LOG_WARNING, "Logging: Dropped %u messages (log buffer full).", droppedCount - _reportedDroppedCount);
+            _reportedDroppedCount = droppedCount;
+        }
+
+        vTaskDelay(LOG_TASK_DELAY_IN_MS / portTICK_PERIOD_MS);
+    }
+}
+
+void log4MC::writeRecord(const MCLogRecord &record)
+{
+    bool binary = _config->SysLog->Enabled && _config->SysLog->Binary;
+    if (binary) {
+        sendRecord(record);
+
+        if (!_config->Serial->Enabled) {
+            // Nobody reads the formatted message.
+            return;
+        }
+    }
+
+    char message[LOG_MESSAGE_MAX_LENGTH];
+
+#ifdef ESP32
+    size_t len = snprintf(message, sizeof(message), "[%04d] [%d] ", lineNo, record.Core);
+#else
+    size_t len = snprintf(message, sizeof(message), "[%04d] ", lineNo);
+#endif
+    MCLogBuffer::Format(record, message + len, sizeof(message) - len);
+    lineNo = (lineNo + 1) % 10000;
+
+    logMessage(record.Level, message);
+}
+
+void log4MC::sendRecord(const MCLogRecord &record)
+{
+    if (!_connected) {
+        return;
+    }
+
+    if (!_packet.Append(record)) {
+        sendPacket();
+        _packet.Append(record);
+    }
+}
+
+void log4MC::sendPacket()
+{
+    if (_connected) {
+        _udpClient.beginPacket(_config->SysLog->ServerAddress.c_str(), _config->SysLog->ServerPort);
+        _udpClient.write(_packet.GetData(), _packet.GetSize());
+        _udpClient.endPacket();
+    }
+
+    _packet.Clear();
+}
+
 void log4MC::wifiIsConnected(bool connected)
 {
     _connected = connected;
@@ -35,7 +114,7 @@ void log4MC::wifiIsConnected(bool connected)
 
 void log4MC::logMessage(uint8_t level, char *message)
 {
-    if (_connected && _config->SysLog->Enabled) {
+    if (_connected && _config->SysLog->Enabled && !_config->SysLog->Binary) {
         syslog.log(level, message);
     }
 
@@ -57,72 +136,18 @@ uint8_t log4MC::getLogMask()
     return _priMask;
 }
 
-void log4MC::vlogf(uint8_t level, const char *fmt, ...)
+void log4MC::push(uint8_t level, const char *fmt, ...)
 {
-    char *message;
+    // The format string is kept by reference and the arguments are copied, so the message is formatted by the log task.
     va_list args;
-
     va_start(args, fmt);
-
-    size_t initialLen;
-    size_t len;
-
-    initialLen = strlen(fmt);
-
-    message = new char[initialLen + 11];
-    len = vsnprintf(message, initialLen + 1, fmt, args);
-    if (len > initialLen) {
-        delete[] message;
-        message = new char[len + 11];
-        vsnprintf(message, len + 1, fmt, args);
-    }
+    _buffer.Push(level, fmt, args);
     va_end(args);
-
-    log(level, message);
-    delete [] message;
-}
-
-void log4MC::log(uint8_t level, const char *message)
-{
-    char *msg = NULL;
-    unsigned int len = strlen(message);
-    msg = new char[len + 20];
-
-#ifdef ESP32
-    sprintf(msg, "[%04d] [%d] %s", lineNo, xPortGetCoreID(), message);
-    msg[strlen(msg)] = '\0'; // should be paded by zeros, HAVE TO TEST
-#else
-    sprintf(msg, "[%04d] %s", lineNo, message);
-    msg[len] = '\0';
-#endif
-    lineNo = (lineNo +1) % 10000;
-    logMessage(level, msg);
-    delete [] msg;
-}
-
-void log4MC::debug(const char *message)
-{
-    log4MC::log(LOG_DEBUG, message);
-}
-
-void log4MC::info(const char *message)
-{
-    log4MC::log(LOG_INFO, message);
-}
-
-void log4MC::warn(const char *message)
-{
-    log4MC::log(LOG_WARNING, message);
-}
-
-void log4MC::error(const char *message)
-{
-    log4MC::log(LOG_ERR, message);
 }
 
-void log4MC::fatal(const char *message)
+uint32_t log4MC::GetDroppedCount()
 {
-    log4MC::log(LOG_CRIT, message);
+    return _buffer.GetDroppedCount();
 }
 
 // just on string function
@@ -136,4 +161,7 @@ bool log4MC::_connected = false;
 uint8_t log4MC::_priMask = LOG_MASK(LOG_INFO) | LOG_MASK(LOG_DEBUG) | LOG_MASK(LOG_WARNING) | LOG_MASK(LOG_ERR) | LOG_MASK(LOG_CRIT);
 WiFiUDP log4MC::_udpClient;
 Syslog log4MC::syslog(_udpClient, SYSLOG_PROTO_IETF);
-unsigned int log4MC::lineNo = 0;
\ No newline at end of file
+unsigned int log4MC::lineNo = 0;
+MCLogBuffer log4MC::_buffer;
+MCLogPacket log4MC::_packet;
+uint32_t log4MC::_reportedDroppedCount = 0;
\ No newline at end of file
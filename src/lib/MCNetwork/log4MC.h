@@ -4,8 +4,31 @@
 #include <Syslog.h>  // Syslog library.
 #include <WiFiUdp.h> // UDP library required for Syslog.
 
+#include "MCLogBuffer.h"
+#include "MCLogPacket.h"
 #include "MCLoggingConfiguration.h"
 
+// Max. length of a formatted log line (longer lines are truncated).
+#define LOG_MESSAGE_MAX_LENGTH 256
+
+// The priority at which the log task writes the logged messages (low, so logging doesn't delay other work).
+#define LOG_TASK_PRIORITY 1
+
+// The size of the log task stack specified as the number of bytes.
+#define LOG_TASK_STACK_DEPTH 4096
+
+// Time the log task waits before checking the log buffer again, once it's empty.
+#define LOG_TASK_DELAY_IN_MS 20
+
+// Least severe level that is compiled into the firmware (LOG_EMERG..LOG_DEBUG). Log calls of less severe levels are
+// removed by the compiler, format strings included. Set it with a build flag, e.g. -DMC_LOG_MIN_LEVEL=LOG_INFO.
+#ifndef MC_LOG_MIN_LEVEL
+#define MC_LOG_MIN_LEVEL LOG_DEBUG
+#endif
+
+// Forces inlining of the log calls, even when optimizing for size, so the compiler sees the (constant) level at the call site.
+#define LOG_ALWAYS_INLINE inline __attribute__((always_inline))
+
 #ifdef MC_DEBUG
 #define MC_LOG_DEBUG(...) log4MC::vlogf(LOG_DEBUG, __VA_ARGS__)
 #else
@@ -18,22 +41,54 @@
 #define MC_LOG_INFO(...)
 #endif
 
+// Logger. Log calls only copy the message and its arguments into a lock-free buffer, so they are cheap and never block the calling task.
+// A low priority task formats the messages and writes them to Serial and syslog, or sends them to syslog unformatted in binary log packets.
+// Levels are checked before anything is copied, so a filtered message costs a compare (or nothing, below MC_LOG_MIN_LEVEL).
 class log4MC
 {
   public:
-    // Setup the logger.
+    // Setup the logger and start the log task.
     static void Setup(const char *hostName, MCLoggingConfiguration *config);
     static void wifiIsConnected(bool connected);
-    static void vlogf(uint8_t level, const char *fmt, ...);
-    static void log(uint8_t level, const char *message);
-    static void debug(const char *message);
-    static void info(const char *message);
+
+    // Logs a printf-style message. Always inlined, so a filtered call costs a single test and calls below MC_LOG_MIN_LEVEL compile to nothing.
+    template <typename... Args>
+    LOG_ALWAYS_INLINE static void vlogf(uint8_t level, const char *fmt, Args... args)
+    {
+        if (isEnabled(level)) {
+            push(level, fmt, args...);
+        }
+    }
+
+    LOG_ALWAYS_INLINE static void log(uint8_t level, const char *message)
+    {
+        // The message may not outlive this call, so it's copied as an argument.
+        vlogf(level, "%s", message);
+    }
+
+    LOG_ALWAYS_INLINE static void debug(const char *message) { log(LOG_DEBUG, message); }
+    LOG_ALWAYS_INLINE static void info(const char *message) { log(LOG_INFO, message); }
     static void info(String message);
-    static void warn(const char *message);
-    static void error(const char *message);
-    static void fatal(const char *message);
+    LOG_ALWAYS_INLINE static void warn(const char *message) { log(LOG_WARNING, message); }
+    LOG_ALWAYS_INLINE static void error(const char *message) { log(LOG_ERR, message); }
+    LOG_ALWAYS_INLINE static void fatal(const char *message) { log(LOG_CRIT, message); }
+
+    // Returns the number of messages dropped since startup, because the log buffer was full.
+    static uint32_t GetDroppedCount();
 
   private:
+    // Returns a boolean value indicating whether messages of the given level are logged.
+    LOG_ALWAYS_INLINE static bool isEnabled(uint8_t level)
+    {
+        return level <= MC_LOG_MIN_LEVEL && (LOG_MASK(level) & _priMask);
+    }
+
+    // Copies the message into the log buffer.
+    static void push(uint8_t level, const char *fmt, ...);
+    static void taskLoop(void *parm);
+    static void writeRecord(const MCLogRecord &record);
+    static void sendRecord(const MCLogRecord &record);
+    static void sendPacket();
     static void logMessage(uint8_t level, char *message);
     static void setLogMask(uint8_t priMask);
     static uint8_t getLogMask();
@@ -44,4 +99,7 @@ class log4MC
     static WiFiUDP _udpClient;
     static Syslog syslog;
     static unsigned int lineNo;
+    static MCLogBuffer _buffer;
+    static MCLogPacket _packet;
+    static uint32_t _reportedDroppedCount;
 };
@@ -0,0 +1,62 @@
+#include "MCBinaryReader.h"
+
+MCBinaryReader::MCBinaryReader(const uint8_t *buffer, size_t size)
+    : _buffer{buffer}, _size{size}, _position{0}, _failed{false} {}
+
+uint8_t MCBinaryReader::ReadUInt8()
+{
+    const uint8_t *bytes = ReadBytes(1);
+    return bytes ? bytes[0] : 0;
+}
+
+uint16_t MCBinaryReader::ReadUInt16()
+{
+    const uint8_t *bytes = ReadBytes(2);
+    return bytes ? bytes[0] | (bytes[1] << 8) : 0;
+}
+
+uint32_t MCBinaryReader::ReadUInt32()
+{
+    uint32_t low = ReadUInt16();
+    uint32_t high = ReadUInt16();
+    return low | (high << 16);
+}
+
+int16_t MCBinaryReader::ReadInt16()
+{
+    return (int16_t)ReadUInt16();
+}
+
+bool MCBinaryReader::ReadBool()
+{
+    return ReadUInt8() != 0;
+}
+
+std::string MCBinaryReader::ReadString()
+{
+    uint16_t length = ReadUInt16();
+    const uint8_t *bytes = ReadBytes(length);
+    return bytes ? std::string((const char *)bytes, length) : std::string();
+}
+
+const uint8_t *MCBinaryReader::ReadBytes(size_t count)
+{
+    if (_failed || count > _size - _position) {
+        _failed = true;
+        return nullptr;
+    }
+
+    const uint8_t *bytes = _buffer + _position;
+    _position += count;
+    return bytes;
+}
+
+bool MCBinaryReader::Failed()
+{
+    return _failed;
+}
+
+bool MCBinaryReader::AtEnd()
+{
+    return _position == _size;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Arduino.h>
+#include <string>
+
+// Reads values in the packed, little-endian binary format written by MCBinaryWriter from a buffer.
+// Reading beyond the end of the buffer returns zero values and marks the reader as failed.
+class MCBinaryReader
+{
+  public:
+    MCBinaryReader(const uint8_t *buffer, size_t size);
+
+    uint8_t ReadUInt8();
+    uint16_t ReadUInt16();
+    uint32_t ReadUInt32();
+    int16_t ReadInt16();
+    bool ReadBool();
+
+    // Reads a string prefixed with its length.
+    std::string ReadString();
+
+    // Returns a pointer to the given number of bytes at the current position and skips them (nullptr if there aren't enough bytes left).
+    const uint8_t *ReadBytes(size_t count);
+
+    // Returns a boolean value indicating whether we tried to read beyond the end of the buffer.
+    bool Failed();
+
+    // Returns a boolean value indicating whether the whole buffer has been read.
+    bool AtEnd();
+
+  private:
+    const uint8_t *_buffer;
+    size_t _size;
+    size_t _position;
+    bool _failed;
+};
\ No newline at end of file
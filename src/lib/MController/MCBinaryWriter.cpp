@@ -0,0 +1,46 @@
+#include "MCBinaryWriter.h"
+
+MCBinaryWriter::MCBinaryWriter() {}
+
+void MCBinaryWriter::WriteUInt8(uint8_t value)
+{
+    _buffer.push_back(value);
+}
+
+void MCBinaryWriter::WriteUInt16(uint16_t value)
+{
+    _buffer.push_back(value & 0xFF);
+    _buffer.push_back(value >> 8);
+}
+
+void MCBinaryWriter::WriteUInt32(uint32_t value)
+{
+    WriteUInt16(value & 0xFFFF);
+    WriteUInt16(value >> 16);
+}
+
+void MCBinaryWriter::WriteInt16(int16_t value)
+{
+    WriteUInt16((uint16_t)value);
+}
+
+void MCBinaryWriter::WriteBool(bool value)
+{
+    WriteUInt8(value ? 1 : 0);
+}
+
+void MCBinaryWriter::WriteString(const std::string &value)
+{
+    WriteUInt16(value.size());
+    _buffer.insert(_buffer.end(), value.begin(), value.end());
+}
+
+void MCBinaryWriter::WriteBytes(const uint8_t *bytes, size_t count)
+{
+    _buffer.insert(_buffer.end(), bytes, bytes + count);
+}
+
+const std::vector<uint8_t> &MCBinaryWriter::GetBuffer()
+{
+    return _buffer;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+
+// Writes values in a packed, little-endian binary format into a growing buffer.
+class MCBinaryWriter
+{
+  public:
+    MCBinaryWriter();
+
+    void WriteUInt8(uint8_t value);
+    void WriteUInt16(uint16_t value);
+    void WriteUInt32(uint32_t value);
+    void WriteInt16(int16_t value);
+    void WriteBool(bool value);
+
+    // Writes the string prefixed with its length.
+    void WriteString(const std::string &value);
+
+    // Writes the given bytes as is.
+    void WriteBytes(const uint8_t *bytes, size_t count);
+
+    // Returns the written bytes.
+    const std::vector<uint8_t> &GetBuffer();
+
+  private:
+    std::vector<uint8_t> _buffer;
+};
\ No newline at end of file
@@ -2,7 +2,11 @@
 #include "log4MC.h"
 
 MCChannel::MCChannel(ChannelType portType, std::string address)
-    : _portType{portType}, _address{address} {}
+    : _portType{portType}, _address{address}
+{
+    // ESP pin numbers can be resolved right away, other channel types are resolved by the controller that knows them.
+    _resolvedAddress = portType == ChannelType::EspPinChannel ? atoi(address.c_str()) : 0;
+}
 
 ChannelType MCChannel::GetChannelType()
 {
@@ -20,7 +24,17 @@ int MCChannel::GetAddressAsEspPinNumber()
         log4MC::error("Trying to retrieve an ESP pin number from a non ESP pin channel.");
     }
 
-    return atoi(_address.c_str());
+    return _resolvedAddress;
+}
+
+int MCChannel::GetResolvedAddress()
+{
+    return _resolvedAddress;
+}
+
+void MCChannel::SetResolvedAddress(int resolvedAddress)
+{
+    _resolvedAddress = resolvedAddress;
 }
 
 std::string MCChannel::GetParentAddress()
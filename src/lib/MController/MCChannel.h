@@ -17,6 +17,12 @@ class MCChannel
     // Returns the channel's address interpreted as an ESP pin number.
     int GetAddressAsEspPinNumber();
 
+    // Returns the channel's address resolved to a number when loading the config (ESP pin number or hub channel).
+    int GetResolvedAddress();
+
+    // Sets the channel's address resolved to a number (for channel types whose addresses the controller can't resolve itself).
+    void SetResolvedAddress(int resolvedAddress);
+
     // Gets the parent hub/receiver address.
     std::string GetParentAddress();
 
@@ -30,6 +36,9 @@ class MCChannel
     // Can be hub/receiver channel or ESP pin number.
     std::string _address;
 
+    // Address resolved to a number, so the runtime doesn't need to parse the address.
+    int _resolvedAddress;
+
     // Can be hub/receiver address.
     std::string _parentAddress;
 };
\ No newline at end of file
@@ -2,8 +2,13 @@
 
 #include "MCChannelConfig.h"
 
-MCChannelConfig::MCChannelConfig(MCChannel *channel, int pwrIncStep, int pwrDecStep, bool isInverted, DeviceType deviceType)
-    : _channel{channel}, _pwrIncStep{pwrIncStep}, _pwrDecStep{pwrDecStep}, _isInverted{isInverted}, _deviceType{deviceType} {}
+MCChannelConfig::MCChannelConfig(MCChannel *channel, int pwrIncRate, int pwrDecRate, int pwrJerk, MCSpeedCurve *speedCurve, bool isInverted, DeviceType deviceType)
+    : _channel{channel}, _pwrIncRate{pwrIncRate}, _pwrDecRate{pwrDecRate}, _pwrJerk{pwrJerk}, _speedCurve{speedCurve}, _isInverted{isInverted}, _deviceType{deviceType} {}
+
+MCChannelConfig::~MCChannelConfig()
+{
+    delete _channel;
+}
 
 MCChannel *MCChannelConfig::GetChannel()
 {
@@ -15,14 +20,24 @@ bool MCChannelConfig::IsInverted()
     return _isInverted;
 }
 
-int MCChannelConfig::GetPwrIncStep()
+int MCChannelConfig::GetPwrIncRate()
+{
+    return _pwrIncRate;
+}
+
+int MCChannelConfig::GetPwrDecRate()
+{
+    return _pwrDecRate;
+}
+
+int MCChannelConfig::GetPwrJerk()
 {
-    return _pwrIncStep;
+    return _pwrJerk;
 }
 
-int MCChannelConfig::GetPwrDecStep()
+MCSpeedCurve *MCChannelConfig::GetSpeedCurve()
 {
-    return _pwrDecStep;
+    return _speedCurve;
 }
 
 DeviceType MCChannelConfig::GetAttachedDeviceType()
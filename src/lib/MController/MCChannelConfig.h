@@ -1,13 +1,21 @@
 #pragma once
 
 #include "MCChannel.h"
+#include "MCSpeedCurve.h"
 #include "enums.h"
 
+// Number of power steps per second the drive loops used to apply, before ramping was based on elapsed time.
+// Used to convert the legacy 'pwrIncStep'/'pwrDecStep' settings into rates.
+#define LEGACY_PWR_STEPS_PER_SECOND 4
+
 // Controller channel config
 class MCChannelConfig
 {
   public:
-    MCChannelConfig(MCChannel *channel, int pwrIncStep, int pwrDecStep, bool isInverted, DeviceType deviceType);
+    MCChannelConfig(MCChannel *channel, int pwrIncRate, int pwrDecRate, int pwrJerk, MCSpeedCurve *speedCurve, bool isInverted, DeviceType deviceType);
+
+    // Deletes the channel. The speed curve may be shared by several channels, so it's deleted by whoever owns the channels (e.g. the loco config).
+    ~MCChannelConfig();
 
     // Returns the channel.
     MCChannel *GetChannel();
@@ -15,11 +23,17 @@ class MCChannelConfig
     // Returns a boolean value indicating whether the attached device' polarity is inverted.
     bool IsInverted();
 
-    // Returns the power step used when increasing power on the channel.
-    int GetPwrIncStep();
+    // Returns the rate (in %/s) used when increasing power on the channel.
+    int GetPwrIncRate();
+
+    // Returns the rate (in %/s) used when decreasing power on the channel.
+    int GetPwrDecRate();
 
-    // Returns the power step used when decreasing power on the channel.
-    int GetPwrDecStep();
+    // Returns the max. change of the power rate (in %/s²) used for S-curve ramping (0 = linear ramping).
+    int GetPwrJerk();
+
+    // Returns the speed curve used to map pwr percentages to motor pwr (nullptr = linear).
+    MCSpeedCurve *GetSpeedCurve();
 
     // Returns the type of device attached to the channel.
     DeviceType GetAttachedDeviceType();
@@ -28,11 +42,17 @@ class MCChannelConfig
     // Type of port.
     MCChannel *_channel;
 
-    // Power step to use when increasing power on the channel.
-    int _pwrIncStep;
+    // Rate (in %/s) to use when increasing power on the channel.
+    int _pwrIncRate;
+
+    // Rate (in %/s) to use when decreasing power on the channel.
+    int _pwrDecRate;
+
+    // Max. change of the power rate (in %/s²) to use for S-curve ramping (0 = linear ramping).
+    int _pwrJerk;
 
-    // Power step to use when decreasing power on the channel.
-    int _pwrDecStep;
+    // Speed curve used to map pwr percentages to motor pwr (nullptr = linear).
+    MCSpeedCurve *_speedCurve;
 
     // Boolean value indicating whether the attached device' polarity is inverted.
     bool _isInverted;
@@ -17,6 +17,8 @@ MCChannelController::MCChannelController(MCChannelConfig *config)
     _minPwrPerc = 0;
     _targetPwrPerc = 0;
     _currentPwrPerc = 0;
+    _currentPwr = 0;
+    _currentRate = 0;
 }
 
 HubLedColor MCChannelController::GetHubLedColor()
@@ -85,56 +87,82 @@ int16_t MCChannelController::GetCurrentPwrPerc()
 void MCChannelController::SetCurrentPwrPerc(int16_t currentPwrPerc)
 {
     _currentPwrPerc = normalizePwrPerc(currentPwrPerc);
+    _currentPwr = _currentPwrPerc;
+    _currentRate = 0;
+}
+
+float MCChannelController::GetCurrentRate()
+{
+    return _currentRate;
 }
 
 bool MCChannelController::UpdateCurrentPwrPerc()
 {
-    unsigned long timeStamp = millis();
+    // Determine the time elapsed since the last update (unsigned arithmetic keeps this correct when micros() wraps around).
+    unsigned long timeStamp = micros();
+    float elapsedInSeconds = _lastUpdate == 0 ? 0 : (timeStamp - _lastUpdate) / 1000000.0f;
+
+    // Update timestamp of last update.
+    _lastUpdate = timeStamp;
 
     if (_ebrake || _mbrake)
     {
         // Update of current pwr required (directly to zero), if we're e-braking.
+        _currentRate = 0;
         return true;
     }
 
-    // Update timestamp of last update.
-    _lastUpdate = timeStamp;
-
     if (isAtTargetPwrPerc()) {
         // No need to update current pwr, if we've already reached target pwr.
+        _currentRate = 0;
         return false;
     }
 
-    int16_t dirMultiplier = _targetPwrPerc > _currentPwrPerc ? 1 : -1;
-    int16_t pwrStep = (isAccelarating() ? _config->GetPwrIncStep() : _config->GetPwrDecStep()) * dirMultiplier;
-
-    if (!isAccelarating() && abs(pwrStep) > abs(_currentPwrPerc)) {
-        // We can't switch from one drive direction to the other directly. Enforce stop first.
-        _currentPwrPerc = 0;
-        return true;
-    }
-
-    // Adjust pwr with one step.
-    int16_t newPwrPerc = _currentPwrPerc + pwrStep;
-
-    // We are not allowed to go beyond the set target pwr. Enforce target pwr, if we would.
-    if ((_targetPwrPerc < 0 && newPwrPerc < _targetPwrPerc && newPwrPerc < _currentPwrPerc) ||
-        (_targetPwrPerc >= 0 && newPwrPerc > _targetPwrPerc && newPwrPerc > _currentPwrPerc) ||
-        (_targetPwrPerc < 0 && newPwrPerc > _targetPwrPerc && newPwrPerc > _currentPwrPerc) ||
-        (_targetPwrPerc >= 0 && newPwrPerc < _targetPwrPerc && newPwrPerc < _currentPwrPerc)) {
-        _currentPwrPerc = _targetPwrPerc;
-        return true;
+    // We can't switch from one drive direction to the other directly. Enforce stop first.
+    float goal = _currentPwr * _targetPwrPerc < 0 ? 0 : _targetPwrPerc;
+    float distance = fabsf(goal - _currentPwr);
+
+    float rate = isAccelarating() ? _config->GetPwrIncRate() : _config->GetPwrDecRate();
+    int jerk = _config->GetPwrJerk();
+    float newPwr;
+
+    if (jerk > 0) {
+        // S-curve: the (signed) rate changes by no more than the max. jerk, and drops in time to arrive at the goal with a rate of zero.
+        float direction = goal > _currentPwr ? 1 : -1;
+        float maxRateChange = jerk * elapsedInSeconds;
+
+        if (fabsf(_currentRate) <= maxRateChange && distance <= maxRateChange * elapsedInSeconds) {
+            // Close enough to the goal to stop at it within the max. jerk.
+            newPwr = goal;
+            _currentRate = 0;
+        } else {
+            // Highest rate at the end of this update from which we can still stop at the goal, lowering the rate by the max. jerk:
+            // solves newRate^2 = 2 * jerk * (distance - (currentRate + newRate) / 2 * elapsed) for newRate.
+            float stopDiscriminant = maxRateChange * maxRateChange + 8.0f * jerk * distance - 4.0f * maxRateChange * _currentRate * direction;
+            float stopRate = (sqrtf(max(stopDiscriminant, 0.0f)) - maxRateChange) / 2;
+
+            float newRate = direction * min(rate, stopRate);
+            newRate = constrain(newRate, _currentRate - maxRateChange, _currentRate + maxRateChange);
+
+            // The rate changed linearly during the elapsed time, so we moved with the average rate.
+            // If the ramp changed direction (or the goal was lowered while ramping up fast), the rate ramps through zero first, so we pass the goal and come back, rather than stopping at once.
+            newPwr = _currentPwr + (_currentRate + newRate) / 2 * elapsedInSeconds;
+            _currentRate = newRate;
+        }
+    } else {
+        float pwrStep = rate * elapsedInSeconds;
+        newPwr = pwrStep >= distance ? goal : _currentPwr + (goal > _currentPwr ? pwrStep : -pwrStep);
     }
 
-    if (abs(newPwrPerc) < _minPwrPerc) {
+    if (newPwr != goal && fabsf(newPwr) < _minPwrPerc) {
         // New pwr is slower than min pwr, force to min pwr or stop immediately (dependend on wether we're accelarating or decelerating).
-        dirMultiplier = newPwrPerc >= 0 ? 1 : -1;
-        _currentPwrPerc = isAccelarating() ? _minPwrPerc * dirMultiplier : 0;
-        return true;
+        int16_t dirMultiplier = _targetPwrPerc >= 0 ? 1 : -1;
+        newPwr = isAccelarating() ? _minPwrPerc * dirMultiplier : 0;
     }
 
-    // We haven't reached the target pwr yet.
-    _currentPwrPerc = normalizePwrPerc(newPwrPerc);
+    newPwr = constrain(newPwr, MIN_PWR_PERC, MAX_PWR_PERC);
+    _currentPwr = newPwr;
+    _currentPwrPerc = normalizePwrPerc(lroundf(newPwr));
     return true;
 }
 
@@ -158,6 +186,11 @@ void MCChannelController::EmergencyBrake(bool enabled)
     _ebrake = enabled;
 }
 
+void MCChannelController::SetConfig(MCChannelConfig *config)
+{
+    _config = config;
+}
+
 bool MCChannelController::isAccelarating()
 {
     // Current pwr equals target pwr.
@@ -166,18 +199,18 @@ bool MCChannelController::isAccelarating()
     }
 
     // Current pwr and target pwr in opposite directions means we must be decelerating first.
-    if (_currentPwrPerc * _targetPwrPerc < 0) {
+    if (_currentPwr * _targetPwrPerc < 0) {
         return false;
     }
 
     // Current pwr and target pwr in same direction.
     // Accelerating if target pwr greater than current pwr, else decelerating.
-    return abs(_targetPwrPerc) > abs(_currentPwrPerc);
+    return abs(_targetPwrPerc) > fabsf(_currentPwr);
 }
 
 bool MCChannelController::isAtTargetPwrPerc()
 {
-    return _currentPwrPerc == _targetPwrPerc;
+    return _currentPwr == _targetPwrPerc;
 }
 
 int16_t MCChannelController::normalizePwrPerc(int16_t pwrPerc)
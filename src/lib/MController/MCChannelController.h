@@ -37,7 +37,10 @@ class MCChannelController
     // Sets the current pwr percentage (directly) to the specified value (sign indicates direction: >0: forward, <0: backwards).
     void SetCurrentPwrPerc(int16_t currentPwrPerc);
 
-    // Updates the current pwr percentage one step towards the target pwr (to be used in a loop).
+    // Returns the current ramp rate (in %/s, sign indicates direction: >0: increasing pwr, <0: decreasing pwr).
+    float GetCurrentRate();
+
+    // Updates the current pwr percentage towards the target pwr, based on the time elapsed since the previous update (to be used in a loop).
     bool UpdateCurrentPwrPerc();
 
     // Returns the absolute current pwr percentage (no direction indication).
@@ -54,6 +57,9 @@ class MCChannelController
     // Sets the current e-brake status.
     void EmergencyBrake(bool enabled);
 
+    // Replaces the configuration of the channel (when the config is reloaded), keeping its current state.
+    void SetConfig(MCChannelConfig *config);
+
   private:
     // Returns a boolean value indicating whether the channel is currently accelarating in either direction.
     bool isAccelarating();
@@ -74,6 +80,10 @@ class MCChannelController
     int16_t _minPwrPerc;
     int16_t _targetPwrPerc;
     int16_t _currentPwrPerc;
+
+    // Current pwr percentage and ramp rate (in %/s), without rounding, so ramps don't depend on how often we're updated.
+    float _currentPwr;
+    float _currentRate;
     HubLedColor _hubLedColor = HubLedColor::BLACK; // off
 
     // The following (derived) class can access private members of MCChannelController.
@@ -4,6 +4,9 @@
 #include <Arduino.h>
 #include <vector>
 
+// Max. number of ESP pins, as there are only 16 LEDC (PWM) channels to drive them.
+#define MAX_ESP_PIN_COUNT 16
+
 struct MCConfiguration
 {
 public:
@@ -1,22 +1,23 @@
 #include "MCJsonConfig.h"
+#include "log4MC.h"
 
 DynamicJsonDocument MCJsonConfig::ReadJsonFile(const char *jsonFilePath)
 {
-    // Allocate a temporary JsonDocument.
-    // Don't forget to change the capacity to match your requirements!
-    // Use https://arduinojson.org/v6/assistant to compute the capacity.
-    // Use the settings:
-    // - Processor: ESP32
-    // - Mode: Deserialize
-    // - Input type: Stream
-    // Including some slack (1024) in case the strings change, and rounded to a power of two.
-    DynamicJsonDocument doc(4096);
+    return readJsonFile(jsonFilePath, nullptr);
+}
 
+DynamicJsonDocument MCJsonConfig::ReadJsonFile(const char *jsonFilePath, JsonDocument &filter)
+{
+    return readJsonFile(jsonFilePath, &filter);
+}
+
+DynamicJsonDocument MCJsonConfig::readJsonFile(const char *jsonFilePath, JsonDocument *filter)
+{
     // Check if file exists.
     File file = SPIFFS.open(jsonFilePath);
     if (!file) {
         Serial.println("Config: Failed to open file for reading");
-        return doc;
+        return DynamicJsonDocument(0);
     }
 
     // Check if file is empty.
@@ -24,18 +25,241 @@ DynamicJsonDocument MCJsonConfig::ReadJsonFile(const char *jsonFilePath)
     if (!size) {
         file.close();
         Serial.println("Config: File is empty");
-        return doc;
+        return DynamicJsonDocument(0);
     }
 
     // Deserialize the JSON document.
-    DeserializationError error = deserializeJson(doc, file);
-    if (error) {
-        Serial.print(F("Config: Failed to read config file: deserializeJson() failed with code "));
-        Serial.println(error.c_str());
-    }
+    DynamicJsonDocument doc = deserializeJsonFile(file, filter);
 
     // Close the file.
     file.close();
 
     return doc;
+}
+
+uint MCJsonConfig::ReadJsonArray(const char *jsonFilePath, const char *arrayKey, std::function<void(JsonObject)> callback)
+{
+    File file = SPIFFS.open(jsonFilePath);
+    if (!file) {
+        Serial.println("Config: Failed to open file for reading");
+        return 0;
+    }
+
+    // Skip to the start of the array.
+    if (!seekTopLevelArray(file, arrayKey)) {
+        file.close();
+        return 0;
+    }
+
+    uint count = 0;
+    for (;;) {
+        // Skip whitespace, so we can detect the end of an (empty) array.
+        skipWhitespace(file);
+        if (file.peek() == ']') {
+            break;
+        }
+
+        DynamicJsonDocument doc = deserializeJsonFile(file, nullptr);
+        if (doc.isNull()) {
+            break;
+        }
+
+        callback(doc.as<JsonObject>());
+        count++;
+
+        // Elements are separated by a comma, anything else ends the array.
+        skipWhitespace(file);
+        if (file.read() != ',') {
+            break;
+        }
+    }
+
+    file.close();
+    return count;
+}
+
+bool MCJsonConfig::seekTopLevelArray(File &file, const char *key)
+{
+    size_t keyLength = strlen(key);
+    int depth = 0;
+    int c;
+
+    while ((c = file.read()) >= 0) {
+        switch (c) {
+        case '"': {
+            // Read the string, matching it against the key if it's in the top-level object.
+            bool matches = depth == 1;
+            size_t length = 0;
+
+            while ((c = file.read()) >= 0 && c != '"') {
+                if (c == '\\') {
+                    // Escaped character (keys we look for don't contain any).
+                    file.read();
+                    matches = false;
+                    continue;
+                }
+
+                matches = matches && length < keyLength && c == key[length];
+                length++;
+            }
+
+            if (c < 0) {
+                return false;
+            }
+
+            if (matches && length == keyLength) {
+                // The string is the key if it's followed by a colon (and not a value that happens to be equal to it).
+                skipWhitespace(file);
+                if (file.peek() == ':') {
+                    file.read();
+                    skipWhitespace(file);
+                    return file.read() == '[';
+                }
+            }
+            break;
+        }
+        case '/':
+            // Comment.
+            skipComment(file);
+            break;
+        case '{':
+        case '[':
+            depth++;
+            break;
+        case '}':
+        case ']':
+            depth--;
+            break;
+        }
+    }
+
+    return false;
+}
+
+void MCJsonConfig::skipWhitespace(File &file)
+{
+    for (;;) {
+        int c = file.peek();
+        if (isspace(c)) {
+            file.read();
+        } else if (c == '/') {
+            file.read();
+            skipComment(file);
+        } else {
+            return;
+        }
+    }
+}
+
+void MCJsonConfig::skipComment(File &file)
+{
+    int c = file.read();
+    if (c == '/') {
+        // Line comment.
+        while ((c = file.read()) >= 0 && c != '\n') {
+        }
+    } else if (c == '*') {
+        // Block comment.
+        int previous = 0;
+        while ((c = file.read()) >= 0 && !(previous == '*' && c == '/')) {
+            previous = c;
+        }
+    }
+}
+
+DynamicJsonDocument MCJsonConfig::deserializeJsonFile(File &file, JsonDocument *filter)
+{
+    size_t start = file.position();
+
+    for (size_t capacity = JSON_DOCUMENT_INITIAL_SIZE;; capacity *= 2) {
+        DynamicJsonDocument doc(capacity);
+
+        // Deserialize the JSON document.
+        file.seek(start);
+        DeserializationError error = filter ? deserializeJson(doc, file, DeserializationOption::Filter(*filter)) : deserializeJson(doc, file);
+
+        if (error == DeserializationError::NoMemory && capacity < JSON_DOCUMENT_MAX_SIZE) {
+            // Document too small, try again with a bigger one.
+            continue;
+        }
+
+        if (error) {
+            Serial.print(F("Config: Failed to read config file: deserializeJson() failed with code "));
+            Serial.println(error.c_str());
+            doc.clear();
+        }
+
+        // Release the capacity we didn't need.
+        doc.shrinkToFit();
+        return doc;
+    }
+}
+
+DynamicJsonDocument MCJsonConfig::ParseJson(const char *json)
+{
+    for (size_t capacity = JSON_DOCUMENT_INITIAL_SIZE;; capacity *= 2) {
+        DynamicJsonDocument doc(capacity);
+
+        DeserializationError error = deserializeJson(doc, json);
+
+        if (error == DeserializationError::NoMemory && capacity < JSON_DOCUMENT_MAX_SIZE) {
+            // Document too small, try again with a bigger one.
+            continue;
+        }
+
+        if (error) {
+            log4MC::vlogf(LOG_WARNING, "Config: Failed to parse JSON: deserializeJson() failed with code %s", error.c_str());
+            doc.clear();
+        }
+
+        // Release the capacity we didn't need.
+        doc.shrinkToFit();
+        return doc;
+    }
+}
+
+int16_t MCJsonConfig::ReadPwrRate(JsonObject config, const char *rateKey, const char *stepKey, int16_t defaultRate)
+{
+    if (config.containsKey(rateKey)) {
+        return config[rateKey];
+    }
+
+    if (config.containsKey(stepKey)) {
+        return config[stepKey].as<int16_t>() * LEGACY_PWR_STEPS_PER_SECOND;
+    }
+
+    return defaultRate;
+}
+
+MCSpeedCurve *MCJsonConfig::ReadSpeedCurve(JsonObject config, MCSpeedCurve *defaultCurve)
+{
+    if (!config.containsKey("speedCurve")) {
+        return defaultCurve;
+    }
+
+    JsonObject curveConfig = config["speedCurve"];
+    uint8_t minPwrPerc = curveConfig["minPwrPerc"] | 0;
+    uint8_t maxPwrPerc = curveConfig["maxPwrPerc"] | 100;
+
+    std::vector<MCSpeedCurvePoint> kneePoints;
+    JsonArray kneeConfigs = curveConfig["knees"].as<JsonArray>();
+    for (JsonObject kneeConfig : kneeConfigs) {
+        kneePoints.push_back({kneeConfig["speedPerc"].as<uint8_t>(), kneeConfig["pwrPerc"].as<uint8_t>()});
+    }
+
+    return new MCSpeedCurve(minPwrPerc, kneePoints, maxPwrPerc);
+}
+
+MCSpeedControlConfig *MCJsonConfig::ReadSpeedControl(JsonObject config, MCSpeedControlConfig *defaultConfig)
+{
+    if (!config.containsKey("speedControl")) {
+        return defaultConfig;
+    }
+
+    // Gains are configured as decimals, but the controller uses fixed-point gains.
+    JsonObject controlConfig = config["speedControl"];
+    float kp = controlConfig["kp"] | 0.0f;
+    float ki = controlConfig["ki"] | 0.0f;
+
+    return new MCSpeedControlConfig{(int16_t)lroundf(kp * (1 << SPEED_CONTROL_FIXED_POINT_BITS)), (int16_t)lroundf(ki * (1 << SPEED_CONTROL_FIXED_POINT_BITS))};
 }
\ No newline at end of file
@@ -2,10 +2,58 @@
 
 #include <ArduinoJson.h>
 #include <SPIFFS.h>
+#include <functional>
+
+#include "MCChannelConfig.h"
+#include "MCSpeedController.h"
+
+// Initial capacity of the documents used to read (parts of) config files. Doubled until the JSON fits.
+#define JSON_DOCUMENT_INITIAL_SIZE 1024
+
+// Max. capacity of the documents used to read (parts of) config files.
+#define JSON_DOCUMENT_MAX_SIZE 32768
 
 class MCJsonConfig
 {
   public:
-    // Reads a JSON document of max. 4k.
+    // Reads a JSON document into a document that grows until the JSON fits (max. 32k).
     static DynamicJsonDocument ReadJsonFile(const char *jsonFilePath);
+
+    // Reads a JSON document into a document that grows until the JSON fits (max. 32k), keeping only the fields in the given filter.
+    static DynamicJsonDocument ReadJsonFile(const char *jsonFilePath, JsonDocument &filter);
+
+    // Reads the elements of the array with the given key one at a time, each into its own right-sized document, and passes them to the given callback.
+    // Only matches the key in the top-level object, skipping strings, comments and nested values while looking for it. Returns the number of elements read.
+    static uint ReadJsonArray(const char *jsonFilePath, const char *arrayKey, std::function<void(JsonObject)> callback);
+
+    // Parses the given JSON string into a document that grows until the JSON fits (max. 32k).
+    static DynamicJsonDocument ParseJson(const char *json);
+
+    // Reads a power rate (in %/s) from the given config object.
+    // Falls back to the legacy power step (per drive loop tick) under the given step key, and then to the given default rate.
+    static int16_t ReadPwrRate(JsonObject config, const char *rateKey, const char *stepKey, int16_t defaultRate);
+
+    // Reads a speed curve ('speedCurve' with 'minPwrPerc', 'knees' and 'maxPwrPerc') from the given config object.
+    // Falls back to the given default curve (nullptr = linear), if the config object doesn't define one.
+    static MCSpeedCurve *ReadSpeedCurve(JsonObject config, MCSpeedCurve *defaultCurve);
+
+    // Reads the closed-loop speed control tuning ('speedControl' with 'kp' and 'ki') from the given config object.
+    // Falls back to the given default tuning (nullptr = open-loop), if the config object doesn't define one.
+    static MCSpeedControlConfig *ReadSpeedControl(JsonObject config, MCSpeedControlConfig *defaultConfig);
+
+  private:
+    // Reads a JSON document, keeping only the fields in the given filter (if any).
+    static DynamicJsonDocument readJsonFile(const char *jsonFilePath, JsonDocument *filter);
+
+    // Skips to just after the '[' opening the array with the given key in the top-level object of the file. Returns false if there's no such array.
+    static bool seekTopLevelArray(File &file, const char *key);
+
+    // Skips whitespace and comments at the current position of the given file.
+    static void skipWhitespace(File &file);
+
+    // Skips the comment at the current position of the given file, just after its leading '/'.
+    static void skipComment(File &file);
+
+    // Deserializes the JSON at the current position of the given file, retrying with a document of twice the capacity while it doesn't fit.
+    static DynamicJsonDocument deserializeJsonFile(File &file, JsonDocument *filter);
 };
\ No newline at end of file
@@ -3,18 +3,23 @@
 MCLocoEvent::MCLocoEvent(std::vector<MCLocoTrigger *> triggers, std::vector<MCLocoAction *> actions)
     : _triggers{triggers}, _actions{actions} {}
 
-bool MCLocoEvent::HasTrigger(MCTriggerSource source, std::string eventType, std::string eventId, std::string value)
+MCLocoEvent::~MCLocoEvent()
 {
     for (MCLocoTrigger *trigger : _triggers) {
-        if (trigger->Matches(source, eventType, eventId, value)) {
-            return true;
-        }
+        delete trigger;
     }
 
-    return false;
+    for (MCLocoAction *action : _actions) {
+        delete action;
+    }
+}
+
+const std::vector<MCLocoTrigger *> &MCLocoEvent::GetTriggers()
+{
+    return _triggers;
 }
 
-std::vector<MCLocoAction *> MCLocoEvent::GetActions()
+const std::vector<MCLocoAction *> &MCLocoEvent::GetActions()
 {
     return _actions;
 }
\ No newline at end of file
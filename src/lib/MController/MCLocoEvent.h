@@ -10,10 +10,14 @@ class MCLocoEvent
   public:
     MCLocoEvent(std::vector<MCLocoTrigger *> triggers, std::vector<MCLocoAction *> actions);
 
-    bool HasTrigger(MCTriggerSource source, std::string eventType, std::string eventId, std::string value);
+    // Deletes the triggers and actions.
+    ~MCLocoEvent();
+
+    // Returns the list of triggers of this event.
+    const std::vector<MCLocoTrigger *> &GetTriggers();
 
     // Returns a list of actions to execute when triggered by this event.
-    std::vector<MCLocoAction *> GetActions();
+    const std::vector<MCLocoAction *> &GetActions();
 
   private:
     std::vector<MCLocoTrigger *> _triggers;
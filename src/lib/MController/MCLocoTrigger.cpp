@@ -1,9 +1,29 @@
 #include "MCLocoTrigger.h"
 
-MCLocoTrigger::MCLocoTrigger(MCTriggerSource source, std::string eventType, std::string eventId, std::string value, int8_t delayInMs)
+MCLocoTrigger::MCLocoTrigger(MCTriggerSource source, std::string eventType, std::string eventId, std::string value, uint32_t delayInMs)
     : _source{source}, _eventType{eventType}, _eventId{eventId}, _value{value}, _delayInMs{delayInMs} {}
 
-bool MCLocoTrigger::Matches(MCTriggerSource source, std::string eventType, std::string eventId, std::string value)
+MCTriggerSource MCLocoTrigger::GetSource()
 {
-    return _source == source && _eventType == eventType && _eventId == eventId && _value == value;
+    return _source;
+}
+
+const std::string &MCLocoTrigger::GetEventType()
+{
+    return _eventType;
+}
+
+const std::string &MCLocoTrigger::GetEventId()
+{
+    return _eventId;
+}
+
+const std::string &MCLocoTrigger::GetValue()
+{
+    return _value;
+}
+
+uint32_t MCLocoTrigger::GetDelayInMs()
+{
+    return _delayInMs;
 }
\ No newline at end of file
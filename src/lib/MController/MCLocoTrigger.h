@@ -7,10 +7,22 @@
 class MCLocoTrigger
 {
   public:
-    MCLocoTrigger(MCTriggerSource source, std::string eventType, std::string eventId, std::string value, int8_t delayInMs = 0);
+    MCLocoTrigger(MCTriggerSource source, std::string eventType, std::string eventId, std::string value, uint32_t delayInMs = 0);
 
-    // Returns a boolean value indicating whether the given trigger details match this trigger.
-    bool Matches(MCTriggerSource source, std::string eventType, std::string eventId, std::string value);
+    // Returns the source that initialized the trigger.
+    MCTriggerSource GetSource();
+
+    // Returns the event that occurred.
+    const std::string &GetEventType();
+
+    // Returns the event identifier of the trigger.
+    const std::string &GetEventId();
+
+    // Returns the value of the event trigger.
+    const std::string &GetValue();
+
+    // Returns the delay in milliseconds between receiving the trigger and executing any related actions.
+    uint32_t GetDelayInMs();
 
   private:
     // Holds the source that initialized the trigger (Loco, RocRail, ...).
@@ -26,5 +38,5 @@ class MCLocoTrigger
     std::string _value;
 
     // Holds the delay in milliseconds between receiving the trigger and executing any related actions.
-    int8_t _delayInMs;
+    uint32_t _delayInMs;
 };
\ No newline at end of file
@@ -1,9 +1,14 @@
 #include "MCPinController.h"
 
-MCPinController::MCPinController(MCChannelConfig *config)
-    : MCChannelController(config) {}
+MCPinController::MCPinController(MCChannelConfig *config, MCLedBase *led)
+    : MCChannelController(config), _led(led) {}
 
 int MCPinController::GetEspPinNumber()
 {
     return _config->GetChannel()->GetAddressAsEspPinNumber();
+}
+
+MCLedBase *MCPinController::GetLed()
+{
+    return _led;
 }
\ No newline at end of file
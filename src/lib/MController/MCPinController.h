@@ -4,12 +4,20 @@
 
 #include "MCChannelConfig.h"
 #include "MCChannelController.h"
+#include "MCLedBase.h"
 
 class MCPinController : public MCChannelController
 {
   public:
-    MCPinController(MCChannelConfig *config);
+    MCPinController(MCChannelConfig *config, MCLedBase *led);
 
     // Returns the channel's address interpreted as an ESP pin number.
     int GetEspPinNumber();
+
+    // Returns the led attached to the pin (nullptr if no (status) light is attached).
+    MCLedBase *GetLed();
+
+  private:
+    // Reference to the led attached to the pin, bound at setup so the loop doesn't need to look it up.
+    MCLedBase *_led;
 };
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "MCSpeedController.h"
+
+#define MAX_PWR (100 << SPEED_CONTROL_FIXED_POINT_BITS)
+
+MCSpeedController::MCSpeedController(MCSpeedControlConfig config)
+    : _config{config}
+{
+    Reset();
+}
+
+int16_t MCSpeedController::Update(int16_t targetSpeedPerc, int16_t measuredSpeedPerc, uint32_t elapsedInMs)
+{
+    if (elapsedInMs > SPEED_CONTROL_MAX_ELAPSED_IN_MS) {
+        elapsedInMs = SPEED_CONTROL_MAX_ELAPSED_IN_MS;
+    }
+
+    _error = targetSpeedPerc - measuredSpeedPerc;
+
+    int32_t feedForward = (int32_t)targetSpeedPerc << SPEED_CONTROL_FIXED_POINT_BITS;
+    int32_t proportional = (int32_t)_config.Kp * _error;
+    int32_t output = feedForward + proportional + _integral;
+
+    // Anti-windup: only integrate while the output isn't saturated in the direction of the error.
+    if (!(output >= MAX_PWR && _error > 0) && !(output <= -MAX_PWR && _error < 0)) {
+        _integral += (int64_t)_config.Ki * _error * (int64_t)elapsedInMs / 1000;
+
+        if (_integral > MAX_PWR) {
+            _integral = MAX_PWR;
+        } else if (_integral < -MAX_PWR) {
+            _integral = -MAX_PWR;
+        }
+
+        output = feedForward + proportional + _integral;
+    }
+
+    if (output > MAX_PWR) {
+        output = MAX_PWR;
+    } else if (output < -MAX_PWR) {
+        output = -MAX_PWR;
+    }
+
+    // Never reverse the motor to correct an overshoot, stopping it is the most we do.
+    if ((targetSpeedPerc > 0 && output < 0) || (targetSpeedPerc < 0 && output > 0)) {
+        output = 0;
+    }
+
+    _output = output / (1 << SPEED_CONTROL_FIXED_POINT_BITS);
+    return _output;
+}
+
+void MCSpeedController::Reset()
+{
+    _integral = 0;
+    _error = 0;
+    _output = 0;
+}
+
+int16_t MCSpeedController::GetError()
+{
+    return _error;
+}
+
+int16_t MCSpeedController::GetOutput()
+{
+    return _output;
+}
\ No newline at end of file
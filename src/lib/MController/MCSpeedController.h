@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+
+// Number of fractional bits of the fixed-point values used by the speed controller (1/256).
+#define SPEED_CONTROL_FIXED_POINT_BITS 8
+
+// Max. time (in ms) integrated in a single update, so a stalled loop doesn't cause a huge integral step.
+#define SPEED_CONTROL_MAX_ELAPSED_IN_MS 1000
+
+// Tuning of the closed-loop speed controller.
+struct MCSpeedControlConfig {
+    // Proportional gain (in 1/256 % pwr per % speed error).
+    int16_t Kp;
+
+    // Integral gain (in 1/256 % pwr per % speed error per second).
+    int16_t Ki;
+};
+
+// Fixed-point PI controller adjusting the motor pwr to hold the motor at the target speed, based on its measured speed.
+// The target speed is fed forward, so the controller only has to correct for grades and varying load.
+// Doesn't depend on Arduino or BLE, so it can be run against a simulated motor model.
+class MCSpeedController
+{
+  public:
+    MCSpeedController(MCSpeedControlConfig config);
+
+    // Returns the pwr percentage (-100% - 100%) to apply to reach the target speed percentage, given the measured speed percentage and the time (in ms) elapsed since the previous update.
+    int16_t Update(int16_t targetSpeedPerc, int16_t measuredSpeedPerc, uint32_t elapsedInMs);
+
+    // Resets the controller (to be used when the motor stops or the measured speed is no longer available).
+    void Reset();
+
+    // Returns the speed error (in %) of the last update.
+    int16_t GetError();
+
+    // Returns the pwr percentage returned by the last update.
+    int16_t GetOutput();
+
+  private:
+    MCSpeedControlConfig _config;
+
+    // Integral term (in 1/256 % pwr).
+    int32_t _integral;
+
+    int16_t _error;
+    int16_t _output;
+};
\ No newline at end of file
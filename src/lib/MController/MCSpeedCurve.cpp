@@ -0,0 +1,56 @@
+#include <algorithm>
+
+#include "MCSpeedCurve.h"
+
+#define MAX_SPEED_PERC 100
+#define MAX_PWR_PERC 100
+
+MCSpeedCurve::MCSpeedCurve(uint8_t minPwrPerc, std::vector<MCSpeedCurvePoint> kneePoints, uint8_t maxPwrPerc)
+{
+    compile(minPwrPerc, kneePoints, maxPwrPerc);
+}
+
+MCSpeedCurve::MCSpeedCurve(const uint16_t *table)
+{
+    memcpy(_table, table, sizeof(_table));
+}
+
+uint16_t MCSpeedCurve::GetPwr(uint8_t speedPerc)
+{
+    return _table[min(speedPerc, (uint8_t)MAX_SPEED_PERC)];
+}
+
+void MCSpeedCurve::compile(uint8_t minPwrPerc, std::vector<MCSpeedCurvePoint> kneePoints, uint8_t maxPwrPerc)
+{
+    // Build the list of points the curve runs through: min. pwr at 0%, the knee points (ordered by speed) and max. pwr at 100%.
+    std::vector<MCSpeedCurvePoint> points;
+    points.push_back({0, (uint8_t)min(minPwrPerc, (uint8_t)MAX_PWR_PERC)});
+
+    std::sort(kneePoints.begin(), kneePoints.end(), [](const MCSpeedCurvePoint &a, const MCSpeedCurvePoint &b) { return a.SpeedPerc < b.SpeedPerc; });
+    for (MCSpeedCurvePoint point : kneePoints) {
+        if (point.SpeedPerc > points.back().SpeedPerc && point.SpeedPerc < MAX_SPEED_PERC) {
+            // Knee points outside the curve, or at a speed we already have a point for, are ignored.
+            points.push_back({point.SpeedPerc, (uint8_t)min(point.PwrPerc, (uint8_t)MAX_PWR_PERC)});
+        }
+    }
+
+    points.push_back({MAX_SPEED_PERC, (uint8_t)min(maxPwrPerc, (uint8_t)MAX_PWR_PERC)});
+
+    // A speed of 0% always means stop, no matter what the min. pwr is.
+    _table[0] = 0;
+
+    // Linearly interpolate the fixed-point pwr between the points for every other speed percentage.
+    size_t segment = 1;
+    for (uint8_t speedPerc = 1; speedPerc <= MAX_SPEED_PERC; speedPerc++) {
+        while (points[segment].SpeedPerc < speedPerc) {
+            segment++;
+        }
+
+        const MCSpeedCurvePoint &from = points[segment - 1];
+        const MCSpeedCurvePoint &to = points[segment];
+        int32_t fromPwr = from.PwrPerc << SPEED_CURVE_FIXED_POINT_BITS;
+        int32_t toPwr = to.PwrPerc << SPEED_CURVE_FIXED_POINT_BITS;
+
+        _table[speedPerc] = fromPwr + (toPwr - fromPwr) * (speedPerc - from.SpeedPerc) / (to.SpeedPerc - from.SpeedPerc);
+    }
+}
\ No newline at end of file
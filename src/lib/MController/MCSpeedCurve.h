@@ -0,0 +1,40 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+// Number of entries in a compiled speed curve (one for every speed percentage from 0% to 100%).
+#define SPEED_CURVE_TABLE_SIZE 101
+
+// Number of fractional bits of the fixed-point pwr values in a compiled speed curve (pwr in 1/256 %).
+#define SPEED_CURVE_FIXED_POINT_BITS 8
+
+// Fixed-point pwr value of 100%.
+#define SPEED_CURVE_MAX_PWR (100 << SPEED_CURVE_FIXED_POINT_BITS)
+
+// Knee point of a speed curve, mapping a speed percentage to a pwr percentage.
+struct MCSpeedCurvePoint {
+    uint8_t SpeedPerc;
+    uint8_t PwrPerc;
+};
+
+// Speed curve mapping a requested speed percentage (0% - 100%) to the pwr percentage to apply to the motor.
+// The curve starts at the min. pwr (the pwr at which the motor actually starts turning), runs through the given knee points and ends at the max. pwr.
+// It is compiled into a fixed-point lookup table once, so mapping a speed doesn't require any calculations.
+class MCSpeedCurve
+{
+  public:
+    MCSpeedCurve(uint8_t minPwrPerc, std::vector<MCSpeedCurvePoint> kneePoints, uint8_t maxPwrPerc);
+
+    // Creates a speed curve from an already compiled table (of SPEED_CURVE_TABLE_SIZE entries).
+    MCSpeedCurve(const uint16_t *table);
+
+    // Returns the fixed-point pwr (in 1/256 %) for the given absolute speed percentage (0% - 100%).
+    uint16_t GetPwr(uint8_t speedPerc);
+
+  private:
+    void compile(uint8_t minPwrPerc, std::vector<MCSpeedCurvePoint> kneePoints, uint8_t maxPwrPerc);
+
+    // Fixed-point pwr (in 1/256 %) for every speed percentage.
+    uint16_t _table[SPEED_CURVE_TABLE_SIZE];
+};
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "MCTimerWheel.h"
+#include "log4MC.h"
+
+MCTimerWheel::MCTimerWheel()
+{
+    for (int16_t slot = 0; slot < TIMER_WHEEL_SLOT_COUNT; slot++) {
+        _slots[slot] = -1;
+    }
+
+    // Chain all timers into the list of free timers.
+    for (int16_t timer = 0; timer < TIMER_WHEEL_MAX_TIMERS; timer++) {
+        _timers[timer].Next = timer + 1 < TIMER_WHEEL_MAX_TIMERS ? timer + 1 : -1;
+    }
+
+    _free = 0;
+    _currentTick = 0;
+    _pendingCount = 0;
+    _overflowCount = 0;
+    _lock = xSemaphoreCreateMutex();
+}
+
+void MCTimerWheel::Start()
+{
+    xTaskCreatePinnedToCore(taskLoop, "TimerWheel", TIMER_WHEEL_STACK_DEPTH, this, TIMER_WHEEL_TASK_PRIORITY, NULL, 1);
+}
+
+bool MCTimerWheel::Schedule(void *owner, const void *key, uint32_t delayInMs, MCTimerCallback callback, void *payload)
+{
+    // Round up to whole ticks, so we never expire early.
+    uint32_t ticks = max((delayInMs + TIMER_WHEEL_TICK_IN_MS - 1) / TIMER_WHEEL_TICK_IN_MS, (uint32_t)1);
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+
+    if (_free < 0) {
+        _overflowCount++;
+        xSemaphoreGive(_lock);
+        log4MC::vlogf(LOG_WARNING, "Ctrl: No free timers, delayed action dropped (max. %u pending).", TIMER_WHEEL_MAX_TIMERS);
+        return false;
+    }
+
+    int16_t timer = _free;
+    _free = _timers[timer].Next;
+
+    // The slot is visited for the first time within one revolution, and then once every revolution.
+    uint16_t slot = (_currentTick + ticks) % TIMER_WHEEL_SLOT_COUNT;
+    _timers[timer] = {_slots[slot], (ticks - 1) / TIMER_WHEEL_SLOT_COUNT, owner, key, callback, payload};
+    _slots[slot] = timer;
+    _pendingCount++;
+
+    xSemaphoreGive(_lock);
+    return true;
+}
+
+uint MCTimerWheel::Cancel(void *owner, const void *key)
+{
+    return cancel(owner, key, false);
+}
+
+uint MCTimerWheel::CancelAll(void *owner)
+{
+    return cancel(owner, nullptr, true);
+}
+
+uint MCTimerWheel::cancel(void *owner, const void *key, bool anyKey)
+{
+    uint cancelled = 0;
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+
+    for (int16_t slot = 0; slot < TIMER_WHEEL_SLOT_COUNT; slot++) {
+        int16_t *link = &_slots[slot];
+        while (*link >= 0) {
+            int16_t timer = *link;
+            if (_timers[timer].Owner == owner && (anyKey || _timers[timer].Key == key)) {
+                *link = _timers[timer].Next;
+                release(timer);
+                cancelled++;
+            } else {
+                link = &_timers[timer].Next;
+            }
+        }
+    }
+
+    xSemaphoreGive(_lock);
+    return cancelled;
+}
+
+uint MCTimerWheel::GetPendingCount()
+{
+    return _pendingCount;
+}
+
+uint32_t MCTimerWheel::GetOverflowCount()
+{
+    return _overflowCount;
+}
+
+void MCTimerWheel::taskLoop(void *parm)
+{
+    MCTimerWheel *wheel = (MCTimerWheel *)parm;
+    TickType_t lastWakeTime = xTaskGetTickCount();
+
+    for (;;) {
+        // Wait until the next tick is due (independent of how long executing the callbacks took).
+        vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(TIMER_WHEEL_TICK_IN_MS));
+        wheel->tick();
+    }
+}
+
+void MCTimerWheel::tick()
+{
+    Timer expired[TIMER_WHEEL_MAX_TIMERS];
+    uint expiredCount = 0;
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+
+    _currentTick++;
+    int16_t *link = &_slots[_currentTick % TIMER_WHEEL_SLOT_COUNT];
+    while (*link >= 0) {
+        int16_t timer = *link;
+        if (_timers[timer].Rounds == 0) {
+            expired[expiredCount++] = _timers[timer];
+            *link = _timers[timer].Next;
+            release(timer);
+        } else {
+            _timers[timer].Rounds--;
+            link = &_timers[timer].Next;
+        }
+    }
+
+    xSemaphoreGive(_lock);
+
+    // Execute callbacks without holding the lock, so they're free to schedule or cancel timers.
+    for (uint i = 0; i < expiredCount; i++) {
+        expired[i].Callback(expired[i].Owner, expired[i].Payload);
+    }
+}
+
+void MCTimerWheel::release(int16_t timer)
+{
+    _timers[timer].Next = _free;
+    _free = timer;
+    _pendingCount--;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Number of slots in the timer wheel.
+#define TIMER_WHEEL_SLOT_COUNT 64
+
+// Duration of a single timer wheel tick in milliseconds (one revolution of the wheel takes 640 ms).
+#define TIMER_WHEEL_TICK_IN_MS 10
+
+// Max. number of timers that can be pending at the same time.
+#define TIMER_WHEEL_MAX_TIMERS 32
+
+// The priority at which the timer wheel task should run.
+#define TIMER_WHEEL_TASK_PRIORITY 2
+
+// The size of the timer wheel task stack specified as the number of bytes.
+#define TIMER_WHEEL_STACK_DEPTH 3072
+
+// Callback executed when a timer expires.
+typedef void (*MCTimerCallback)(void *owner, void *payload);
+
+// Hashed timer wheel, serviced by a single task.
+// Timers are hashed into slots by their expiry tick, so scheduling and expiring a timer is O(1), no matter how many timers are pending.
+// Every timer has an owner and a key, so pending timers can be cancelled when a newer event supersedes them.
+class MCTimerWheel
+{
+  public:
+    MCTimerWheel();
+
+    // Starts the task servicing the timer wheel.
+    void Start();
+
+    // Schedules the callback to be executed with the given owner and payload after the given delay (in ms).
+    // Returns false if there are no free timers.
+    bool Schedule(void *owner, const void *key, uint32_t delayInMs, MCTimerCallback callback, void *payload);
+
+    // Cancels all pending timers with the given owner and key. Returns the number of cancelled timers.
+    uint Cancel(void *owner, const void *key);
+
+    // Cancels all pending timers with the given owner, no matter their key. Returns the number of cancelled timers.
+    uint CancelAll(void *owner);
+
+    // Returns the number of pending timers.
+    uint GetPendingCount();
+
+    // Returns the number of timers that couldn't be scheduled, because there were no free timers.
+    uint32_t GetOverflowCount();
+
+  private:
+    struct Timer {
+        int16_t Next;
+        uint32_t Rounds;
+        void *Owner;
+        const void *Key;
+        MCTimerCallback Callback;
+        void *Payload;
+    };
+
+    static void taskLoop(void *parm);
+
+    // Advances the wheel by one tick and executes the callbacks of all expired timers.
+    void tick();
+
+    // Cancels all pending timers with the given owner and key (any key when anyKey is true).
+    uint cancel(void *owner, const void *key, bool anyKey);
+
+    // Returns the given timer to the list of free timers.
+    void release(int16_t timer);
+
+    Timer _timers[TIMER_WHEEL_MAX_TIMERS];
+
+    // Index of the first timer in each slot (-1 = empty).
+    int16_t _slots[TIMER_WHEEL_SLOT_COUNT];
+
+    // Index of the first free timer (-1 = none).
+    int16_t _free;
+
+    uint32_t _currentTick;
+    uint _pendingCount;
+    uint32_t _overflowCount;
+    SemaphoreHandle_t _lock;
+};
\ No newline at end of file
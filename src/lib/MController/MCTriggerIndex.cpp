@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <map>
+
+#include "MCTriggerIndex.h"
+
+MCTriggerIndex::MCTriggerIndex(std::vector<MCLocoEvent *> events)
+{
+    // Collect the events per trigger key (in config order), so each key can be mapped to a single span of actions.
+    std::map<uint64_t, std::vector<std::pair<MCLocoEvent *, uint32_t>>> eventsByKey;
+    std::vector<uint64_t> keys;
+
+    for (MCLocoEvent *event : events) {
+        for (MCLocoTrigger *trigger : event->GetTriggers()) {
+            uint64_t key = makeKey(trigger->GetSource(), intern(trigger->GetEventType()), intern(trigger->GetEventId()), intern(trigger->GetValue()));
+
+            std::vector<std::pair<MCLocoEvent *, uint32_t>> &keyEvents = eventsByKey[key];
+            if (keyEvents.empty()) {
+                keys.push_back(key);
+            }
+
+            auto isEvent = [event](const std::pair<MCLocoEvent *, uint32_t> &keyEvent) { return keyEvent.first == event; };
+            if (std::find_if(keyEvents.begin(), keyEvents.end(), isEvent) == keyEvents.end()) {
+                // An event with several identical triggers only fires once (with the delay of the first one).
+                keyEvents.push_back({event, trigger->GetDelayInMs()});
+            }
+        }
+    }
+
+    // Copy the actions into one contiguous list first, as pointers into it are only stable once it's complete.
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (uint64_t key : keys) {
+        size_t first = _actions.size();
+        for (std::pair<MCLocoEvent *, uint32_t> &keyEvent : eventsByKey[key]) {
+            for (MCLocoAction *action : keyEvent.first->GetActions()) {
+                _actions.push_back({action, keyEvent.second});
+            }
+        }
+        ranges.push_back({first, _actions.size()});
+    }
+
+    _actions.shrink_to_fit();
+    for (size_t i = 0; i < keys.size(); i++) {
+        _spans[keys[i]] = {_actions.data() + ranges[i].first, _actions.data() + ranges[i].second};
+    }
+}
+
+MCLocoActionSpan MCTriggerIndex::Find(MCTriggerSource source, const char *eventType, const char *eventId, const char *value)
+{
+    int32_t eventTypeId = lookup(eventType);
+    int32_t eventIdId = lookup(eventId);
+    int32_t valueId = lookup(value);
+
+    if (eventTypeId >= 0 && eventIdId >= 0 && valueId >= 0) {
+        auto span = _spans.find(makeKey(source, eventTypeId, eventIdId, valueId));
+        if (span != _spans.end()) {
+            return span->second;
+        }
+    }
+
+    return {nullptr, nullptr};
+}
+
+uint MCTriggerIndex::Size()
+{
+    return _spans.size();
+}
+
+uint16_t MCTriggerIndex::intern(const std::string &str)
+{
+    int32_t id = lookup(str.c_str());
+    if (id >= 0) {
+        return id;
+    }
+
+    // Find the first free hash value, starting at the string's own hash.
+    uint32_t strHash = hash(str.c_str());
+    while (_stringIds.find(strHash) != _stringIds.end()) {
+        strHash++;
+    }
+
+    _strings.push_back(str);
+    _stringIds[strHash] = _strings.size() - 1;
+
+    return _strings.size() - 1;
+}
+
+int32_t MCTriggerIndex::lookup(const char *str)
+{
+    // Probe from the string's own hash, until we find the string or a free hash value.
+    for (uint32_t strHash = hash(str);; strHash++) {
+        auto id = _stringIds.find(strHash);
+        if (id == _stringIds.end()) {
+            return -1;
+        }
+
+        if (strcmp(_strings[id->second].c_str(), str) == 0) {
+            return id->second;
+        }
+    }
+}
+
+uint64_t MCTriggerIndex::makeKey(MCTriggerSource source, uint16_t eventType, uint16_t eventId, uint16_t value)
+{
+    return ((uint64_t)source << 48) | ((uint64_t)eventType << 32) | ((uint64_t)eventId << 16) | value;
+}
+
+uint32_t MCTriggerIndex::hash(const char *str)
+{
+    uint32_t strHash = 2166136261u;
+    while (*str) {
+        strHash = (strHash ^ (uint8_t)*str++) * 16777619u;
+    }
+
+    return strHash;
+}
\ No newline at end of file
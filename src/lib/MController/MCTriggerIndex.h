@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Arduino.h>
+#include <unordered_map>
+#include <vector>
+
+#include "MCLocoEvent.h"
+
+// Action triggered by an event, with the delay of the trigger that fired it.
+struct MCTriggeredAction {
+    MCLocoAction *Action;
+    uint32_t DelayInMs;
+};
+
+// Contiguous range of actions triggered by an event.
+struct MCLocoActionSpan {
+    const MCTriggeredAction *Begin;
+    const MCTriggeredAction *End;
+
+    const MCTriggeredAction *begin() const { return Begin; }
+    const MCTriggeredAction *end() const { return End; }
+    size_t size() const { return End - Begin; }
+};
+
+// Index of loco event triggers, compiled once when the loco config is loaded.
+// The trigger strings are interned into integer ids, and the combined (source, eventType, eventId, value) key maps to a contiguous span of actions,
+// so dispatching an event is a single lookup that doesn't allocate.
+class MCTriggerIndex
+{
+  public:
+    MCTriggerIndex(std::vector<MCLocoEvent *> events);
+
+    // Returns the actions triggered by the given event details (an empty span if the event doesn't trigger anything).
+    MCLocoActionSpan Find(MCTriggerSource source, const char *eventType, const char *eventId, const char *value);
+
+    // Returns the number of distinct trigger keys in the index.
+    uint Size();
+
+  private:
+    // Returns the id of the given string, adding it to the interned strings if needed.
+    uint16_t intern(const std::string &str);
+
+    // Returns the id of the given string, or -1 if the string isn't interned (so no trigger can match it).
+    int32_t lookup(const char *str);
+
+    // Returns the key combining the given source and interned string ids.
+    static uint64_t makeKey(MCTriggerSource source, uint16_t eventType, uint16_t eventId, uint16_t value);
+
+    // Returns the FNV-1a hash of the given string.
+    static uint32_t hash(const char *str);
+
+    // Interned strings by id.
+    std::vector<std::string> _strings;
+
+    // Interned string ids by hash (colliding hashes are stored at the next free hash value).
+    std::unordered_map<uint32_t, uint16_t> _stringIds;
+
+    // All triggered actions, grouped by trigger key.
+    std::vector<MCTriggeredAction> _actions;
+
+    // Action spans by trigger key.
+    std::unordered_map<uint64_t, MCLocoActionSpan> _spans;
+};
\ No newline at end of file
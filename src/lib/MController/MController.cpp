@@ -3,6 +3,7 @@
 #include "MCLed.h"
 #include "MCLightController.h"
 #include "MCLocoAction.h"
+#include "MCPinController.h"
 #include "MCStatusLed.h"
 #include "log4MC.h"
 
@@ -36,71 +37,64 @@ void MController::Setup(MCConfiguration *config)
     // Setup controller configuration.
     _config = config;
     _ebrake = false;
+    _connectionStatus = GetConnectionStatus();
+    _loopCount = 0;
 
     // Initialize local channel controllers.
     initChannelControllers();
+
+    // Start the timer wheel executing delayed actions.
+    _timerWheel = new MCTimerWheel();
+    _timerWheel->Start();
 }
 
 void MController::Loop()
 {
-    int currentPwrPerc;
+    // Sample the connection status once per tick, as it queries both WiFi and MQTT.
+    _connectionStatus = GetConnectionStatus();
+    _loopCount++;
+
+    const bool ebrake = GetEmergencyBrake();
+    const int16_t statusPwrPerc = getStatusLedPwrPerc();
 
-    for (MCChannelController *channel : _channelControllers) {
+    for (MCPinController *channel : _channelControllers) {
         // Update channel e-brake status.
-        channel->EmergencyBrake(GetEmergencyBrake());
+        channel->EmergencyBrake(ebrake);
 
         // Update current channel pwr (continue if request was ignored).
         if (!channel->UpdateCurrentPwrPerc()) {
             continue;
         }
 
-        // Get new pwr perc.
-        currentPwrPerc = channel->GetCurrentPwrPerc();
+        MCLedBase *led = channel->GetLed();
+        if (!led) {
+            continue;
+        }
 
         if (channel->GetAttachedDevice() == DeviceType::Light) {
-            MCLedBase *led = findLedByPinNumber(channel->GetChannel()->GetAddressAsEspPinNumber());
-            if (led) {
-                led->SetCurrentPwrPerc(currentPwrPerc);
-            }
+            led->SetCurrentPwrPerc(channel->GetCurrentPwrPerc());
         }
 
         if (channel->GetAttachedDevice() == DeviceType::StatusLight) {
-            MCLedBase *led = findLedByPinNumber(channel->GetChannel()->GetAddressAsEspPinNumber());
-            if (led) {
-                switch (GetConnectionStatus()) {
-                case uninitialized:
-                case initializing: {
-                    // Two flashes per second.
-                    currentPwrPerc = MCLightController::TwoFlashesPerSecond() ? 100 : 0;
-                    break;
-                }
-                case MCConnectionStatus::connecting_wifi: {
-                    // One short flash per second (on 10%).
-                    currentPwrPerc = MCLightController::OneFlashPerSecond() ? 100 : 0;
-                    break;
-                }
-                case MCConnectionStatus::connecting_mqtt: {
-                    // Blink (on 50%).
-                    currentPwrPerc = MCLightController::Blink() ? 100 : 0;
-                    break;
-                }
-                case connected: {
-                    // Off.
-                    currentPwrPerc = 0;
-                    break;
-                }
-                };
-
-                led->SetCurrentPwrPerc(currentPwrPerc);
-            }
+            led->SetCurrentPwrPerc(statusPwrPerc);
         }
     }
 }
 
+uint32_t MController::GetLoopCount()
+{
+    return _loopCount;
+}
+
+MCTimerWheel *MController::GetTimerWheel()
+{
+    return _timerWheel;
+}
+
 bool MController::GetEmergencyBrake()
 {
     // E-brake is enabled when specifically requested (through MQTT) or when the controller is not connected.
-    return _ebrake || GetConnectionStatus() != MCConnectionStatus::connected;
+    return _ebrake || _connectionStatus != MCConnectionStatus::connected;
 }
 
 void MController::SetEmergencyBrake(const bool enabled)
@@ -119,33 +113,52 @@ void MController::Execute(MCLocoAction *action)
 
 void MController::initChannelControllers()
 {
-    // TODO: This method should be made more robust to prevent config errors, like configuring the same channel twice.
-
+    // Duplicate pins are rejected when loading the config.
     for (int i = 0; i < _config->EspPins.size(); i++) {
-        if (i >= 16) {
+        if (i >= MAX_ESP_PIN_COUNT) {
             // There are only 16 PWM channels available, so we must ignore the rest.
             log4MC::warn("CTRL: Local channel initialization failed (too many ESP pins configured, max. is 16)!");
             break;
         }
 
         MCChannelConfig *espPinConfig = _config->EspPins.at(i);
+        MCLedBase *led = nullptr;
         if (espPinConfig->GetAttachedDeviceType() == DeviceType::Light) {
-            initLed(i, espPinConfig->GetChannel()->GetAddressAsEspPinNumber(), espPinConfig->IsInverted());
+            led = initLed(i, espPinConfig->GetChannel()->GetAddressAsEspPinNumber(), espPinConfig->IsInverted());
         }
 
         if (espPinConfig->GetAttachedDeviceType() == DeviceType::StatusLight) {
-            initStatusLed(i, espPinConfig->GetChannel()->GetAddressAsEspPinNumber());
+            led = initStatusLed(i, espPinConfig->GetChannel()->GetAddressAsEspPinNumber());
         }
 
-        _channelControllers.push_back(new MCChannelController(espPinConfig));
+        _channelControllers.push_back(new MCPinController(espPinConfig, led));
     }
 
     log4MC::info("CTRL: Local channels initialized.");
 }
 
+int16_t MController::getStatusLedPwrPerc()
+{
+    switch (_connectionStatus) {
+    case MCConnectionStatus::uninitialized:
+    case MCConnectionStatus::initializing:
+        // Two flashes per second.
+        return MCLightController::TwoFlashesPerSecond() ? 100 : 0;
+    case MCConnectionStatus::connecting_wifi:
+        // One short flash per second (on 10%).
+        return MCLightController::OneFlashPerSecond() ? 100 : 0;
+    case MCConnectionStatus::connecting_mqtt:
+        // Blink (on 50%).
+        return MCLightController::Blink() ? 100 : 0;
+    default:
+        // Off.
+        return 0;
+    }
+}
+
 MCChannelController *MController::findControllerByChannel(MCChannel *channel)
 {
-    for (MCChannelController *controller : _channelControllers) {
+    for (MCPinController *controller : _channelControllers) {
         if (controller->GetChannel() == channel) {
             return controller;
         }
@@ -165,22 +178,28 @@ MCLedBase *MController::findLedByPinNumber(int pin)
     return nullptr;
 }
 
-void MController::initLed(int pwmChannel, int pin, bool inverted)
+MCLedBase *MController::initLed(int pwmChannel, int pin, bool inverted)
 {
-    if (findLedByPinNumber(pin) != nullptr) {
-        return;
+    MCLedBase *led = findLedByPinNumber(pin);
+    if (led != nullptr) {
+        return led;
     }
 
     // If not found, define, initialize and add a new LED.
-    _espLeds.push_back(new MCLed(pwmChannel, pin, inverted));
+    led = new MCLed(pwmChannel, pin, inverted);
+    _espLeds.push_back(led);
+    return led;
 }
 
-void MController::initStatusLed(int pwmChannel, int pin)
+MCLedBase *MController::initStatusLed(int pwmChannel, int pin)
 {
-    if (findLedByPinNumber(pin) != nullptr) {
-        return;
+    MCLedBase *led = findLedByPinNumber(pin);
+    if (led != nullptr) {
+        return led;
     }
 
     // If not found, define, initialize and add a new status LED.
-    _espLeds.push_back(new MCStatusLed(pwmChannel, pin, false));
+    led = new MCStatusLed(pwmChannel, pin, false);
+    _espLeds.push_back(led);
+    return led;
 }
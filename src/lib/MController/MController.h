@@ -5,6 +5,8 @@
 #include "MCConfiguration.h"
 #include "MCLedBase.h"
 #include "MCLocoAction.h"
+#include "MCPinController.h"
+#include "MCTimerWheel.h"
 #include "MattzoMQTTSubscriber.h"
 #include "MattzoWifiClient.h"
 
@@ -30,7 +32,7 @@ class MController
     // Updates emergency brake based on the current controller connection status and controls leds.
     void Loop();
 
-    // Returns a boolean value indicating whether the e-brake flag is currently set or not.
+    // Returns a boolean value indicating whether the e-brake flag is currently set or not (based on the connection status sampled by the last loop).
     bool GetEmergencyBrake();
 
     // Sets the emergency brake flag to the given value.
@@ -39,37 +41,55 @@ class MController
     // Executes the given action locally on this controller.
     void Execute(MCLocoAction *action);
 
+    // Returns the timer wheel used to execute delayed actions.
+    MCTimerWheel *GetTimerWheel();
+
+    // Returns the number of loop iterations since setup.
+    uint32_t GetLoopCount();
+
     // Abstract method required for derived controller implementations to handle e-brake.
     virtual void HandleSys(const bool ebrake) = 0;
 
     // Abstract method required to handle the given trigger (if loco is under control of this controller).
-    virtual void HandleTrigger(int locoAddress, MCTriggerSource source, std::string eventType, std::string eventId, std::string value) = 0;
+    virtual void HandleTrigger(int locoAddress, MCTriggerSource source, const char *eventType, const char *eventId, const char *value) = 0;
 
   private:
     // Initializes the pin channels.
     void initChannelControllers();
 
+    // Returns the status led pwr percentage for the sampled connection status.
+    int16_t getStatusLedPwrPerc();
+
     // Returns the controller for the requested channel.
     MCChannelController *findControllerByChannel(MCChannel *channel);
 
     // Returns the led instance for the requested pin.
     MCLedBase *findLedByPinNumber(int pin);
 
-    // Initializes an led instance, if it doesn't exist yet.
-    void initLed(int pwmChannel, int pin, bool inverted);
+    // Initializes an led instance, if it doesn't exist yet. Returns the led instance for the pin.
+    MCLedBase *initLed(int pwmChannel, int pin, bool inverted);
 
-    // Initializes a status led instance, if it doesn't exist yet.
-    void initStatusLed(int pwmChannel, int pin);
+    // Initializes a status led instance, if it doesn't exist yet. Returns the led instance for the pin.
+    MCLedBase *initStatusLed(int pwmChannel, int pin);
 
     // List of references to leds attached to this controller.
     std::vector<MCLedBase *> _espLeds;
 
     // List of references to led controllers.
-    std::vector<MCChannelController *> _channelControllers;
+    std::vector<MCPinController *> _channelControllers;
 
     // Boolean value indicating whether emergency brake is currently enabled or not.
     bool _ebrake;
 
+    // Connection status, sampled once per loop iteration.
+    MCConnectionStatus _connectionStatus;
+
+    // Number of loop iterations since setup.
+    uint32_t _loopCount;
+
     // Reference to the configuration of this controller.
     MCConfiguration *_config;
+
+    // Timer wheel used to execute delayed actions.
+    MCTimerWheel *_timerWheel;
 };
\ No newline at end of file
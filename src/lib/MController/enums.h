@@ -1,22 +1,46 @@
 #pragma once
 
-#include <map>
+#include <string.h>
+#include <string>
+
+// Name of an enum value, as used in the config files.
+template <typename T>
+struct MCEnumName {
+    const char *Name;
+    T Value;
+};
+
+// Returns the enum value with the given name from the given table, or the given default value if the name is unknown.
+// Only meant to be used while loading the config, so the runtime never has to touch these strings.
+template <typename T, size_t N>
+T lookupEnumName(const MCEnumName<T> (&names)[N], const std::string &name, T defaultValue)
+{
+    for (const MCEnumName<T> &entry : names) {
+        if (strcmp(entry.Name, name.c_str()) == 0) {
+            return entry.Value;
+        }
+    }
+
+    return defaultValue;
+}
 
 enum ChannelType {
     EspPinChannel = 0,
     BleHubChannel
 };
 
-// String switch paridgam
-struct channelTypeMap : public std::map<std::string, ChannelType> {
-    channelTypeMap()
-    {
-        this->operator[]("espPin") = ChannelType::EspPinChannel;
-        this->operator[]("bleHub") = ChannelType::BleHubChannel;
-    };
-    ~channelTypeMap() {}
+// Config names of the ChannelType values.
+constexpr MCEnumName<ChannelType> channelTypeNames[] = {
+    {"espPin", ChannelType::EspPinChannel},
+    {"bleHub", ChannelType::BleHubChannel},
 };
 
+// Returns the ChannelType with the given config name (EspPinChannel if unknown).
+inline ChannelType parseChannelType(const std::string &name)
+{
+    return lookupEnumName(channelTypeNames, name, ChannelType::EspPinChannel);
+}
+
 enum DeviceType {
     Nothing,
     Motor,
@@ -24,19 +48,21 @@ enum DeviceType {
     StatusLight
 };
 
-// String switch paridgam
-struct deviceTypeMap : public std::map<std::string, DeviceType> {
-    deviceTypeMap()
-    {
-        this->operator[]("") = DeviceType::Nothing;
-        this->operator[]("nothing") = DeviceType::Nothing;
-        this->operator[]("motor") = DeviceType::Motor;
-        this->operator[]("light") = DeviceType::Light;
-        this->operator[]("status") = DeviceType::StatusLight;
-    };
-    ~deviceTypeMap() {}
+// Config names of the DeviceType values.
+constexpr MCEnumName<DeviceType> deviceTypeNames[] = {
+    {"", DeviceType::Nothing},
+    {"nothing", DeviceType::Nothing},
+    {"motor", DeviceType::Motor},
+    {"light", DeviceType::Light},
+    {"status", DeviceType::StatusLight},
 };
 
+// Returns the DeviceType with the given config name (Nothing if unknown).
+inline DeviceType parseDeviceType(const std::string &name)
+{
+    return lookupEnumName(deviceTypeNames, name, DeviceType::Nothing);
+}
+
 enum HubLedColor {
     BLACK = 0,
     PINK = 1,
@@ -53,27 +79,29 @@ enum HubLedColor {
     NONE = 255
 };
 
-// String switch paridgam
-struct hubLedColorMap : public std::map<std::string, HubLedColor> {
-    hubLedColorMap()
-    {
-        this->operator[]("") = HubLedColor::NONE;
-        this->operator[]("off") = HubLedColor::BLACK;
-        this->operator[]("black") = HubLedColor::BLACK;
-        this->operator[]("pink") = HubLedColor::PINK;
-        this->operator[]("purple") = HubLedColor::PURPLE;
-        this->operator[]("blue") = HubLedColor::BLUE;
-        this->operator[]("lightblue") = HubLedColor::LIGHTBLUE;
-        this->operator[]("cyan") = HubLedColor::CYAN;
-        this->operator[]("green") = HubLedColor::GREEN;
-        this->operator[]("yellow") = HubLedColor::YELLOW;
-        this->operator[]("orange") = HubLedColor::ORANGE;
-        this->operator[]("red") = HubLedColor::RED;
-        this->operator[]("white") = HubLedColor::WHITE;
-    };
-    ~hubLedColorMap() {}
+// Config names of the HubLedColor values.
+constexpr MCEnumName<HubLedColor> hubLedColorNames[] = {
+    {"", HubLedColor::NONE},
+    {"off", HubLedColor::BLACK},
+    {"black", HubLedColor::BLACK},
+    {"pink", HubLedColor::PINK},
+    {"purple", HubLedColor::PURPLE},
+    {"blue", HubLedColor::BLUE},
+    {"lightblue", HubLedColor::LIGHTBLUE},
+    {"cyan", HubLedColor::CYAN},
+    {"green", HubLedColor::GREEN},
+    {"yellow", HubLedColor::YELLOW},
+    {"orange", HubLedColor::ORANGE},
+    {"red", HubLedColor::RED},
+    {"white", HubLedColor::WHITE},
 };
 
+// Returns the HubLedColor with the given config name (BLACK if unknown).
+inline HubLedColor parseHubLedColor(const std::string &name)
+{
+    return lookupEnumName(hubLedColorNames, name, HubLedColor::BLACK);
+}
+
 enum MCTriggerSource {
     // Locomotive.
     Loco,
@@ -82,17 +110,19 @@ enum MCTriggerSource {
     RocRail
 };
 
-// String switch paridgam
-struct triggerSourceMap : public std::map<std::string, MCTriggerSource> {
-    triggerSourceMap()
-    {
-        this->operator[]("") = MCTriggerSource::Loco;
-        this->operator[]("loco") = MCTriggerSource::Loco;
-        this->operator[]("rr") = MCTriggerSource::RocRail;
-    };
-    ~triggerSourceMap() {}
+// Config names of the MCTriggerSource values.
+constexpr MCEnumName<MCTriggerSource> triggerSourceNames[] = {
+    {"", MCTriggerSource::Loco},
+    {"loco", MCTriggerSource::Loco},
+    {"rr", MCTriggerSource::RocRail},
 };
 
+// Returns the MCTriggerSource with the given config name (Loco if unknown).
+inline MCTriggerSource parseTriggerSource(const std::string &name)
+{
+    return lookupEnumName(triggerSourceNames, name, MCTriggerSource::Loco);
+}
+
 // Function supported by the generic controller.
 enum MCFunction {
     Status,
@@ -131,44 +161,46 @@ enum MCFunction {
     F32
 };
 
-// String switch paridgam
-struct functionMap : public std::map<std::string, MCFunction> {
-    functionMap()
-    {
-        this->operator[]("status") = MCFunction::Status;
-        this->operator[]("f0") = MCFunction::F0;
-        this->operator[]("f1") = MCFunction::F1;
-        this->operator[]("f2") = MCFunction::F2;
-        this->operator[]("f3") = MCFunction::F3;
-        this->operator[]("f4") = MCFunction::F4;
-        this->operator[]("f5") = MCFunction::F5;
-        this->operator[]("f6") = MCFunction::F6;
-        this->operator[]("f7") = MCFunction::F7;
-        this->operator[]("f8") = MCFunction::F8;
-        this->operator[]("f9") = MCFunction::F9;
-        this->operator[]("f10") = MCFunction::F10;
-        this->operator[]("f11") = MCFunction::F11;
-        this->operator[]("f12") = MCFunction::F12;
-        this->operator[]("f13") = MCFunction::F13;
-        this->operator[]("f14") = MCFunction::F14;
-        this->operator[]("f15") = MCFunction::F15;
-        this->operator[]("f16") = MCFunction::F16;
-        this->operator[]("f17") = MCFunction::F17;
-        this->operator[]("f18") = MCFunction::F18;
-        this->operator[]("f19") = MCFunction::F19;
-        this->operator[]("f20") = MCFunction::F20;
-        this->operator[]("f21") = MCFunction::F21;
-        this->operator[]("f22") = MCFunction::F22;
-        this->operator[]("f23") = MCFunction::F23;
-        this->operator[]("f24") = MCFunction::F24;
-        this->operator[]("f25") = MCFunction::F25;
-        this->operator[]("f26") = MCFunction::F26;
-        this->operator[]("f27") = MCFunction::F27;
-        this->operator[]("f28") = MCFunction::F28;
-        this->operator[]("f29") = MCFunction::F29;
-        this->operator[]("f30") = MCFunction::F30;
-        this->operator[]("f31") = MCFunction::F31;
-        this->operator[]("f32") = MCFunction::F32;
-    };
-    ~functionMap() {}
-};
\ No newline at end of file
+// Config names of the MCFunction values.
+constexpr MCEnumName<MCFunction> functionNames[] = {
+    {"status", MCFunction::Status},
+    {"f0", MCFunction::F0},
+    {"f1", MCFunction::F1},
+    {"f2", MCFunction::F2},
+    {"f3", MCFunction::F3},
+    {"f4", MCFunction::F4},
+    {"f5", MCFunction::F5},
+    {"f6", MCFunction::F6},
+    {"f7", MCFunction::F7},
+    {"f8", MCFunction::F8},
+    {"f9", MCFunction::F9},
+    {"f10", MCFunction::F10},
+    {"f11", MCFunction::F11},
+    {"f12", MCFunction::F12},
+    {"f13", MCFunction::F13},
+    {"f14", MCFunction::F14},
+    {"f15", MCFunction::F15},
+    {"f16", MCFunction::F16},
+    {"f17", MCFunction::F17},
+    {"f18", MCFunction::F18},
+    {"f19", MCFunction::F19},
+    {"f20", MCFunction::F20},
+    {"f21", MCFunction::F21},
+    {"f22", MCFunction::F22},
+    {"f23", MCFunction::F23},
+    {"f24", MCFunction::F24},
+    {"f25", MCFunction::F25},
+    {"f26", MCFunction::F26},
+    {"f27", MCFunction::F27},
+    {"f28", MCFunction::F28},
+    {"f29", MCFunction::F29},
+    {"f30", MCFunction::F30},
+    {"f31", MCFunction::F31},
+    {"f32", MCFunction::F32},
+};
+
+// Returns the MCFunction with the given config name (Status if unknown).
+inline MCFunction parseFunction(const std::string &name)
+{
+    return lookupEnumName(functionNames, name, MCFunction::Status);
+}
\ No newline at end of file
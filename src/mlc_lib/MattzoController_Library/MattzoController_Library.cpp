@@ -275,44 +275,147 @@ MCConnectionStatus getConnectionStatus()
 // Syslog functions
 // ****************
 
-// A UDP instance for sending and receiving packets over UDP
+// A UDP instance for sending syslog packets
 WiFiUDP udpClient;
-// Create a new empty syslog instance
-Syslog syslog(udpClient, SYSLOG_PROTO_IETF);
+
+// Log lines waiting to be sent to syslog (ring buffer)
+// Every line is stored as its severity (1 byte), its length (1 byte) and its characters.
+// Lines are sent by flushSyslog() in the main loop, so logging never waits for the network.
+char syslogQueue[SYSLOG_QUEUE_SIZE];
+unsigned int syslogQueueStart = 0;
+unsigned int syslogQueueUsed = 0;
+
+// Number of log lines dropped since startup, because the syslog queue was full
+unsigned long syslogDroppedCount = 0;
+unsigned long syslogReportedDroppedCount = 0;
 
 // Setup syslog
 void setupSysLog()
 {
     if (SYSLOG_ENABLED) {
-        syslog.server(SYSLOG_SERVER, SYSLOG_PORT);
-        syslog.deviceHostname(MC_HOSTNAME);
-        syslog.appName(SYSLOG_APP_NAME);
-        syslog.defaultPriority(LOG_KERN);
-        syslog.logMask(LOG_UPTO(LOG_DEBUG));
-        syslog.log(LOG_INFO, "Syslog setup done.");
+        mcLog2("Syslog setup done.", LOG_INFO);
     }
 }
 
-// log a message with a specific severity
-void mcLog2(String msg, int severity)
+// Append a log line to the syslog queue
+void queueSyslogLine(int severity, const char *line, unsigned int length)
+{
+    if (syslogQueueUsed + 2 + length > SYSLOG_QUEUE_SIZE) {
+        syslogDroppedCount++;
+        return;
+    }
+
+    unsigned int end = syslogQueueStart + syslogQueueUsed;
+    syslogQueue[end % SYSLOG_QUEUE_SIZE] = severity;
+    syslogQueue[(end + 1) % SYSLOG_QUEUE_SIZE] = length;
+    for (unsigned int i = 0; i < length; i++) {
+        syslogQueue[(end + 2 + i) % SYSLOG_QUEUE_SIZE] = line[i];
+    }
+    syslogQueueUsed += 2 + length;
+}
+
+// Send a log line as a syslog packet (RFC 5424 format, as sent by the Syslog library)
+// Returns false if the packet could not be sent, e.g. because the network stack ran out of buffers.
+bool sendSyslogLine(int severity, const char *line, unsigned int length)
+{
+    char header[100];
+    int headerLength = snprintf(header, sizeof(header), "<%d>1 - %s %s - - - \xEF\xBB\xBF", LOG_KERN | severity, MC_HOSTNAME, SYSLOG_APP_NAME);
+
+    if (!udpClient.beginPacket(SYSLOG_SERVER, SYSLOG_PORT)) {
+        return false;
+    }
+    udpClient.write((const uint8_t *)header, min(headerLength, (int)sizeof(header) - 1));
+    udpClient.write((const uint8_t *)line, length);
+    return udpClient.endPacket();
+}
+
+// Send queued log lines to syslog until the queue is empty or the time budget of this loop pass is used up
+void flushSyslog()
+{
+    if (!SYSLOG_ENABLED || WiFi.status() != WL_CONNECTED) {
+        return;
+    }
+
+    unsigned long startedAt_us = micros();
+    while (syslogQueueUsed > 0 && micros() - startedAt_us < SYSLOG_FLUSH_BUDGET_US) {
+        int severity = syslogQueue[syslogQueueStart];
+        unsigned int length = (uint8_t)syslogQueue[(syslogQueueStart + 1) % SYSLOG_QUEUE_SIZE];
+
+        char line[LOG_LINE_MAX_LENGTH];
+        for (unsigned int i = 0; i < length; i++) {
+            line[i] = syslogQueue[(syslogQueueStart + 2 + i) % SYSLOG_QUEUE_SIZE];
+        }
+
+        if (!sendSyslogLine(severity, line, length)) {
+            // Keep the line and try again in the next loop pass.
+            break;
+        }
+
+        syslogQueueStart = (syslogQueueStart + 2 + length) % SYSLOG_QUEUE_SIZE;
+        syslogQueueUsed -= 2 + length;
+    }
+
+    if (syslogDroppedCount != syslogReportedDroppedCount && syslogQueueUsed == 0) {
+        mcLogf(LOG_WARNING, "Syslog queue full, %lu log lines dropped.", syslogDroppedCount - syslogReportedDroppedCount);
+        syslogReportedDroppedCount = syslogDroppedCount;
+    }
+}
+
+// Write a log line to serial and queue it for syslog
+void writeLogLine(const char *line, unsigned int length, int severity)
 {
+    length = min(length, (unsigned int)LOG_LINE_MAX_LENGTH);
+
     if (severity <= LOGLEVEL_SERIAL) {
 #if defined(ESP32)
         Serial.print("[");
         Serial.print(xPortGetCoreID());
         Serial.print("] ");
 #endif
-        Serial.println(msg);
+        Serial.write((const uint8_t *)line, length);
+        Serial.println();
     }
     if (SYSLOG_ENABLED && severity <= LOGLEVEL_SYSLOG) {
-        syslog.log(severity, msg);
-        delay(1);
-        // delay a microsecond as udp packets get dropped on an esp8266 if they happen too close together
+        queueSyslogLine(severity, line, length);
+    }
+}
+
+// Check if messages with the given severity are logged at all
+// Callers may use this to skip building expensive log messages.
+bool mcLogEnabled(int severity)
+{
+    return severity <= LOGLEVEL_SERIAL || (SYSLOG_ENABLED && severity <= LOGLEVEL_SYSLOG);
+}
+
+// log a message with a specific severity
+void mcLog2(const String &msg, int severity)
+{
+    if (mcLogEnabled(severity)) {
+        writeLogLine(msg.c_str(), msg.length(), severity);
+    }
+}
+
+// log a printf-style message with a specific severity
+// The message is only formatted if the severity is logged, and it is formatted on the stack without allocating Strings.
+void mcLogf(int severity, const char *format, ...)
+{
+    if (!mcLogEnabled(severity)) {
+        return;
+    }
+
+    char line[LOG_LINE_MAX_LENGTH + 1];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    if (length >= 0) {
+        writeLogLine(line, min(length, LOG_LINE_MAX_LENGTH), severity);
     }
 }
 
 // log a message with default severity
-void mcLog(String msg)
+void mcLog(const String &msg)
 {
     mcLog2(msg, LOG_INFO);
 }
@@ -352,4 +455,5 @@ void loopMattzoController()
         ArduinoOTA.handle();
     }
     updateStatusLED();
+    flushSyslog();
 }
@@ -24,8 +24,10 @@ using namespace tinyxml2;
 // Forward declarations
 // ********************
 
-void mcLog(String msg);
-void mcLog2(String msg, int severity);
+void mcLog(const String &msg);
+void mcLog2(const String &msg, int severity);
+void mcLogf(int severity, const char *format, ...) __attribute__((format(printf, 2, 3)));
+bool mcLogEnabled(int severity);
 void reconnectWiFi();
 void checkWifi();
 
@@ -48,4 +50,13 @@ extern PubSubClient mqttClient;
 #define MIN_CONTROLLER_ID 10000
 #define MAX_CONTROLLER_ID 65000
 
+// Max. length of a log line. Longer lines are truncated.
+#define LOG_LINE_MAX_LENGTH 255
+
+// Size of the queue of log lines waiting to be sent to syslog (in bytes). Lines that don't fit are dropped and counted.
+#define SYSLOG_QUEUE_SIZE 2048
+
+// Max. time spent on sending queued log lines to syslog per loop pass (in microseconds).
+#define SYSLOG_FLUSH_BUDGET_US 1000
+
 #endif